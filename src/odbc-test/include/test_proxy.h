@@ -0,0 +1,72 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _DOCUMENTDB_ODBC_TEST_TEST_PROXY
+#define _DOCUMENTDB_ODBC_TEST_TEST_PROXY
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+
+namespace documentdb_test {
+/**
+ * TCP proxy on a local port that forwards every accepted connection to a
+ * server, so that tests can drop the links of a connection to the server.
+ *
+ * Asio is only included by the implementation, as it must be included
+ * before windows.h, which the tests include first.
+ */
+class TestProxy {
+ public:
+  /**
+   * Constructor. Starts forwarding.
+   *
+   * @param host Host of the server.
+   * @param port Port of the server.
+   */
+  TestProxy(const std::string& host, const std::string& port);
+
+  /**
+   * Destructor. Stops forwarding and drops the links.
+   */
+  ~TestProxy();
+
+  /**
+   * Get the local port of the proxy.
+   *
+   * @return Port.
+   */
+  uint16_t GetPort() const;
+
+  /**
+   * Drop the links forwarded so far, as a network failure would. New
+   * connections are still forwarded.
+   *
+   * @return Number of dropped links.
+   */
+  size_t DropLinks();
+
+ private:
+  class Impl;
+
+  /** Implementation. */
+  std::unique_ptr< Impl > impl;
+};
+}  // namespace documentdb_test
+
+#endif  //_DOCUMENTDB_ODBC_TEST_TEST_PROXY
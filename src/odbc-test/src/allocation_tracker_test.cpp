@@ -0,0 +1,98 @@
+/*
+ * Copyright <2022> Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ */
+
+
+#include <documentdb/odbc/allocation_tracker.h>
+#include <documentdb/odbc/statement_trace.h>
+
+#include <boost/test/unit_test.hpp>
+#include <string>
+#include <vector>
+
+using documentdb::odbc::AllocationTracker;
+using documentdb::odbc::StatementTrace;
+
+BOOST_AUTO_TEST_SUITE(AllocationTrackerTestSuite)
+
+BOOST_AUTO_TEST_CASE(TestAllocationTrackerComponents) {
+  StatementTrace trace;
+  trace.Start();
+
+  // Without a current trace nothing is counted.
+  AllocationTracker::Allocated(1000);
+  BOOST_CHECK_EQUAL(trace.allocations.GetAllocations(), 0);
+
+  {
+    StatementTrace::Scope traceScope(trace);
+    AllocationTracker::ComponentScope rowScope(
+        AllocationTracker::Component::ROW);
+    AllocationTracker::Allocated(100);
+    {
+      AllocationTracker::ComponentScope diagnosticsScope(
+          AllocationTracker::Component::DIAGNOSTICS);
+      AllocationTracker::Allocated(50);
+      AllocationTracker::Released(50);
+    }
+    AllocationTracker::Allocated(10);
+    AllocationTracker::Released(110);
+  }
+
+  const AllocationTracker::Stats& stats = trace.allocations;
+  BOOST_CHECK_EQUAL(stats.allocations[AllocationTracker::Component::ROW], 2);
+  BOOST_CHECK_EQUAL(stats.bytes[AllocationTracker::Component::ROW], 110);
+  BOOST_CHECK_EQUAL(
+      stats.allocations[AllocationTracker::Component::DIAGNOSTICS], 1);
+  BOOST_CHECK_EQUAL(stats.GetAllocations(), 3);
+  BOOST_CHECK_EQUAL(stats.GetBytes(), 160);
+  BOOST_CHECK_EQUAL(stats.peakBytes, 150);
+  BOOST_CHECK_EQUAL(stats.liveBytes, 0);
+
+  std::string json = stats.ToJson();
+  BOOST_CHECK(json.find("{\"count\":3,\"bytes\":160,\"peak_bytes\":150,")
+              == 0);
+  BOOST_CHECK(json.find("\"row\":{\"count\":2,\"bytes\":110}")
+              != std::string::npos);
+
+  // The trace reports the allocations only when they are counted.
+  BOOST_CHECK_EQUAL(trace.ToJson().find("\"allocations\":")
+                        != std::string::npos,
+                    AllocationTracker::IsEnabled());
+
+  trace.Start();
+  BOOST_CHECK_EQUAL(trace.allocations.GetAllocations(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(TestAllocationTrackerOperatorNew) {
+  if (!AllocationTracker::IsEnabled())
+    return;
+
+  StatementTrace trace;
+  trace.Start();
+  {
+    StatementTrace::Scope traceScope(trace);
+    DOCUMENTDB_ALLOCATION_SCOPE(CONVERSION);
+    std::vector< char > buffer(4096);
+    BOOST_CHECK_GE(trace.allocations.liveBytes, 4096);
+  }
+
+  const AllocationTracker::Stats& stats = trace.allocations;
+  BOOST_CHECK_GE(
+      stats.allocations[AllocationTracker::Component::CONVERSION], 1);
+  BOOST_CHECK_GE(stats.bytes[AllocationTracker::Component::CONVERSION], 4096);
+  BOOST_CHECK_GE(stats.peakBytes, 4096);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -19,6 +19,7 @@
 #include <documentdb/odbc/config/config_tools.h>
 #include <documentdb/odbc/config/configuration.h>
 #include <documentdb/odbc/config/connection_string_parser.h>
+#include <documentdb/odbc/connection_pool.h>
 #include <documentdb/odbc/log.h>
 #include <documentdb/odbc/log_level.h>
 #include <documentdb/odbc/odbc_error.h>
@@ -674,6 +675,8 @@ BOOST_AUTO_TEST_CASE(TestConnectStringInvalidBoolKeys) {
   keys.emplace("tls_allow_invalid_hostnames");
   keys.emplace("ssh_strict_host_key_checking");
   keys.emplace("refresh_schema");
+  keys.emplace("approximate_count");
+  keys.emplace("allow_disk_use");
 
   for (auto it = keys.begin(); it != keys.end(); ++it) {
     const std::string& key = *it;
@@ -699,6 +702,8 @@ BOOST_AUTO_TEST_CASE(TestConnectStringValidBoolKeys) {
   keys.emplace("tls_allow_invalid_hostnames");
   keys.emplace("ssh_strict_host_key_checking");
   keys.emplace("refresh_schema");
+  keys.emplace("approximate_count");
+  keys.emplace("allow_disk_use");
 
   for (auto it = keys.begin(); it != keys.end(); ++it) {
     const std::string& key = *it;
@@ -713,6 +718,356 @@ BOOST_AUTO_TEST_CASE(TestConnectStringValidBoolKeys) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(TestConnectStringParallelScanPartitions) {
+  Configuration cfg;
+
+  BOOST_CHECK_EQUAL(cfg.GetParallelScanPartitions(),
+                    Configuration::DefaultValue::parallelScanPartitions);
+
+  ParseValidConnectString("parallel_scan_partitions=8;", cfg);
+  BOOST_CHECK_EQUAL(cfg.GetParallelScanPartitions(), 8);
+
+  Configuration::ArgumentMap map;
+  cfg.ToMap(map);
+  BOOST_CHECK_EQUAL(map["parallel_scan_partitions"], "8");
+
+  const char* invalidValues[] = {"-1", "abc", "65", "99999999999"};
+  for (const char* value : invalidValues) {
+    Configuration invalidCfg;
+
+    ParseConnectStringWithError(
+        std::string("parallel_scan_partitions=") + value + ";", invalidCfg);
+
+    BOOST_CHECK_EQUAL(invalidCfg.GetParallelScanPartitions(),
+                      Configuration::DefaultValue::parallelScanPartitions);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestConnectStringAggregateOptions) {
+  Configuration cfg;
+
+  BOOST_CHECK(!cfg.IsReadConcernSet());
+  BOOST_CHECK_EQUAL(cfg.GetComment(), Configuration::DefaultValue::comment);
+
+  ParseValidConnectString("read_concern=Majority;comment=nightly report;",
+                          cfg);
+  BOOST_CHECK(cfg.GetReadConcern() == ReadConcern::Type::MAJORITY);
+  BOOST_CHECK_EQUAL(cfg.GetComment(), "nightly report");
+
+  Configuration::ArgumentMap map;
+  cfg.ToMap(map);
+  BOOST_CHECK_EQUAL(map["read_concern"], "majority");
+  BOOST_CHECK_EQUAL(map["comment"], "nightly report");
+
+  Configuration invalidCfg;
+  ParseConnectStringWithError("read_concern=eventual;", invalidCfg);
+  BOOST_CHECK(!invalidCfg.IsReadConcernSet());
+}
+
+BOOST_AUTO_TEST_CASE(TestConnectStringConnectionPool) {
+  Configuration cfg;
+
+  BOOST_CHECK_EQUAL(cfg.GetConnectionPoolSize(),
+                    Configuration::DefaultValue::connectionPoolSize);
+  BOOST_CHECK_EQUAL(cfg.GetConnectionPoolIdleTimeout(),
+                    Configuration::DefaultValue::connectionPoolIdleTimeout);
+
+  ParseValidConnectString(
+      "connection_pool_size=4;connection_pool_idle_timeout=30;", cfg);
+  BOOST_CHECK_EQUAL(cfg.GetConnectionPoolSize(), 4);
+  BOOST_CHECK_EQUAL(cfg.GetConnectionPoolIdleTimeout(), 30);
+
+  Configuration::ArgumentMap map;
+  cfg.ToMap(map);
+  BOOST_CHECK_EQUAL(map["connection_pool_size"], "4");
+  BOOST_CHECK_EQUAL(map["connection_pool_idle_timeout"], "30");
+
+  const char* invalidValues[] = {"-1", "abc", "257"};
+  for (const char* value : invalidValues) {
+    Configuration invalidCfg;
+
+    ParseConnectStringWithError(
+        std::string("connection_pool_size=") + value + ";", invalidCfg);
+
+    BOOST_CHECK_EQUAL(invalidCfg.GetConnectionPoolSize(),
+                      Configuration::DefaultValue::connectionPoolSize);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestConnectStringClientPoolSize) {
+  Configuration cfg;
+
+  BOOST_CHECK_EQUAL(cfg.GetClientPoolSize(),
+                    Configuration::DefaultValue::clientPoolSize);
+  BOOST_CHECK(cfg.ToMongoDbConnectionString(0).find("maxPoolSize")
+              == std::string::npos);
+
+  ParseValidConnectString("client_pool_size=8;", cfg);
+  BOOST_CHECK_EQUAL(cfg.GetClientPoolSize(), 8);
+  BOOST_CHECK(cfg.ToMongoDbConnectionString(0).find("maxPoolSize=8")
+              != std::string::npos);
+  BOOST_CHECK(cfg.ToJdbcConnectionString().find("maxPoolSize")
+              == std::string::npos);
+
+  const char* invalidValues[] = {"0", "abc", "1001"};
+  for (const char* value : invalidValues) {
+    Configuration invalidCfg;
+
+    ParseConnectStringWithError(
+        std::string("client_pool_size=") + value + ";", invalidCfg);
+
+    BOOST_CHECK_EQUAL(invalidCfg.GetClientPoolSize(),
+                      Configuration::DefaultValue::clientPoolSize);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestConnectStringReconnect) {
+  Configuration cfg;
+
+  BOOST_CHECK_EQUAL(cfg.GetReconnectAttempts(),
+                    Configuration::DefaultValue::reconnectAttempts);
+  BOOST_CHECK_EQUAL(cfg.GetReconnectBackoffMs(),
+                    Configuration::DefaultValue::reconnectBackoffMs);
+
+  ParseValidConnectString("reconnect_attempts=0;reconnect_backoff_ms=250;",
+                          cfg);
+  BOOST_CHECK_EQUAL(cfg.GetReconnectAttempts(), 0);
+  BOOST_CHECK_EQUAL(cfg.GetReconnectBackoffMs(), 250);
+
+  const char* invalidValues[] = {"-1", "abc", "60001"};
+  for (const char* value : invalidValues) {
+    Configuration invalidCfg;
+
+    ParseConnectStringWithError(
+        std::string("reconnect_attempts=") + value + ";", invalidCfg);
+    ParseConnectStringWithError(
+        std::string("reconnect_backoff_ms=") + value + ";", invalidCfg);
+
+    BOOST_CHECK_EQUAL(invalidCfg.GetReconnectAttempts(),
+                      Configuration::DefaultValue::reconnectAttempts);
+    BOOST_CHECK_EQUAL(invalidCfg.GetReconnectBackoffMs(),
+                      Configuration::DefaultValue::reconnectBackoffMs);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestConnectStringCompression) {
+  Configuration cfg;
+
+  BOOST_CHECK_EQUAL(cfg.GetCompressors(),
+                    Configuration::DefaultValue::compressors);
+  BOOST_CHECK_EQUAL(cfg.GetZlibCompressionLevel(),
+                    Configuration::DefaultValue::zlibCompressionLevel);
+
+  ParseValidConnectString(
+      "hostname=localhost;database=odbc-test;"
+      "compressors= Zstd, snappy ,zlib;zlib_compression_level=6;",
+      cfg);
+  BOOST_CHECK_EQUAL(cfg.GetCompressors(), "zstd,snappy,zlib");
+  BOOST_CHECK_EQUAL(cfg.GetZlibCompressionLevel(), 6);
+
+  std::string uri = cfg.ToMongoDbConnectionString(0);
+  BOOST_CHECK(uri.find("compressors=zstd%2Csnappy%2Czlib")
+              != std::string::npos);
+  BOOST_CHECK(uri.find("zlibCompressionLevel=6") != std::string::npos);
+
+  std::string jdbcStr = cfg.ToJdbcConnectionString();
+  BOOST_CHECK(jdbcStr.find("compressors") == std::string::npos);
+  BOOST_CHECK(jdbcStr.find("zlibCompressionLevel") == std::string::npos);
+
+  Configuration invalidCfg;
+  ParseConnectStringWithError("compressors=zstd,lz4;", invalidCfg);
+  ParseConnectStringWithError("zlib_compression_level=10;", invalidCfg);
+  BOOST_CHECK_EQUAL(invalidCfg.GetCompressors(),
+                    Configuration::DefaultValue::compressors);
+  BOOST_CHECK_EQUAL(invalidCfg.GetZlibCompressionLevel(),
+                    Configuration::DefaultValue::zlibCompressionLevel);
+
+  std::string defaultUri = invalidCfg.ToMongoDbConnectionString(0);
+  BOOST_CHECK(defaultUri.find("compressors") == std::string::npos);
+  BOOST_CHECK(defaultUri.find("zlibCompressionLevel") == std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(TestConnectStringReadRouting) {
+  Configuration cfg;
+
+  BOOST_CHECK_EQUAL(cfg.IsAnalyticsRouting(),
+                    Configuration::DefaultValue::analyticsRouting);
+  BOOST_CHECK_EQUAL(cfg.GetLocalThresholdMs(),
+                    Configuration::DefaultValue::localThresholdMs);
+  BOOST_CHECK(cfg.ToMongoDbConnectionString(0).find(MONGO_URI_LOCALTHRESHOLDMS)
+              == std::string::npos);
+
+  ParseValidConnectString(
+      "hostname=localhost;database=odbc-test;"
+      "analytics_routing=true;local_threshold_ms=40;",
+      cfg);
+  BOOST_CHECK(cfg.IsAnalyticsRouting());
+  BOOST_CHECK_EQUAL(cfg.GetLocalThresholdMs(), 40);
+  BOOST_CHECK(cfg.ToMongoDbConnectionString(0).find("localThresholdMS=40")
+              != std::string::npos);
+  BOOST_CHECK(cfg.ToJdbcConnectionString().find(MONGO_URI_LOCALTHRESHOLDMS)
+              == std::string::npos);
+
+  Configuration invalidCfg;
+  ParseConnectStringWithError("analytics_routing=maybe;", invalidCfg);
+  ParseConnectStringWithError("local_threshold_ms=60001;", invalidCfg);
+  BOOST_CHECK_EQUAL(invalidCfg.IsAnalyticsRouting(),
+                    Configuration::DefaultValue::analyticsRouting);
+  BOOST_CHECK_EQUAL(invalidCfg.GetLocalThresholdMs(),
+                    Configuration::DefaultValue::localThresholdMs);
+}
+
+BOOST_AUTO_TEST_CASE(TestConnectStringPoolPrewarm) {
+  Configuration cfg;
+
+  BOOST_CHECK_EQUAL(cfg.GetPoolPrewarmSize(),
+                    Configuration::DefaultValue::poolPrewarmSize);
+  BOOST_CHECK_EQUAL(cfg.GetWarmUpSqlFile(),
+                    Configuration::DefaultValue::warmUpSqlFile);
+
+  ParseValidConnectString(
+      "pool_prewarm_size=4;warm_up_sql_file=/etc/odbc/warm_up.sql;", cfg);
+  BOOST_CHECK_EQUAL(cfg.GetPoolPrewarmSize(), 4);
+  BOOST_CHECK_EQUAL(cfg.GetWarmUpSqlFile(), "/etc/odbc/warm_up.sql");
+
+  Configuration invalidCfg;
+  ParseConnectStringWithError("pool_prewarm_size=257;", invalidCfg);
+  BOOST_CHECK_EQUAL(invalidCfg.GetPoolPrewarmSize(),
+                    Configuration::DefaultValue::poolPrewarmSize);
+}
+
+BOOST_AUTO_TEST_CASE(TestConnectStringAsyncLogging) {
+  Configuration cfg;
+
+  BOOST_CHECK_EQUAL(cfg.IsLogAsync(), Configuration::DefaultValue::logAsync);
+  BOOST_CHECK_EQUAL(cfg.GetLogOverflow(),
+                    Configuration::DefaultValue::logOverflow);
+
+  ParseValidConnectString("log_async=false;log_overflow=DROP;", cfg);
+  BOOST_CHECK(!cfg.IsLogAsync());
+  BOOST_CHECK_EQUAL(cfg.GetLogOverflow(), "drop");
+
+  Configuration invalidCfg;
+  ParseConnectStringWithError("log_async=maybe;log_overflow=wait;",
+                              invalidCfg);
+  BOOST_CHECK(!invalidCfg.IsLogAsyncSet());
+  BOOST_CHECK(!invalidCfg.IsLogOverflowSet());
+
+  // Restore the process-wide default.
+  cfg.SetLogOverflow(Configuration::DefaultValue::logOverflow);
+}
+
+BOOST_AUTO_TEST_CASE(TestConnectStringLogFormat) {
+  Configuration cfg;
+
+  BOOST_CHECK_EQUAL(cfg.GetLogFormat(), Configuration::DefaultValue::logFormat);
+
+  ParseValidConnectString("log_format=JSON;", cfg);
+  BOOST_CHECK_EQUAL(cfg.GetLogFormat(), "json");
+  BOOST_CHECK(Logger::IsJsonFormat());
+
+  Configuration invalidCfg;
+  ParseConnectStringWithError("log_format=xml;", invalidCfg);
+  BOOST_CHECK(!invalidCfg.IsLogFormatSet());
+
+  // Restore the process-wide default.
+  cfg.SetLogFormat(Configuration::DefaultValue::logFormat);
+  BOOST_CHECK(!Logger::IsJsonFormat());
+}
+
+BOOST_AUTO_TEST_CASE(TestConnectStringMetrics) {
+  Configuration cfg;
+
+  BOOST_CHECK_EQUAL(cfg.GetMetricsPath(),
+                    Configuration::DefaultValue::metricsPath);
+  BOOST_CHECK_EQUAL(cfg.GetMetricsPort(),
+                    Configuration::DefaultValue::metricsPort);
+  BOOST_CHECK_EQUAL(cfg.GetMetricsInterval(),
+                    Configuration::DefaultValue::metricsInterval);
+
+  ParseValidConnectString(
+      "metrics_path=/var/run/odbc.prom;metrics_port=9464;metrics_interval=30;",
+      cfg);
+  BOOST_CHECK_EQUAL(cfg.GetMetricsPath(), "/var/run/odbc.prom");
+  BOOST_CHECK_EQUAL(cfg.GetMetricsPort(), 9464);
+  BOOST_CHECK_EQUAL(cfg.GetMetricsInterval(), 30);
+
+  Configuration invalidCfg;
+  ParseConnectStringWithError("metrics_port=70000;metrics_interval=0;",
+                              invalidCfg);
+  BOOST_CHECK(!invalidCfg.IsMetricsPortSet());
+  BOOST_CHECK(!invalidCfg.IsMetricsIntervalSet());
+}
+
+BOOST_AUTO_TEST_CASE(TestConnectStringDiagRecordLimit) {
+  Configuration cfg;
+
+  BOOST_CHECK_EQUAL(cfg.GetDiagRecordLimit(),
+                    Configuration::DefaultValue::diagRecordLimit);
+
+  ParseValidConnectString("diag_record_limit=50;", cfg);
+  BOOST_CHECK_EQUAL(cfg.GetDiagRecordLimit(), 50);
+
+  Configuration invalidCfg;
+  ParseConnectStringWithError("diag_record_limit=0;", invalidCfg);
+  BOOST_CHECK(!invalidCfg.IsDiagRecordLimitSet());
+}
+
+BOOST_AUTO_TEST_CASE(TestConnectStringSlowQueryThreshold) {
+  Configuration cfg;
+
+  BOOST_CHECK_EQUAL(cfg.GetSlowQueryThresholdMs(),
+                    Configuration::DefaultValue::slowQueryThresholdMs);
+
+  ParseValidConnectString("slow_query_threshold_ms=500;", cfg);
+  BOOST_CHECK_EQUAL(cfg.GetSlowQueryThresholdMs(), 500);
+
+  Configuration invalidCfg;
+  ParseConnectStringWithError("slow_query_threshold_ms=-1;", invalidCfg);
+  BOOST_CHECK(!invalidCfg.IsSlowQueryThresholdMsSet());
+}
+
+BOOST_AUTO_TEST_CASE(TestConnectionPoolKey) {
+  Configuration cfg;
+  ParseValidConnectString(
+      "dsn=first;hostname=localhost;database=odbc-test;user=user;"
+      "password=secret;connection_pool_size=4;",
+      cfg);
+
+  std::string key = ConnectionPool::MakeKey(cfg);
+  BOOST_CHECK(key.find("secret") == std::string::npos);
+  BOOST_CHECK(key.find("first") == std::string::npos);
+
+  Configuration sameCfg;
+  ParseValidConnectString(
+      "DSN=second;HOSTNAME=localhost;DATABASE=odbc-test;USER=user;"
+      "PASSWORD=secret;CONNECTION_POOL_SIZE=4;",
+      sameCfg);
+  BOOST_CHECK_EQUAL(key, ConnectionPool::MakeKey(sameCfg));
+
+  // The login timeout only applies while the connection is opened.
+  Configuration otherLoginTimeoutCfg;
+  ParseValidConnectString(
+      "hostname=localhost;database=odbc-test;user=user;password=secret;"
+      "connection_pool_size=4;login_timeout_sec=10;",
+      otherLoginTimeoutCfg);
+  BOOST_CHECK_EQUAL(key, ConnectionPool::MakeKey(otherLoginTimeoutCfg));
+
+  Configuration otherPasswordCfg;
+  ParseValidConnectString(
+      "hostname=localhost;database=odbc-test;user=user;password=other;"
+      "connection_pool_size=4;",
+      otherPasswordCfg);
+  BOOST_CHECK_NE(key, ConnectionPool::MakeKey(otherPasswordCfg));
+
+  Configuration otherDatabaseCfg;
+  ParseValidConnectString(
+      "hostname=localhost;database=other;user=user;password=secret;"
+      "connection_pool_size=4;",
+      otherDatabaseCfg);
+  BOOST_CHECK_NE(key, ConnectionPool::MakeKey(otherDatabaseCfg));
+}
+
 BOOST_AUTO_TEST_CASE(TestDsnStringUppercase) {
   Configuration cfg;
 
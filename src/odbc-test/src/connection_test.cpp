@@ -26,16 +26,41 @@
 #include <boost/test/unit_test.hpp>
 #include <boost/test/data/test_case.hpp>
 #include <boost/test/data/monomorphic.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
 #include <string>
-
+#include <thread>
+#include <vector>
+
+#include "documentdb/odbc/common/platform_utils.h"
+#include "documentdb/odbc/connection.h"
+#include "documentdb/odbc/connection_pool.h"
+#include "documentdb/odbc/environment.h"
+#include "documentdb/odbc/metrics.h"
+#include "documentdb/odbc/server_capabilities.h"
+#include "documentdb/odbc/system/odbc_constants.h"
 #include "odbc_test_suite.h"
+#include "test_proxy.h"
 #include "test_utils.h"
 
 using namespace boost::unit_test;
 using boost::unit_test::precondition;
 using documentdb::odbc::if_integration;
+using documentdb::odbc::Connection;
+using documentdb::odbc::ConnectionPool;
+using documentdb::odbc::DocumentDbError;
+using documentdb::odbc::Environment;
+using documentdb::odbc::Metrics;
 using documentdb::odbc::OdbcTestSuite;
+using documentdb::odbc::ServerCapabilities;
+using documentdb::odbc::ServerCapabilitiesCache;
+using documentdb::odbc::common::GetEnv;
+using documentdb::odbc::config::Configuration;
 using documentdb_test::GetOdbcErrorMessage;
+using documentdb_test::ODBC_BUFFER_SIZE;
+using documentdb_test::TestProxy;
 
 /**
  * Test setup fixture.
@@ -93,6 +118,38 @@ BOOST_AUTO_TEST_CASE(TestConnectionRestoreInternalSSHTunnel,
   Disconnect();
 }
 
+BOOST_AUTO_TEST_CASE(TestConnectionSharedInternalSSHTunnel,
+                     *precondition(if_integration())) {
+  std::string connectionString;
+  CreateDsnConnectionStringForRemoteServer(connectionString);
+
+  // Both connections are open at the same time and share one tunnel.
+  SQLHDBC conns[2] = {SQL_NULL_HDBC, SQL_NULL_HDBC};
+  SQLHSTMT statements[2] = {SQL_NULL_HSTMT, SQL_NULL_HSTMT};
+  for (int i = 0; i < 2; i++) {
+    Connect(conns[i], statements[i], connectionString);
+  }
+
+  // The server version is read through the tunnel.
+  for (int i = 0; i < 2; i++) {
+    SQLWCHAR dbmsVer[ODBC_BUFFER_SIZE]{};
+    SQLSMALLINT dbmsVerLen = 0;
+    SQLRETURN ret = SQLGetInfo(conns[i], SQL_DBMS_VER, dbmsVer,
+                               sizeof(dbmsVer), &dbmsVerLen);
+    BOOST_CHECK(SQL_SUCCEEDED(ret));
+    BOOST_CHECK_GT(dbmsVerLen, 0);
+  }
+
+  // The tunnel stays open for the second connection when the first one
+  // disconnects.
+  for (int i = 0; i < 2; i++) {
+    SQLFreeHandle(SQL_HANDLE_STMT, statements[i]);
+    SQLRETURN ret = SQLDisconnect(conns[i]);
+    BOOST_CHECK(SQL_SUCCEEDED(ret));
+    SQLFreeHandle(SQL_HANDLE_DBC, conns[i]);
+  }
+}
+
 BOOST_AUTO_TEST_CASE(TestConnectionRestoreExternalSSHTunnel,
                      *precondition(if_integration())) {
   std::string connectionString;
@@ -123,6 +180,199 @@ BOOST_DATA_TEST_CASE_F(ConnectionTestSuiteFixture,
   }
 }
 
+BOOST_AUTO_TEST_CASE(TestConnectionPooling) {
+  std::string connectionString;
+  CreateDsnConnectionStringForLocalServer(connectionString, "", "",
+                                          "CONNECTION_POOL_SIZE=1;");
+
+  Metrics& metrics = Metrics::GetInstance();
+
+  Connect(connectionString);
+  Disconnect();
+
+  // The next connections of the environment reuse the pooled connection.
+  for (int i = 0; i < 2; i++) {
+    uint64_t hits = metrics.GetCounter(Metrics::Counter::POOL_HITS);
+    uint64_t misses = metrics.GetCounter(Metrics::Counter::POOL_MISSES);
+
+    SQLHDBC conn = SQL_NULL_HDBC;
+    SQLHSTMT statement = SQL_NULL_HSTMT;
+    Connect(conn, statement, connectionString);
+
+    BOOST_CHECK_EQUAL(hits + 1,
+                      metrics.GetCounter(Metrics::Counter::POOL_HITS));
+    BOOST_CHECK_EQUAL(misses,
+                      metrics.GetCounter(Metrics::Counter::POOL_MISSES));
+
+    SQLWCHAR dbmsVer[ODBC_BUFFER_SIZE]{};
+    SQLSMALLINT dbmsVerLen = 0;
+    SQLRETURN ret = SQLGetInfo(conn, SQL_DBMS_VER, dbmsVer, sizeof(dbmsVer),
+                               &dbmsVerLen);
+    BOOST_CHECK(SQL_SUCCEEDED(ret));
+    BOOST_CHECK_GT(dbmsVerLen, 0);
+
+    SQLFreeHandle(SQL_HANDLE_STMT, statement);
+    ret = SQLDisconnect(conn);
+    BOOST_CHECK(SQL_SUCCEEDED(ret));
+    SQLFreeHandle(SQL_HANDLE_DBC, conn);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestConnectionPoolPrewarm) {
+  const char* warmUpSqlFile = "connection_test_warm_up.sql";
+  {
+    std::ofstream file(warmUpSqlFile);
+    file << "-- Translated, not executed.\n"
+         << "SELECT * FROM queries_test_005\n"
+         << "\n"
+         << "SELECT COUNT(*) FROM queries_test_005\n";
+  }
+
+  std::string connectionString;
+  CreateDsnConnectionStringForLocalServer(
+      connectionString, "", "",
+      std::string("CONNECTION_POOL_SIZE=2;POOL_PREWARM_SIZE=3;"
+                  "WARM_UP_SQL_FILE=")
+          + warmUpSqlFile + ";");
+  Configuration config;
+  ParseConnectionString(connectionString, config);
+  std::string key = ConnectionPool::MakeKey(config);
+
+  Environment environment;
+  environment.Prewarm(config);
+  // Only the first call per configuration opens connections.
+  environment.Prewarm(config);
+  environment.WaitForPrewarm();
+
+  // The pre-warm size is limited by the pool size.
+  BOOST_CHECK_EQUAL(environment.GetConnectionPool().GetIdleCount(key), 2);
+
+  // Nothing is opened once the pre-warm is cancelled.
+  Environment cancelled;
+  cancelled.CancelPrewarm();
+  cancelled.Prewarm(config);
+  cancelled.WaitForPrewarm();
+  BOOST_CHECK_EQUAL(cancelled.GetConnectionPool().GetIdleCount(key), 0);
+
+  std::remove(warmUpSqlFile);
+}
+
+BOOST_AUTO_TEST_CASE(TestServerCapabilitiesCache) {
+  std::string connectionString;
+  CreateDsnConnectionStringForLocalServer(connectionString);
+  Configuration config;
+  ParseConnectionString(connectionString, config);
+
+  // Start without cached capabilities for the server.
+  ServerCapabilitiesCache& cache = ServerCapabilitiesCache::GetInstance();
+  cache.Invalidate(ServerCapabilitiesCache::MakeKey(config));
+  size_t hits = cache.GetHitCount();
+  size_t fetches = cache.GetFetchCount();
+
+  // The connections are made in this process, so that they use the cache
+  // above. The second one gets the server version from the cache.
+  Environment environment;
+  std::vector< SQLWCHAR > dbmsVers[2];
+  for (int i = 0; i < 2; i++) {
+    Connection* connection = environment.CreateConnection();
+    connection->Establish(config);
+    BOOST_REQUIRE(connection->GetDiagnosticRecords().IsSuccessful());
+
+    SQLWCHAR dbmsVer[ODBC_BUFFER_SIZE]{};
+    short dbmsVerLen = 0;
+    connection->GetInfo(SQL_DBMS_VER, dbmsVer, sizeof(dbmsVer), &dbmsVerLen);
+    BOOST_CHECK(connection->GetDiagnosticRecords().IsSuccessful());
+    BOOST_CHECK_GT(dbmsVerLen, 0);
+    dbmsVers[i].assign(dbmsVer, dbmsVer + dbmsVerLen / sizeof(SQLWCHAR));
+
+    connection->Release();
+    connection->Deregister();
+    delete connection;
+  }
+
+  BOOST_CHECK(dbmsVers[0] == dbmsVers[1]);
+  BOOST_CHECK_EQUAL(cache.GetFetchCount(), fetches + 1);
+  BOOST_CHECK_GT(cache.GetHitCount(), hits);
+}
+
+BOOST_AUTO_TEST_CASE(TestConnectionReconnectCounters) {
+  std::string connectionString;
+  CreateDsnConnectionStringForLocalServer(
+      connectionString, "", "",
+      "RECONNECT_ATTEMPTS=2;RECONNECT_BACKOFF_MS=10;");
+  Connect(connectionString);
+
+  // Nothing to restore on a healthy connection.
+  SQLINTEGER attrs[] = {SQL_ATTR_DOCUMENTDB_RECONNECT_ATTEMPTS,
+                        SQL_ATTR_DOCUMENTDB_RECONNECT_FAILURES,
+                        SQL_ATTR_DOCUMENTDB_RECONNECT_TIME_MS};
+  for (SQLINTEGER attr : attrs) {
+    SQLUINTEGER value = 1;
+    SQLRETURN ret = SQLGetConnectAttr(dbc, attr, &value, 0, nullptr);
+    ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_DBC, dbc);
+    BOOST_CHECK_EQUAL(value, 0);
+
+    ret = SQLSetConnectAttr(dbc, attr, reinterpret_cast< SQLPOINTER >(1), 0);
+    BOOST_CHECK_EQUAL(ret, SQL_ERROR);
+  }
+
+  Disconnect();
+}
+
+BOOST_AUTO_TEST_CASE(TestConnectionReconnectAfterDroppedLinks) {
+  // Both connections of the driver go to the server through the proxy.
+  TestProxy proxy(GetEnv("LOCAL_DATABASE_HOST", "localhost"), "27017");
+  std::string connectionString;
+  CreateDsnConnectionStringForLocalServer(
+      connectionString, "", "",
+      "RECONNECT_ATTEMPTS=2;RECONNECT_BACKOFF_MS=10;",
+      std::to_string(proxy.GetPort()));
+  Configuration config;
+  ParseConnectionString(connectionString, config);
+
+  Environment environment;
+  Connection* connection = environment.CreateConnection();
+  connection->Establish(config);
+  BOOST_REQUIRE(connection->GetDiagnosticRecords().IsSuccessful());
+
+  BOOST_REQUIRE_GT(proxy.DropLinks(), 0);
+
+  // Workers of partitioned scans create clients while the transport is
+  // restored.
+  std::atomic< bool > reconnecting(true);
+  std::thread worker([connection, &reconnecting]() {
+    while (reconnecting) {
+      connection->CreateMongoClient();
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  });
+
+  DocumentDbError err;
+  bool reconnected = connection->Reconnect(err);
+  reconnecting = false;
+  worker.join();
+  BOOST_CHECK_MESSAGE(reconnected, err.GetText());
+
+  SQLUINTEGER attempts = 0;
+  connection->GetAttribute(SQL_ATTR_DOCUMENTDB_RECONNECT_ATTEMPTS, &attempts,
+                           0, nullptr);
+  BOOST_CHECK_EQUAL(attempts, 1);
+  SQLUINTEGER failures = 1;
+  connection->GetAttribute(SQL_ATTR_DOCUMENTDB_RECONNECT_FAILURES, &failures,
+                           0, nullptr);
+  BOOST_CHECK_EQUAL(failures, 0);
+
+  // The restored transport reaches the server again.
+  ServerCapabilitiesCache::GetInstance().Invalidate(
+      ServerCapabilitiesCache::MakeKey(config));
+  ServerCapabilities caps;
+  BOOST_CHECK(connection->GetServerCapabilities(caps));
+
+  connection->Release();
+  connection->Deregister();
+  delete connection;
+}
+
 BOOST_DATA_TEST_CASE_F(ConnectionTestSuiteFixture,
                        TestConnectionRestoreMiscOptionsSet,
                        data::make({false, true}), useSqlConnect) {
@@ -0,0 +1,117 @@
+/*
+ * Copyright <2022> Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ */
+
+#include <documentdb/odbc/diagnostic/diagnosable_adapter.h>
+#include <documentdb/odbc/diagnostic/diagnostic_record_storage.h>
+
+#include <boost/test/unit_test.hpp>
+#include <string>
+
+using documentdb::odbc::SqlState;
+using documentdb::odbc::diagnostic::DiagnosableAdapter;
+using documentdb::odbc::diagnostic::DiagnosticRecord;
+using documentdb::odbc::diagnostic::DiagnosticRecordStorage;
+
+namespace {
+void AddTruncation(DiagnosticRecordStorage& diag, int32_t row,
+                   int32_t column) {
+  if (!diag.MergeStatusRecord(SqlState::S01004_DATA_TRUNCATED, row, column))
+    diag.AddStatusRecord(DiagnosticRecord(SqlState::S01004_DATA_TRUNCATED,
+                                          "Data truncated.", "", "", row,
+                                          column));
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(DiagnosticRecordStorageTestSuite)
+
+BOOST_AUTO_TEST_CASE(TestDiagnosticRecordsMergedByColumn) {
+  DiagnosticRecordStorage diag;
+
+  for (int32_t row = 1; row <= 1000; ++row) {
+    AddTruncation(diag, row, 1);
+    AddTruncation(diag, row, 3);
+  }
+
+  BOOST_REQUIRE_EQUAL(diag.GetStatusRecordsNumber(), 2);
+
+  const DiagnosticRecord& first = diag.GetStatusRecord(1);
+  BOOST_CHECK_EQUAL(first.GetSqlState(), "01004");
+  BOOST_CHECK_EQUAL(first.GetColumnNumber(), 1);
+  BOOST_CHECK_EQUAL(first.GetRowNumber(), 1);
+  BOOST_CHECK_EQUAL(first.GetLastRowNumber(), 1000);
+  BOOST_CHECK_EQUAL(first.GetOccurrences(), 1000);
+  BOOST_CHECK_EQUAL(first.GetMessageText(),
+                    "Data truncated. (1000 occurrences, rows 1 to 1000)");
+
+  BOOST_CHECK_EQUAL(diag.GetStatusRecord(2).GetColumnNumber(), 3);
+
+  // Records without a column are never merged.
+  diag.AddStatusRecord(SqlState::SHY000_GENERAL_ERROR, "General error.");
+  diag.AddStatusRecord(SqlState::SHY000_GENERAL_ERROR, "General error.");
+  BOOST_CHECK_EQUAL(diag.GetStatusRecordsNumber(), 4);
+  BOOST_CHECK_EQUAL(diag.GetStatusRecord(4).GetMessageText(),
+                    "General error.");
+}
+
+BOOST_AUTO_TEST_CASE(TestDiagnosableAdapterMergesLiteralMessages) {
+  DiagnosableAdapter adapter;
+
+  for (int32_t row = 1; row <= 1000; ++row)
+    adapter.AddStatusRecord(SqlState::S01004_DATA_TRUNCATED, "Data truncated.",
+                            row, 2);
+
+  const DiagnosticRecordStorage& diag = adapter.GetDiagnosticRecords();
+  BOOST_REQUIRE_EQUAL(diag.GetStatusRecordsNumber(), 1);
+  BOOST_CHECK_EQUAL(diag.GetStatusRecord(1).GetOccurrences(), 1000);
+  BOOST_CHECK_EQUAL(diag.GetStatusRecord(1).GetMessageText(),
+                    "Data truncated. (1000 occurrences, rows 1 to 1000)");
+}
+
+BOOST_AUTO_TEST_CASE(TestDiagnosticRecordLimit) {
+  DiagnosticRecordStorage diag;
+  BOOST_CHECK_EQUAL(diag.GetRecordLimit(),
+                    DiagnosticRecordStorage::DEFAULT_RECORD_LIMIT);
+
+  diag.SetRecordLimit(3);
+  for (int32_t column = 1; column <= 10; ++column)
+    AddTruncation(diag, 1, column);
+
+  BOOST_CHECK_EQUAL(diag.GetStatusRecordsNumber(), 3);
+  BOOST_CHECK_EQUAL(diag.GetDroppedRecordsNumber(), 7);
+
+  // Occurrences of a stored record are still merged at the limit.
+  AddTruncation(diag, 2, 2);
+  BOOST_CHECK_EQUAL(diag.GetStatusRecord(2).GetOccurrences(), 2);
+  BOOST_CHECK_EQUAL(diag.GetDroppedRecordsNumber(), 7);
+
+  // Errors are stored beyond the limit.
+  diag.AddStatusRecord(SqlState::S08S01_LINK_FAILURE, "Link failure.");
+  BOOST_REQUIRE_EQUAL(diag.GetStatusRecordsNumber(), 4);
+  BOOST_CHECK_EQUAL(diag.GetStatusRecord(4).GetSqlState(), "08S01");
+  BOOST_CHECK_EQUAL(diag.GetDroppedRecordsNumber(), 7);
+
+  diag.Reset();
+  BOOST_CHECK_EQUAL(diag.GetStatusRecordsNumber(), 0);
+  BOOST_CHECK_EQUAL(diag.GetDroppedRecordsNumber(), 0);
+
+  AddTruncation(diag, 5, 2);
+  BOOST_CHECK_EQUAL(diag.GetStatusRecordsNumber(), 1);
+  BOOST_CHECK_EQUAL(diag.GetStatusRecord(1).GetOccurrences(), 1);
+  BOOST_CHECK_EQUAL(diag.GetStatusRecord(1).GetMessageText(),
+                    "Data truncated.");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
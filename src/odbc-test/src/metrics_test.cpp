@@ -0,0 +1,162 @@
+/*
+ * Copyright <2022> Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ */
+
+#include <documentdb/odbc/common/platform_utils.h>
+#include <documentdb/odbc/diagnostic/diagnostic_record_storage.h>
+#include <documentdb/odbc/log.h>
+#include <documentdb/odbc/metrics.h>
+
+#include <boost/test/unit_test.hpp>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using documentdb::odbc::Metrics;
+using documentdb::odbc::SqlState;
+using documentdb::odbc::diagnostic::DiagnosticRecordStorage;
+
+namespace {
+std::string ReadFile(const std::string& path) {
+  std::ifstream file(path.c_str());
+  std::stringstream text;
+  text << file.rdbuf();
+  return text.str();
+}
+
+std::string MakeTestPath() {
+  std::stringstream path;
+  path << DEFAULT_LOG_PATH << documentdb::odbc::common::Fs
+       << "documentdb_odbc_metrics_test.prom";
+  return path.str();
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(MetricsTestSuite)
+
+BOOST_AUTO_TEST_CASE(TestMetricsCounterShards) {
+  Metrics& metrics = Metrics::GetInstance();
+  uint64_t before = metrics.GetCounter(Metrics::Counter::ROWS_FETCHED);
+
+  // The worker threads exit before the counter is read, so their shards are
+  // summed from the retired totals, and the main thread's shard is live.
+  const int threadCount = 4;
+  const uint64_t increments = 10000;
+  std::vector< std::thread > threads;
+  for (int i = 0; i < threadCount; ++i) {
+    threads.emplace_back([increments]() {
+      for (uint64_t j = 0; j < increments; ++j)
+        Metrics::Increment(Metrics::Counter::ROWS_FETCHED);
+    });
+  }
+  for (std::thread& thread : threads)
+    thread.join();
+
+  Metrics::Increment(Metrics::Counter::ROWS_FETCHED, 5);
+
+  uint64_t after = metrics.GetCounter(Metrics::Counter::ROWS_FETCHED);
+  BOOST_CHECK_EQUAL(threadCount * increments + 5U, after - before);
+}
+
+BOOST_AUTO_TEST_CASE(TestMetricsPrometheusText) {
+  Metrics& metrics = Metrics::GetInstance();
+  std::string text = metrics.ToPrometheus();
+
+  BOOST_CHECK_NE(
+      std::string::npos,
+      text.find("# TYPE documentdb_odbc_statements_executed_total counter\n"));
+  BOOST_CHECK_NE(std::string::npos,
+                 text.find("# TYPE documentdb_odbc_open_connections gauge\n"));
+  BOOST_CHECK_NE(
+      std::string::npos,
+      text.find("# TYPE documentdb_odbc_translation_seconds histogram\n"));
+
+  // Buckets are cumulative, so a 3 ms translation is counted in the 5 ms
+  // bucket and all larger ones.
+  Metrics::Observe(Metrics::Histogram::TRANSLATION, 3000);
+  std::string after = metrics.ToPrometheus();
+
+  BOOST_CHECK_NE(
+      std::string::npos,
+      after.find("documentdb_odbc_translation_seconds_bucket{le=\"0.005\"}"));
+  BOOST_CHECK_NE(
+      std::string::npos,
+      after.find("documentdb_odbc_translation_seconds_bucket{le=\"+Inf\"}"));
+  BOOST_CHECK_NE(std::string::npos,
+                 after.find("documentdb_odbc_translation_seconds_count "));
+  BOOST_CHECK(text != after);
+}
+
+BOOST_AUTO_TEST_CASE(TestMetricsErrorsBySqlState) {
+  Metrics& metrics = Metrics::GetInstance();
+  uint64_t errors = metrics.GetErrors("08001");
+  uint64_t warnings = metrics.GetErrors("01S02");
+
+  DiagnosticRecordStorage diag;
+  diag.AddStatusRecord(SqlState::S08001_CANNOT_CONNECT, "Cannot connect.");
+  diag.AddStatusRecord(SqlState::S01S02_OPTION_VALUE_CHANGED, "Changed.");
+
+  BOOST_CHECK_EQUAL(errors + 1, metrics.GetErrors("08001"));
+  BOOST_CHECK_EQUAL(warnings, metrics.GetErrors("01S02"));
+  BOOST_CHECK_NE(std::string::npos,
+                 metrics.ToPrometheus().find(
+                     "documentdb_odbc_errors_total{sqlstate=\"08001\"} "));
+}
+
+BOOST_AUTO_TEST_CASE(TestMetricsExportFile) {
+  Metrics& metrics = Metrics::GetInstance();
+  std::string path = MakeTestPath();
+  std::remove(path.c_str());
+
+  metrics.ConfigureExport(path, 0, 1);
+  BOOST_CHECK_EQUAL(0, metrics.GetExportPort());
+
+  // The file is written when the export starts and when it stops.
+  metrics.AddOpenConnections(1);
+  metrics.ConfigureExport("", 0, 1);
+  metrics.AddOpenConnections(-1);
+
+  std::string text = ReadFile(path);
+  BOOST_CHECK_NE(std::string::npos,
+                 text.find("documentdb_odbc_connections_opened_total "));
+  BOOST_CHECK_NE(std::string::npos,
+                 text.find("documentdb_odbc_open_connections "));
+
+  std::remove(path.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(TestMetricsStopExport) {
+  Metrics& metrics = Metrics::GetInstance();
+  std::string path = MakeTestPath();
+  std::remove(path.c_str());
+
+  // The file is written when the export stops.
+  metrics.ConfigureExport(path, 0, 1);
+  metrics.StopExport();
+  std::remove(path.c_str());
+
+  // The same settings start the stopped export again.
+  metrics.ConfigureExport(path, 0, 1);
+  metrics.StopExport();
+  BOOST_CHECK_NE(std::string::npos,
+                 ReadFile(path).find("documentdb_odbc_open_connections "));
+
+  std::remove(path.c_str());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
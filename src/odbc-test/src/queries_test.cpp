@@ -23,14 +23,18 @@
 #include <sqlext.h>
 
 #include <algorithm>
+#include <atomic>
 #include <boost/test/unit_test.hpp>
+#include <map>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "complex_type.h"
 #include "documentdb/odbc/binary/binary_object.h"
 #include "documentdb/odbc/common/fixed_size_array.h"
 #include "documentdb/odbc/impl/binary/binary_utils.h"
+#include "documentdb/odbc/system/odbc_constants.h"
 #include "documentdb/odbc/utility.h"
 #include "odbc_test_suite.h"
 #include "test_type.h"
@@ -1171,6 +1175,505 @@ BOOST_AUTO_TEST_CASE(TestQueryTimeoutQuery) {
     BOOST_FAIL(GetOdbcErrorMessage(SQL_HANDLE_STMT, stmt));
 }
 
+BOOST_AUTO_TEST_CASE(TestParallelScanPartitions) {
+  connectToLocalServer("odbc-test");
+
+  std::vector< SQLWCHAR > req =
+      MakeSqlBuffer("SELECT * FROM queries_test_005");
+
+  SQLRETURN ret = SQLExecDirect(stmt, req.data(), SQL_NTS);
+  ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+
+  int expected = CountRows(stmt);
+
+  ret = SQLFreeStmt(stmt, SQL_CLOSE);
+  ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+
+  ret = SQLSetStmtAttr(stmt, SQL_ATTR_DOCUMENTDB_PARALLEL_SCAN_PARTITIONS,
+                       reinterpret_cast< SQLPOINTER >(4), 0);
+  ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+
+  SQLULEN partitions = 0;
+  ret = SQLGetStmtAttr(stmt, SQL_ATTR_DOCUMENTDB_PARALLEL_SCAN_PARTITIONS,
+                       &partitions, 0, nullptr);
+  ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+  BOOST_CHECK_EQUAL(partitions, 4);
+
+  ret = SQLExecDirect(stmt, req.data(), SQL_NTS);
+  ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+
+  BOOST_CHECK_EQUAL(CountRows(stmt), expected);
+
+  ret = SQLSetStmtAttr(
+      stmt, SQL_ATTR_DOCUMENTDB_PARALLEL_SCAN_PARTITIONS,
+      reinterpret_cast< SQLPOINTER >(MAX_PARALLEL_SCAN_PARTITIONS + 1), 0);
+  BOOST_CHECK_EQUAL(ret, SQL_ERROR);
+  BOOST_CHECK_EQUAL("HY024", GetOdbcErrorState(SQL_HANDLE_STMT, stmt));
+}
+
+BOOST_AUTO_TEST_CASE(TestParallelScanMixedIdTypes) {
+  connectToLocalServer("odbc-test");
+
+  // 12 ObjectId values, and a string, int, long, UUID and date.
+  std::vector< SQLWCHAR > req =
+      MakeSqlBuffer("SELECT * FROM queries_test_007");
+
+  SQLRETURN ret = SQLExecDirect(stmt, req.data(), SQL_NTS);
+  ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+
+  BOOST_CHECK_EQUAL(CountRows(stmt), 17);
+
+  ret = SQLFreeStmt(stmt, SQL_CLOSE);
+  ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+
+  ret = SQLSetStmtAttr(stmt, SQL_ATTR_DOCUMENTDB_PARALLEL_SCAN_PARTITIONS,
+                       reinterpret_cast< SQLPOINTER >(4), 0);
+  ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+
+  ret = SQLExecDirect(stmt, req.data(), SQL_NTS);
+  ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+
+  BOOST_CHECK_EQUAL(CountRows(stmt), 17);
+}
+
+BOOST_AUTO_TEST_CASE(TestMaxRowsAndMaxLength) {
+  connectToLocalServer("odbc-test");
+
+  SQLRETURN ret = SQLSetStmtAttr(stmt, SQL_ATTR_MAX_ROWS,
+                                 reinterpret_cast< SQLPOINTER >(2), 0);
+  ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+
+  ret = SQLSetStmtAttr(stmt, SQL_ATTR_MAX_LENGTH,
+                       reinterpret_cast< SQLPOINTER >(6), 0);
+  ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+
+  SQLULEN maxRows = 0;
+  ret = SQLGetStmtAttr(stmt, SQL_ATTR_MAX_ROWS, &maxRows, 0, nullptr);
+  ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+  BOOST_CHECK_EQUAL(maxRows, 2);
+
+  std::vector< SQLWCHAR > req = MakeSqlBuffer(
+      "SELECT fieldString FROM queries_test_006 ORDER BY fieldInt");
+
+  ret = SQLExecDirect(stmt, req.data(), SQL_NTS);
+  ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+
+  SQLCHAR fieldString[ODBC_BUFFER_SIZE]{};
+  SQLLEN fieldString_len = 0;
+
+  for (int i = 0; i < 2; ++i) {
+    ret = SQLFetch(stmt);
+    ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+
+    ret = SQLGetData(stmt, 1, SQL_C_CHAR, fieldString, sizeof(fieldString),
+                     &fieldString_len);
+    ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+    BOOST_CHECK_EQUAL(std::string("String"),
+                      std::string((char*)fieldString));
+  }
+
+  ret = SQLFetch(stmt);
+  BOOST_CHECK_EQUAL(SQL_NO_DATA, ret);
+
+  ret = SQLFreeStmt(stmt, SQL_CLOSE);
+  ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+
+  // The maximum number of rows is applied by a single $limit stage.
+  req = MakeSqlBuffer("EXPLAIN SELECT fieldString FROM queries_test_006");
+  ret = SQLExecDirect(stmt, req.data(), SQL_NTS);
+  ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+
+  int limits = 0;
+  while ((ret = SQLFetch(stmt)) == SQL_SUCCESS) {
+    SQLWCHAR item[ODBC_BUFFER_SIZE]{};
+    SQLLEN itemLen = 0;
+    ret = SQLGetData(stmt, 1, SQL_C_WCHAR, item, sizeof(item), &itemLen);
+    ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+
+    SQLWCHAR value[ODBC_BUFFER_SIZE]{};
+    SQLLEN valueLen = 0;
+    ret = SQLGetData(stmt, 2, SQL_C_WCHAR, value, sizeof(value), &valueLen);
+    BOOST_CHECK(SQL_SUCCEEDED(ret));
+
+    if (utility::SqlWcharToString(item, itemLen, true).find("stage ") == 0
+        && utility::SqlWcharToString(value, valueLen, true).find("$limit")
+               != std::string::npos) {
+      ++limits;
+    }
+  }
+  BOOST_CHECK_EQUAL(SQL_NO_DATA, ret);
+  BOOST_CHECK_EQUAL(limits, 1);
+}
+
+BOOST_AUTO_TEST_CASE(TestCountStar) {
+  const std::string queries[] = {
+      "SELECT COUNT(*) FROM queries_test_005",
+      "SELECT COUNT(*) FROM queries_test_005 WHERE fieldInt = 1"};
+  const std::string options[] = {"", "APPROXIMATE_COUNT=true;"};
+
+  for (const std::string& option : options) {
+    std::string dsnConnectionString;
+    CreateDsnConnectionStringForLocalServer(dsnConnectionString, "odbc-test",
+                                            "", option);
+    Connect(dsnConnectionString);
+
+    std::vector< SQLWCHAR > req =
+        MakeSqlBuffer("SELECT * FROM queries_test_005");
+    SQLRETURN ret = SQLExecDirect(stmt, req.data(), SQL_NTS);
+    ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+
+    SQLBIGINT expected[] = {CountRows(stmt), 1};
+
+    ret = SQLFreeStmt(stmt, SQL_CLOSE);
+    ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+
+    for (int i = 0; i < 2; ++i) {
+      req = MakeSqlBuffer(queries[i]);
+      ret = SQLExecDirect(stmt, req.data(), SQL_NTS);
+      ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+
+      ret = SQLFetch(stmt);
+      ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+
+      SQLBIGINT count = 0;
+      SQLLEN count_len = 0;
+      ret = SQLGetData(stmt, 1, SQL_C_SBIGINT, &count, sizeof(count),
+                       &count_len);
+      ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+      BOOST_CHECK_EQUAL(count, expected[i]);
+
+      ret = SQLFetch(stmt);
+      BOOST_CHECK_EQUAL(SQL_NO_DATA, ret);
+
+      ret = SQLFreeStmt(stmt, SQL_CLOSE);
+      ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+    }
+
+    Disconnect();
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestAggregateOptions) {
+  connectToLocalServer("odbc-test");
+
+  SQLRETURN ret = SQLSetStmtAttr(stmt, SQL_ATTR_DOCUMENTDB_ALLOW_DISK_USE,
+                                 reinterpret_cast< SQLPOINTER >(SQL_TRUE), 0);
+  ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+
+  ret = SQLSetStmtAttr(stmt, SQL_ATTR_DOCUMENTDB_BATCH_SIZE,
+                       reinterpret_cast< SQLPOINTER >(2), 0);
+  ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+
+  std::vector< SQLWCHAR > hint = MakeSqlBuffer("_id_");
+  ret = SQLSetStmtAttr(stmt, SQL_ATTR_DOCUMENTDB_HINT, hint.data(), SQL_NTS);
+  ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+
+  std::vector< SQLWCHAR > comment = MakeSqlBuffer("queries_test");
+  ret = SQLSetStmtAttr(stmt, SQL_ATTR_DOCUMENTDB_COMMENT, comment.data(),
+                       SQL_NTS);
+  ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+
+  std::vector< SQLWCHAR > readConcern = MakeSqlBuffer("local");
+  ret = SQLSetStmtAttr(stmt, SQL_ATTR_DOCUMENTDB_READ_CONCERN,
+                       readConcern.data(), SQL_NTS);
+  ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+
+  SQLWCHAR buf[ODBC_BUFFER_SIZE]{};
+  SQLINTEGER bufLen = 0;
+  ret = SQLGetStmtAttr(stmt, SQL_ATTR_DOCUMENTDB_COMMENT, buf, sizeof(buf),
+                       &bufLen);
+  ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+  BOOST_CHECK_EQUAL(utility::SqlWcharToString(buf, bufLen, true),
+                    "queries_test");
+
+  std::vector< SQLWCHAR > req =
+      MakeSqlBuffer("SELECT * FROM queries_test_005");
+  ret = SQLExecDirect(stmt, req.data(), SQL_NTS);
+  ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+
+  BOOST_CHECK_GT(CountRows(stmt), 0);
+
+  std::vector< SQLWCHAR > invalid = MakeSqlBuffer("eventual");
+  ret = SQLSetStmtAttr(stmt, SQL_ATTR_DOCUMENTDB_READ_CONCERN, invalid.data(),
+                       SQL_NTS);
+  BOOST_CHECK_EQUAL(ret, SQL_ERROR);
+  BOOST_CHECK_EQUAL("HY024", GetOdbcErrorState(SQL_HANDLE_STMT, stmt));
+
+  invalid = MakeSqlBuffer("{locale");
+  ret = SQLSetStmtAttr(stmt, SQL_ATTR_DOCUMENTDB_COLLATION, invalid.data(),
+                       SQL_NTS);
+  BOOST_CHECK_EQUAL(ret, SQL_ERROR);
+  BOOST_CHECK_EQUAL("HY024", GetOdbcErrorState(SQL_HANDLE_STMT, stmt));
+}
+
+BOOST_AUTO_TEST_CASE(TestExplain) {
+  connectToLocalServer("odbc-test");
+
+  std::vector< SQLWCHAR > req =
+      MakeSqlBuffer("EXPLAIN SELECT * FROM queries_test_005");
+  SQLRETURN ret = SQLExecDirect(stmt, req.data(), SQL_NTS);
+  ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+
+  SQLSMALLINT columnCount = 0;
+  ret = SQLNumResultCols(stmt, &columnCount);
+  ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+  BOOST_CHECK_EQUAL(columnCount, 2);
+
+  std::map< std::string, std::string > items;
+  while ((ret = SQLFetch(stmt)) == SQL_SUCCESS) {
+    SQLWCHAR item[ODBC_BUFFER_SIZE]{};
+    SQLLEN itemLen = 0;
+    ret = SQLGetData(stmt, 1, SQL_C_WCHAR, item, sizeof(item), &itemLen);
+    ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+
+    SQLWCHAR value[ODBC_BUFFER_SIZE]{};
+    SQLLEN valueLen = 0;
+    ret = SQLGetData(stmt, 2, SQL_C_WCHAR, value, sizeof(value), &valueLen);
+    BOOST_CHECK(SQL_SUCCEEDED(ret));
+
+    items[utility::SqlWcharToString(item, itemLen, true)] =
+        utility::SqlWcharToString(value, valueLen, true);
+  }
+  BOOST_CHECK_EQUAL(SQL_NO_DATA, ret);
+
+  BOOST_CHECK_EQUAL(items["collection"], "queries_test_005");
+  BOOST_CHECK(items.find("stage 1") != items.end());
+  BOOST_CHECK(items.find("translation_time_ms") != items.end());
+  BOOST_CHECK_EQUAL(items["read_preference"], "primary");
+  BOOST_CHECK(!items["server"].empty());
+  BOOST_CHECK(items.find("explain") != items.end());
+
+  ret = SQLFreeStmt(stmt, SQL_CLOSE);
+  ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+
+  req = MakeSqlBuffer("EXPLAIN");
+  ret = SQLExecDirect(stmt, req.data(), SQL_NTS);
+  BOOST_CHECK_EQUAL(ret, SQL_ERROR);
+}
+
+BOOST_AUTO_TEST_CASE(TestReadRouting) {
+  std::string dsnConnectionString;
+  CreateDsnConnectionStringForLocalServer(
+      dsnConnectionString, "odbc-test", "",
+      "ANALYTICS_ROUTING=true;LOCAL_THRESHOLD_MS=20;");
+  Connect(dsnConnectionString);
+
+  const char* queries[] = {"EXPLAIN SELECT * FROM queries_test_005",
+                           "EXPLAIN SELECT COUNT(*) FROM queries_test_005"};
+  const char* expected[] = {"primary", "secondary_preferred"};
+  for (int i = 0; i < 2; ++i) {
+    std::vector< SQLWCHAR > req = MakeSqlBuffer(queries[i]);
+    SQLRETURN ret = SQLExecDirect(stmt, req.data(), SQL_NTS);
+    ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+
+    std::string readPreference;
+    while (SQL_SUCCEEDED(ret = SQLFetch(stmt))) {
+      SQLWCHAR item[ODBC_BUFFER_SIZE]{};
+      SQLLEN itemLen = 0;
+      ret = SQLGetData(stmt, 1, SQL_C_WCHAR, item, sizeof(item), &itemLen);
+      BOOST_CHECK(SQL_SUCCEEDED(ret));
+
+      std::string name = utility::SqlWcharToString(item, itemLen, true);
+      if (name == "read_preference") {
+        SQLWCHAR value[ODBC_BUFFER_SIZE]{};
+        SQLLEN valueLen = 0;
+        ret = SQLGetData(stmt, 2, SQL_C_WCHAR, value, sizeof(value),
+                         &valueLen);
+        BOOST_CHECK(SQL_SUCCEEDED(ret));
+        readPreference = utility::SqlWcharToString(value, valueLen, true);
+      }
+    }
+    BOOST_CHECK_EQUAL(readPreference, expected[i]);
+
+    ret = SQLFreeStmt(stmt, SQL_CLOSE);
+    ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+  }
+
+  SQLRETURN ret =
+      SQLSetStmtAttr(stmt, SQL_ATTR_DOCUMENTDB_MAX_STALENESS_SECONDS,
+                     reinterpret_cast< SQLPOINTER >(10), 0);
+  BOOST_CHECK_EQUAL(ret, SQL_ERROR);
+  BOOST_CHECK_EQUAL("HY024", GetOdbcErrorState(SQL_HANDLE_STMT, stmt));
+
+  ret = SQLSetStmtAttr(stmt, SQL_ATTR_DOCUMENTDB_MAX_STALENESS_SECONDS,
+                       reinterpret_cast< SQLPOINTER >(120), 0);
+  ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+
+  SQLULEN staleness = 0;
+  ret = SQLGetStmtAttr(stmt, SQL_ATTR_DOCUMENTDB_MAX_STALENESS_SECONDS,
+                       &staleness, sizeof(staleness), nullptr);
+  ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+  BOOST_CHECK_EQUAL(staleness, 120);
+
+  // The analytic count runs on a secondary with the maximum staleness.
+  std::vector< SQLWCHAR > req =
+      MakeSqlBuffer("SELECT COUNT(*) FROM queries_test_005");
+  ret = SQLExecDirect(stmt, req.data(), SQL_NTS);
+  ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+  BOOST_CHECK_EQUAL(CountRows(stmt), 1);
+
+  SQLWCHAR counts[ODBC_BUFFER_SIZE]{};
+  SQLINTEGER countsLen = 0;
+  ret = SQLGetConnectAttr(dbc, SQL_ATTR_DOCUMENTDB_NODE_STATEMENT_COUNTS,
+                          counts, sizeof(counts), &countsLen);
+  ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_DBC, dbc);
+  BOOST_CHECK(utility::SqlWcharToString(counts, countsLen, true).find('=')
+              != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(TestStatementTrace) {
+  connectToLocalServer("odbc-test");
+
+  SQLWCHAR trace[ODBC_BUFFER_SIZE]{};
+  SQLINTEGER traceLen = 0;
+  SQLRETURN ret = SQLGetStmtAttr(stmt, SQL_ATTR_DOCUMENTDB_STATEMENT_TRACE,
+                                 trace, sizeof(trace), &traceLen);
+  ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+  BOOST_CHECK_EQUAL(utility::SqlWcharToString(trace, traceLen, true), "{}");
+
+  // One row per batch, so that the rows are fetched with getMore.
+  ret = SQLSetStmtAttr(stmt, SQL_ATTR_DOCUMENTDB_BATCH_SIZE,
+                       reinterpret_cast< SQLPOINTER >(1), 0);
+  ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+
+  std::vector< SQLWCHAR > req =
+      MakeSqlBuffer("SELECT * FROM queries_test_005");
+  ret = SQLExecDirect(stmt, req.data(), SQL_NTS);
+  ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+
+  SQLWCHAR value[ODBC_BUFFER_SIZE]{};
+  SQLLEN valueLen = 0;
+  ret = SQLBindCol(stmt, 1, SQL_C_WCHAR, value, sizeof(value), &valueLen);
+  ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+  int rows = CountRows(stmt);
+  BOOST_CHECK_GT(rows, 1);
+
+  ret = SQLGetStmtAttr(stmt, SQL_ATTR_DOCUMENTDB_STATEMENT_TRACE, trace,
+                       sizeof(trace), &traceLen);
+  ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+  std::string json = utility::SqlWcharToString(trace, traceLen, true);
+  BOOST_CHECK(json.find("\"rows\":" + std::to_string(rows) + ",")
+              != std::string::npos);
+  BOOST_CHECK(json.find("\"conversions\":" + std::to_string(rows) + ",")
+              != std::string::npos);
+  BOOST_CHECK(json.find("\"batches\":0,") == std::string::npos);
+  BOOST_CHECK(json.find("\"bytes\":0,") == std::string::npos);
+  BOOST_CHECK(json.find("\"translate_us\":") != std::string::npos);
+  BOOST_CHECK(json.find("\"get_more_us\":") != std::string::npos);
+
+  ret = SQLSetStmtAttr(stmt, SQL_ATTR_DOCUMENTDB_STATEMENT_TRACE,
+                       reinterpret_cast< SQLPOINTER >(1), 0);
+  BOOST_CHECK_EQUAL(ret, SQL_ERROR);
+  BOOST_CHECK_EQUAL("HY092", GetOdbcErrorState(SQL_HANDLE_STMT, stmt));
+}
+
+BOOST_AUTO_TEST_CASE(TestConcurrentStatements) {
+  // Fewer clients than threads, so statements also wait for clients.
+  std::string dsnConnectionString;
+  CreateDsnConnectionStringForLocalServer(dsnConnectionString, "odbc-test", "",
+                                          "CLIENT_POOL_SIZE=4;");
+  Connect(dsnConnectionString);
+
+  std::vector< SQLWCHAR > req =
+      MakeSqlBuffer("SELECT * FROM queries_test_006");
+  SQLRETURN ret = SQLExecDirect(stmt, req.data(), SQL_NTS);
+  ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+
+  const int expected = CountRows(stmt);
+  BOOST_REQUIRE_GT(expected, 0);
+
+  ret = SQLFreeStmt(stmt, SQL_CLOSE);
+  ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmt);
+
+  const int threadsNum = 8;
+  const int iterationsNum = 20;
+
+  // Boost.Test assertions are not thread-safe, so the workers only count
+  // failures.
+  std::atomic< int > failures(0);
+  std::vector< std::thread > threads;
+  for (int i = 0; i < threadsNum; ++i) {
+    threads.emplace_back([this, &req, &failures, expected]() {
+      SQLHSTMT threadStmt = SQL_NULL_HSTMT;
+      if (!SQL_SUCCEEDED(SQLAllocHandle(SQL_HANDLE_STMT, dbc, &threadStmt))) {
+        ++failures;
+        return;
+      }
+
+      for (int j = 0; j < iterationsNum; ++j) {
+        std::vector< SQLWCHAR > query(req);
+        if (!SQL_SUCCEEDED(SQLExecDirect(threadStmt, query.data(), SQL_NTS))) {
+          ++failures;
+          break;
+        }
+
+        int rows = 0;
+        SQLRETURN fetchRet;
+        while ((fetchRet = SQLFetch(threadStmt)) == SQL_SUCCESS)
+          ++rows;
+
+        if (fetchRet != SQL_NO_DATA || rows != expected)
+          ++failures;
+
+        SQLFreeStmt(threadStmt, SQL_CLOSE);
+      }
+
+      SQLFreeHandle(SQL_HANDLE_STMT, threadStmt);
+    });
+  }
+
+  for (std::thread& thread : threads)
+    thread.join();
+
+  BOOST_CHECK_EQUAL(failures.load(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(TestClientPoolExhausted) {
+  const int poolSize = 2;
+  std::string dsnConnectionString;
+  CreateDsnConnectionStringForLocalServer(
+      dsnConnectionString, "odbc-test", "",
+      "CLIENT_POOL_SIZE=" + std::to_string(poolSize) + ";");
+  Connect(dsnConnectionString);
+
+  std::vector< SQLWCHAR > req =
+      MakeSqlBuffer("SELECT * FROM queries_test_006");
+
+  // Each open cursor holds a client of the pool until it is closed.
+  std::vector< SQLHSTMT > stmts;
+  for (int i = 0; i <= poolSize; ++i) {
+    SQLHSTMT cursorStmt = SQL_NULL_HSTMT;
+    SQLRETURN ret = SQLAllocHandle(SQL_HANDLE_STMT, dbc, &cursorStmt);
+    ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_DBC, dbc);
+    stmts.push_back(cursorStmt);
+  }
+
+  for (int i = 0; i < poolSize; ++i) {
+    SQLRETURN ret = SQLExecDirect(stmts[i], req.data(), SQL_NTS);
+    ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmts[i]);
+  }
+
+  // The statement beyond the pool size fails instead of waiting forever.
+  SQLRETURN ret = SQLSetStmtAttr(stmts[poolSize], SQL_ATTR_QUERY_TIMEOUT,
+                                 reinterpret_cast< SQLPOINTER >(1), 0);
+  ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmts[poolSize]);
+
+  ret = SQLExecDirect(stmts[poolSize], req.data(), SQL_NTS);
+  BOOST_CHECK_EQUAL(ret, SQL_ERROR);
+  BOOST_CHECK_EQUAL("HYT00",
+                    GetOdbcErrorState(SQL_HANDLE_STMT, stmts[poolSize]));
+
+  // A closed cursor releases its client.
+  ret = SQLFreeStmt(stmts[0], SQL_CLOSE);
+  ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmts[0]);
+
+  ret = SQLExecDirect(stmts[poolSize], req.data(), SQL_NTS);
+  ODBC_FAIL_ON_ERROR(ret, SQL_HANDLE_STMT, stmts[poolSize]);
+
+  for (SQLHSTMT cursorStmt : stmts)
+    SQLFreeHandle(SQL_HANDLE_STMT, cursorStmt);
+}
+
 BOOST_AUTO_TEST_CASE(TestManyCursors) {
   connectToLocalServer("odbc-test");
 
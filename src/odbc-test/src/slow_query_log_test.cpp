@@ -0,0 +1,145 @@
+/*
+ * Copyright <2022> Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ */
+
+#include <documentdb/odbc/log.h>
+#include <documentdb/odbc/log_level.h>
+#include <documentdb/odbc/slow_query_log.h>
+#include <documentdb/odbc/statement_trace.h>
+
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using documentdb::odbc::Logger;
+using documentdb::odbc::LogLevel;
+using documentdb::odbc::SlowQueryLog;
+using documentdb::odbc::StatementTrace;
+
+namespace {
+SlowQueryLog::Entry MakeEntry() {
+  SlowQueryLog::Entry entry;
+  entry.sql = "SELECT * FROM \"test\" WHERE name = 'a\\b'";
+  entry.collection = "slow_query_log_test";
+  entry.stages.push_back("{\"$match\": {\"name\": \"a\\\\b\"}}");
+  entry.stages.push_back("{\"$limit\": 10}");
+  entry.comment = "documentdb-odbc";
+  entry.thresholdMs = 100;
+  entry.elapsedMicros = 250600;
+  entry.driverMicros = 120400;
+  entry.trace = "{\"rows\":3}";
+  return entry;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(SlowQueryLogTestSuite)
+
+BOOST_AUTO_TEST_CASE(TestSlowQueryLogFormatRedacted) {
+  std::shared_ptr< Logger > logger = Logger::GetLoggerInstance();
+  LogLevel::Type origLogLevel = logger->GetLogLevel();
+  logger->SetLogLevel(LogLevel::Type::INFO_LEVEL);
+
+  std::string line = SlowQueryLog::Format(MakeEntry());
+  logger->SetLogLevel(origLogLevel);
+
+  BOOST_CHECK_EQUAL(0U, line.find("{\"time\":\""));
+  BOOST_CHECK_NE(std::string::npos,
+                 line.find("\"elapsed_ms\":250,\"driver_ms\":120,"
+                           "\"threshold_ms\":100,"));
+  BOOST_CHECK_NE(std::string::npos,
+                 line.find("\"collection\":\"slow_query_log_test\""));
+  BOOST_CHECK_NE(std::string::npos,
+                 line.find("\"comment\":\"documentdb-odbc\""));
+  BOOST_CHECK_NE(std::string::npos,
+                 line.find("\"sql\":\"" REDACTED_STRING "\""));
+  BOOST_CHECK_NE(std::string::npos,
+                 line.find("\"pipeline\":\"" REDACTED_STRING "\""));
+  BOOST_CHECK_NE(std::string::npos, line.find("\"trace\":{\"rows\":3}}"));
+  BOOST_CHECK_EQUAL(std::string::npos, line.find("name"));
+  BOOST_CHECK_EQUAL(std::string::npos, line.find('\n'));
+}
+
+BOOST_AUTO_TEST_CASE(TestSlowQueryLogFormatJson) {
+  std::shared_ptr< Logger > logger = Logger::GetLoggerInstance();
+  LogLevel::Type origLogLevel = logger->GetLogLevel();
+  logger->SetLogLevel(LogLevel::Type::INFO_LEVEL);
+  logger->SetJsonFormat(true);
+
+  std::string line = SlowQueryLog::Format(MakeEntry());
+  logger->SetJsonFormat(false);
+  logger->SetLogLevel(origLogLevel);
+
+  BOOST_CHECK_NE(std::string::npos,
+                 line.find("\"sql\":\"SELECT * FROM \\\"" REDACTED_STRING
+                           "\\\" WHERE name = '" REDACTED_STRING "'\""));
+  BOOST_CHECK_NE(std::string::npos,
+                 line.find("\"pipeline\":\"" REDACTED_STRING "\""));
+}
+
+BOOST_AUTO_TEST_CASE(TestSlowQueryLogFormatDebug) {
+  std::shared_ptr< Logger > logger = Logger::GetLoggerInstance();
+  LogLevel::Type origLogLevel = logger->GetLogLevel();
+  logger->SetLogLevel(LogLevel::Type::DEBUG_LEVEL);
+
+  std::string line = SlowQueryLog::Format(MakeEntry());
+  logger->SetLogLevel(origLogLevel);
+
+  BOOST_CHECK_NE(
+      std::string::npos,
+      line.find(
+          "\"sql\":\"SELECT * FROM \\\"test\\\" WHERE name = 'a\\\\b'\""));
+  BOOST_CHECK_NE(std::string::npos,
+                 line.find("\"pipeline\":[{\"$match\": {\"name\": "
+                           "\"a\\\\b\"}},{\"$limit\": 10}]"));
+}
+
+BOOST_AUTO_TEST_CASE(TestSlowQueryLogWrite) {
+  SlowQueryLog& slowQueryLog = SlowQueryLog::GetInstance();
+  SlowQueryLog::Entry entry = MakeEntry();
+  entry.collection = "slow_query_log_write_test";
+  slowQueryLog.Write(entry);
+
+  std::string path = slowQueryLog.GetFilePath();
+  BOOST_CHECK_NE(std::string::npos, path.find("docdb_odbc_slow_"));
+
+  std::ifstream file(path.c_str());
+  std::stringstream text;
+  text << file.rdbuf();
+  BOOST_CHECK_NE(
+      std::string::npos,
+      text.str().find("\"collection\":\"slow_query_log_write_test\""));
+}
+
+BOOST_AUTO_TEST_CASE(TestSlowQueryDriverTime) {
+  StatementTrace trace;
+  trace.Start();
+  trace.translateMicros = 1000;
+  trace.parseMicros = 200;
+  trace.firstBatchMicros = 3000;
+  trace.getMoreMicros = 4000;
+  trace.convertMicros = 500;
+
+  // The time the application spends between fetches is not driver time.
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  trace.Finish();
+
+  BOOST_CHECK_EQUAL(trace.GetDriverMicros(), 8700);
+  BOOST_CHECK_GE(trace.GetElapsedMicros(), 20000);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,222 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _WIN32_WINNT
+#define _WIN32_WINNT 0x0601
+#endif  // _WIN32_WINNT
+
+#include <boost/asio.hpp>
+
+#include <array>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include "test_proxy.h"
+
+namespace documentdb_test {
+using boost::asio::ip::tcp;
+
+class TestProxy::Impl {
+ public:
+  /**
+   * Constructor.
+   *
+   * @param host Host of the server.
+   * @param port Port of the server.
+   */
+  Impl(const std::string& host, const std::string& port)
+      : acceptor(service,
+                 tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0)) {
+    tcp::resolver resolver(service);
+    target = resolver.resolve(tcp::v4(), host, port).begin()->endpoint();
+
+    StartAccept();
+    serviceThread = std::thread([this]() { service.run(); });
+  }
+
+  /**
+   * Destructor.
+   */
+  ~Impl() {
+    service.stop();
+    serviceThread.join();
+  }
+
+  /**
+   * Get the local port.
+   *
+   * @return Port.
+   */
+  uint16_t GetPort() const {
+    return acceptor.local_endpoint().port();
+  }
+
+  /**
+   * Drop the links forwarded so far.
+   *
+   * @return Number of dropped links.
+   */
+  size_t DropLinks() {
+    std::promise< size_t > dropped;
+    boost::asio::post(service, [this, &dropped]() {
+      for (std::shared_ptr< Link >& link : links) {
+        Close(*link);
+      }
+      dropped.set_value(links.size());
+      links.clear();
+    });
+
+    return dropped.get_future().get();
+  }
+
+ private:
+  /** Size of the buffer of each direction of a link. */
+  static const size_t BUFFER_SIZE = 16384;
+
+  /**
+   * Forwarded connection.
+   */
+  struct Link {
+    /**
+     * Constructor.
+     *
+     * @param service Asio service.
+     */
+    explicit Link(boost::asio::io_context& service)
+        : client(service), server(service) {
+      // No-op.
+    }
+
+    /** Socket accepted from the client. */
+    tcp::socket client;
+
+    /** Socket connected to the server. */
+    tcp::socket server;
+
+    /** Data from the client to the server. */
+    std::array< char, BUFFER_SIZE > upstream;
+
+    /** Data from the server to the client. */
+    std::array< char, BUFFER_SIZE > downstream;
+  };
+
+  /**
+   * Accept the next connection.
+   */
+  void StartAccept() {
+    std::shared_ptr< Link > link = std::make_shared< Link >(service);
+
+    acceptor.async_accept(
+        link->client, [this, link](const boost::system::error_code& error) {
+          if (error) {
+            return;
+          }
+
+          link->server.async_connect(
+              target, [this, link](const boost::system::error_code& error) {
+                if (error) {
+                  Close(*link);
+                  return;
+                }
+
+                links.push_back(link);
+                Pump(link, link->client, link->server, link->upstream);
+                Pump(link, link->server, link->client, link->downstream);
+              });
+
+          StartAccept();
+        });
+  }
+
+  /**
+   * Copy the data of one direction of a link until it is closed.
+   *
+   * @param link Link.
+   * @param from Socket to read.
+   * @param to Socket to write.
+   * @param buffer Buffer of the direction.
+   */
+  void Pump(std::shared_ptr< Link > link, tcp::socket& from, tcp::socket& to,
+            std::array< char, BUFFER_SIZE >& buffer) {
+    from.async_read_some(
+        boost::asio::buffer(buffer),
+        [this, link, &from, &to, &buffer](
+            const boost::system::error_code& error, size_t length) {
+          if (error) {
+            Close(*link);
+            return;
+          }
+
+          boost::asio::async_write(
+              to, boost::asio::buffer(buffer.data(), length),
+              [this, link, &from, &to, &buffer](
+                  const boost::system::error_code& error, size_t) {
+                if (error) {
+                  Close(*link);
+                  return;
+                }
+
+                Pump(link, from, to, buffer);
+              });
+        });
+  }
+
+  /**
+   * Close both sockets of a link.
+   *
+   * @param link Link.
+   */
+  static void Close(Link& link) {
+    boost::system::error_code ignored;
+    link.client.close(ignored);
+    link.server.close(ignored);
+  }
+
+  /** Service. */
+  boost::asio::io_context service;
+
+  /** Acceptor. */
+  tcp::acceptor acceptor;
+
+  /** Address of the server. */
+  tcp::endpoint target;
+
+  /** Links, only used by the service thread. */
+  std::vector< std::shared_ptr< Link > > links;
+
+  /** Service thread. */
+  std::thread serviceThread;
+};
+
+TestProxy::TestProxy(const std::string& host, const std::string& port)
+    : impl(new Impl(host, port)) {
+  // No-op.
+}
+
+TestProxy::~TestProxy() {
+  // Defined here, where Impl is complete.
+}
+
+uint16_t TestProxy::GetPort() const {
+  return impl->GetPort();
+}
+
+size_t TestProxy::DropLinks() {
+  return impl->DropLinks();
+}
+}  // namespace documentdb_test
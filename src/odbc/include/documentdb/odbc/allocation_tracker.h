@@ -0,0 +1,196 @@
+/*
+ * Copyright <2022> Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ */
+
+
+#ifndef _DOCUMENTDB_ODBC_ALLOCATION_TRACKER
+#define _DOCUMENTDB_ODBC_ALLOCATION_TRACKER
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+
+#include "documentdb/odbc/common/common.h"
+
+namespace documentdb {
+namespace odbc {
+/**
+ * Counts the memory allocations of the statement running on the thread, by
+ * driver component. The allocations are reported to the current statement
+ * trace, see StatementTrace::Scope.
+ *
+ * The driver counts its allocations only when it is built with
+ * WITH_ALLOCATION_TRACKING, which replaces the global operator new and
+ * delete with versions that call Allocated and Released. Memory allocated
+ * with malloc, such as the BSON buffers of the MongoDB C driver and the
+ * memory of the JVM, is not counted.
+ *
+ * On Linux the tracking build links the driver with -Bsymbolic-functions, so
+ * that its calls to operator new and delete bind to the replacements even
+ * though the C++ runtime is loaded first. Allocations made inside the C++
+ * runtime, such as those of the std::string members it instantiates, are
+ * still not counted.
+ */
+class AllocationTracker {
+ public:
+  /**
+   * Driver component an allocation is made in.
+   */
+  struct Component {
+    enum Type {
+      /** Not in one of the components below. */
+      OTHER = 0,
+
+      /** Cursor iteration over the result batches. */
+      CURSOR,
+
+      /** Rows and columns of the result. */
+      ROW,
+
+      /** Conversion of the column values to the application buffers. */
+      CONVERSION,
+
+      /** Diagnostic records. */
+      DIAGNOSTICS,
+
+      /** Copies of the Java strings returned by the JDBC driver. */
+      JNI,
+
+      /** Number of components. */
+      COUNT
+    };
+  };
+
+  /**
+   * Allocation counters of a statement.
+   */
+  struct Stats {
+    /** Number of allocations, by component. */
+    uint64_t allocations[Component::COUNT];
+
+    /** Size of the allocations, in bytes, by component. */
+    uint64_t bytes[Component::COUNT];
+
+    /** Bytes allocated less bytes released by the statement. */
+    int64_t liveBytes;
+
+    /** Highest value of liveBytes. */
+    int64_t peakBytes;
+
+    /**
+     * Constructor. Sets all counters to zero.
+     */
+    Stats();
+
+    /**
+     * Get the number of allocations of all components.
+     *
+     * @return Number of allocations.
+     */
+    uint64_t GetAllocations() const;
+
+    /**
+     * Get the size of the allocations of all components.
+     *
+     * @return Size in bytes.
+     */
+    uint64_t GetBytes() const;
+
+    /**
+     * Format the counters as a JSON object.
+     *
+     * @return JSON object.
+     */
+    std::string ToJson() const;
+  };
+
+  /**
+   * Makes a component the current one of the thread while in scope.
+   */
+  class ComponentScope {
+   public:
+    /**
+     * Constructor.
+     *
+     * @param component Component to make current.
+     */
+    explicit ComponentScope(Component::Type component);
+
+    /**
+     * Destructor. Restores the previous current component.
+     */
+    ~ComponentScope();
+
+   private:
+    DOCUMENTDB_NO_COPY_ASSIGNMENT(ComponentScope);
+
+    /** Previous current component. */
+    Component::Type previous;
+  };
+
+  /**
+   * Check if the driver was built with the allocation tracking.
+   *
+   * @return True if the allocations are counted.
+   */
+  static bool IsEnabled();
+
+  /**
+   * Get the name of a component.
+   *
+   * @param component Component.
+   * @return Name.
+   */
+  static const char* GetComponentName(Component::Type component);
+
+  /**
+   * Count an allocation in the current component of the current statement
+   * trace of the thread, if any.
+   *
+   * Must not allocate memory.
+   *
+   * @param size Size of the allocation, in bytes.
+   */
+  static void Allocated(size_t size);
+
+  /**
+   * Count a release in the current statement trace of the thread, if any.
+   *
+   * Must not allocate memory.
+   *
+   * @param size Size of the released memory, in bytes.
+   */
+  static void Released(size_t size);
+};
+}  // namespace odbc
+}  // namespace documentdb
+
+/**
+ * Counts the allocations until the end of the enclosing block in the given
+ * AllocationTracker::Component. Expands to nothing unless the driver is built
+ * with WITH_ALLOCATION_TRACKING.
+ */
+#ifdef DOCUMENTDB_WITH_ALLOCATION_TRACKING
+#define DOCUMENTDB_ALLOCATION_SCOPE(component)                         \
+  documentdb::odbc::AllocationTracker::ComponentScope allocationScope( \
+      documentdb::odbc::AllocationTracker::Component::component)
+#else
+#define DOCUMENTDB_ALLOCATION_SCOPE(component) \
+  do {                                         \
+  } while (false)
+#endif  // DOCUMENTDB_WITH_ALLOCATION_TRACKING
+
+#endif  //_DOCUMENTDB_ODBC_ALLOCATION_TRACKER
@@ -0,0 +1,210 @@
+/*
+ * Copyright <2022> Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ */
+
+#ifndef _DOCUMENTDB_ODBC_ASYNC_LOG_WRITER
+#define _DOCUMENTDB_ODBC_ASYNC_LOG_WRITER
+
+#include <stdint.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "documentdb/odbc/common/common.h"
+#include "documentdb/odbc/common/concurrent.h"
+
+namespace documentdb {
+namespace odbc {
+/**
+ * Bounded lock-free queue of log records. Any number of threads can push;
+ * only one thread may pop.
+ */
+class LogRingBuffer {
+ public:
+  /**
+   * Constructor.
+   *
+   * @param capacity Number of records, rounded up to a power of two.
+   */
+  explicit LogRingBuffer(size_t capacity);
+
+  /**
+   * Append a record.
+   *
+   * @param record Record. Moved from if it was appended.
+   * @return @c true if the record was appended, @c false if the buffer is
+   *     full.
+   */
+  bool TryPush(std::string& record);
+
+  /**
+   * Remove the oldest record. Must only be called by the consumer thread.
+   *
+   * @param record Receives the record.
+   * @return @c true if a record was removed, @c false if the buffer is
+   *     empty.
+   */
+  bool TryPop(std::string& record);
+
+  /**
+   * Get the number of records the buffer holds.
+   *
+   * @return Capacity.
+   */
+  size_t GetCapacity() const {
+    return mask + 1;
+  }
+
+ private:
+  DOCUMENTDB_NO_COPY_ASSIGNMENT(LogRingBuffer);
+
+  /** Slot of the buffer. */
+  struct Cell {
+    /** Position the slot is ready for: pos to push, pos + 1 to pop. */
+    std::atomic< size_t > sequence;
+
+    /** Record. */
+    std::string record;
+  };
+
+  /** Slots. */
+  std::unique_ptr< Cell[] > cells;
+
+  /** Capacity minus one. */
+  size_t mask;
+
+  /** Keeps the positions on separate cache lines. */
+  char padding0[64];
+
+  /** Position of the next push. */
+  std::atomic< size_t > enqueuePos;
+
+  /** Keeps the positions on separate cache lines. */
+  char padding1[64];
+
+  /** Position of the next pop, only used by the consumer. */
+  size_t dequeuePos;
+};
+
+/**
+ * Writes log records from a background thread. Records are queued in a
+ * LogRingBuffer and handed over to the sink in batches; the sink is asked
+ * to flush at most once per flush interval.
+ */
+class AsyncLogWriter {
+ public:
+  /**
+   * Sink of the records. Called on the writer thread with a batch of
+   * records, possibly empty, and whether the output should be flushed.
+   */
+  typedef std::function< void(const std::vector< std::string >&, bool) >
+      Sink;
+
+  /**
+   * Constructor. Starts the writer thread.
+   *
+   * @param capacity Number of records that can be queued.
+   * @param flushInterval Time between flushes.
+   * @param sink Sink of the records.
+   */
+  AsyncLogWriter(size_t capacity, std::chrono::milliseconds flushInterval,
+                 Sink sink);
+
+  /**
+   * Destructor. Writes the queued records and stops the writer thread.
+   */
+  ~AsyncLogWriter();
+
+  /**
+   * Queue a record.
+   *
+   * @param record Record.
+   * @param block If the buffer is full, wait for room rather than drop the
+   *     record.
+   * @return @c true if the record was queued, @c false if it was dropped.
+   */
+  bool Push(const std::string& record, bool block);
+
+  /**
+   * Wait until the records queued so far are written, then flush.
+   */
+  void Flush();
+
+  /**
+   * Get the number of records dropped because the buffer was full.
+   *
+   * @return Dropped record count.
+   */
+  uint64_t GetDroppedCount() const {
+    return dropped;
+  }
+
+ private:
+  DOCUMENTDB_NO_COPY_ASSIGNMENT(AsyncLogWriter);
+
+  /**
+   * Writer thread body.
+   */
+  void Run();
+
+  /**
+   * Wake the writer thread up if it is waiting for records. Only called
+   * when the buffer is full, on flush and on stop, so pushing records does
+   * not take a lock.
+   */
+  void WakeUp();
+
+  /** Queued records. */
+  LogRingBuffer buffer;
+
+  /** Time between flushes. */
+  std::chrono::milliseconds flushInterval;
+
+  /** Sink of the records. */
+  Sink sink;
+
+  /** Set when the writer thread has to stop. */
+  std::atomic< bool > stopping{false};
+
+  /** Number of records queued. */
+  std::atomic< uint64_t > pushed{0};
+
+  /** Number of records handed over to the sink. */
+  std::atomic< uint64_t > written{0};
+
+  /** Number of records dropped. */
+  std::atomic< uint64_t > dropped{0};
+
+  /** Lock of the wake-up request. */
+  common::concurrent::CriticalSection wakeUpLock;
+
+  /** Signaled to wake the writer thread up. */
+  common::concurrent::ConditionVariable wakeUpCondition;
+
+  /** Whether the writer thread was asked to wake up. */
+  bool wakeUpRequested = false;
+
+  /** Writer thread. */
+  std::thread thread;
+};
+}  // namespace odbc
+}  // namespace documentdb
+
+#endif  //_DOCUMENTDB_ODBC_ASYNC_LOG_WRITER
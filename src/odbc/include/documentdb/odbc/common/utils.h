@@ -228,6 +228,16 @@ T1 LexicalCast(const T2& val) {
  */
 DOCUMENTDB_IMPORT_EXPORT bool AllDigits(const std::string& val);
 
+/**
+ * Append a string escaped for use as a JSON string value. The quotes around
+ * the value are not added.
+ *
+ * @param out String to append to.
+ * @param value String to escape.
+ */
+DOCUMENTDB_IMPORT_EXPORT void AppendEscapedJson(std::string& out,
+                                                const std::string& value);
+
 /**
  * Converts 32-bit integer to big endian format
  *
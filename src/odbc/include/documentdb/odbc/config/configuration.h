@@ -27,6 +27,7 @@
 #include "documentdb/odbc/diagnostic/diagnosable.h"
 #include "documentdb/odbc/odbc_error.h"
 #include "documentdb/odbc/log_level.h"
+#include "documentdb/odbc/read_concern.h"
 #include "documentdb/odbc/read_preference.h"
 #include "documentdb/odbc/scan_method.h"
 
@@ -36,6 +37,42 @@
 #define DRIVER_VERSION_MINOR PROJECT_VERSION_MINOR
 #define DRIVER_VERSION_PATCH PROJECT_VERSION_PATCH
 
+// Upper bound for the number of partitions of a parallel collection scan.
+#define MAX_PARALLEL_SCAN_PARTITIONS 64
+
+// Upper bound for the interval of the metrics file export, in seconds.
+#define MAX_METRICS_INTERVAL 3600
+
+// Upper bound for the number of diagnostic records kept for a statement.
+#define MAX_DIAG_RECORD_LIMIT 1000000
+
+// Upper bound for the slow query threshold, in milliseconds (one day).
+#define MAX_SLOW_QUERY_THRESHOLD_MS 86400000
+
+// Upper bound for the number of idle pooled connections per configuration.
+#define MAX_CONNECTION_POOL_SIZE 256
+
+// Upper bound for the idle timeout of pooled connections, in seconds.
+#define MAX_CONNECTION_POOL_IDLE_TIMEOUT 86400
+
+// Upper bound for the number of MongoDB clients of a connection.
+#define MAX_CLIENT_POOL_SIZE 1000
+
+// Upper bound for the number of attempts to restore a broken connection.
+#define MAX_RECONNECT_ATTEMPTS 10
+
+// Upper bound for the delay before a reconnect attempt, in milliseconds.
+#define MAX_RECONNECT_BACKOFF_MS 60000
+
+// Upper bound for the zlib compression level.
+#define MAX_ZLIB_COMPRESSION_LEVEL 9
+
+// Upper bound for the latency window of server selection, in milliseconds.
+#define MAX_LOCAL_THRESHOLD_MS 60000
+
+// Lower bound for the maximum staleness of a secondary, in seconds.
+#define MIN_MAX_STALENESS_SECONDS 90
+
 #define MONGO_URI_APPNAME "appName"
 #define MONGO_URI_AUTHMECHANISM "authMechanism"
 #define MONGO_URI_AUTHMECHANISMPROPERTIES "authMechanismProperties"
@@ -165,6 +202,15 @@ class Configuration {
     /** Default value for logPath attribute. */
     static const std::string logPath;
 
+    /** Default value for logAsync attribute. */
+    static const bool logAsync;
+
+    /** Default value for logOverflow attribute. */
+    static const std::string logOverflow;
+
+    /** Default value for logFormat attribute. */
+    static const std::string logFormat;
+
     /** Default value for scanMethod attribute. */
     static const ScanMethod::Type scanMethod;
 
@@ -179,6 +225,69 @@ class Configuration {
 
     /** Default value for defaultFetchSize attribute. */
     static const int32_t defaultFetchSize;
+
+    /** Default value for parallelScanPartitions attribute. */
+    static const int32_t parallelScanPartitions;
+
+    /** Default value for approximateCount attribute. */
+    static const bool approximateCount;
+
+    /** Default value for allowDiskUse attribute. */
+    static const bool allowDiskUse;
+
+    /** Default value for readConcern attribute. */
+    static const ReadConcern::Type readConcern;
+
+    /** Default value for comment attribute. */
+    static const std::string comment;
+
+    /** Default value for connectionPoolSize attribute. */
+    static const int32_t connectionPoolSize;
+
+    /** Default value for connectionPoolIdleTimeout attribute. */
+    static const int32_t connectionPoolIdleTimeout;
+
+    /** Default value for clientPoolSize attribute. */
+    static const int32_t clientPoolSize;
+
+    /** Default value for reconnectAttempts attribute. */
+    static const int32_t reconnectAttempts;
+
+    /** Default value for reconnectBackoffMs attribute. */
+    static const int32_t reconnectBackoffMs;
+
+    /** Default value for compressors attribute. */
+    static const std::string compressors;
+
+    /** Default value for zlibCompressionLevel attribute. */
+    static const int32_t zlibCompressionLevel;
+
+    /** Default value for analyticsRouting attribute. */
+    static const bool analyticsRouting;
+
+    /** Default value for localThresholdMs attribute. */
+    static const int32_t localThresholdMs;
+
+    /** Default value for poolPrewarmSize attribute. */
+    static const int32_t poolPrewarmSize;
+
+    /** Default value for warmUpSqlFile attribute. */
+    static const std::string warmUpSqlFile;
+
+    /** Default value for metricsPath attribute. */
+    static const std::string metricsPath;
+
+    /** Default value for metricsPort attribute. */
+    static const int32_t metricsPort;
+
+    /** Default value for metricsInterval attribute. */
+    static const int32_t metricsInterval;
+
+    /** Default value for diagRecordLimit attribute. */
+    static const int32_t diagRecordLimit;
+
+    /** Default value for slowQueryThresholdMs attribute. */
+    static const int32_t slowQueryThresholdMs;
   };
 
   /**
@@ -696,6 +805,70 @@ class Configuration {
    */
   bool IsLogPathSet() const;
 
+  /**
+   * Check if log records are written by a background thread.
+   *
+   * @return @c true if logging is asynchronous.
+   */
+  bool IsLogAsync() const;
+
+  /**
+   * Set asynchronous logging flag.
+   *
+   * @param logAsync Asynchronous logging flag.
+   */
+  void SetLogAsync(bool logAsync);
+
+  /**
+   * Check if the value set.
+   *
+   * @return @true if the value set.
+   */
+  bool IsLogAsyncSet() const;
+
+  /**
+   * Get what happens to a log record when the asynchronous log buffer is
+   * full.
+   *
+   * @return Overflow policy, "block" or "drop".
+   */
+  const std::string& GetLogOverflow() const;
+
+  /**
+   * Set the log buffer overflow policy.
+   *
+   * @param policy Overflow policy, "block" or "drop".
+   */
+  void SetLogOverflow(const std::string& policy);
+
+  /**
+   * Check if the value set.
+   *
+   * @return @true if the value set.
+   */
+  bool IsLogOverflowSet() const;
+
+  /**
+   * Get the format of the log records.
+   *
+   * @return Log format, "text" or "json".
+   */
+  const std::string& GetLogFormat() const;
+
+  /**
+   * Set the format of the log records.
+   *
+   * @param format Log format, "text" or "json".
+   */
+  void SetLogFormat(const std::string& format);
+
+  /**
+   * Check if the value set.
+   *
+   * @return @true if the value set.
+   */
+  bool IsLogFormatSet() const;
+
   /**
    * Get scan method.
    *
@@ -801,6 +974,467 @@ class Configuration {
    */
   bool IsDefaultFetchSizeSet() const;
 
+  /**
+   * Get number of partitions used for parallel collection scans.
+   *
+   * @return Number of partitions. Zero means parallel scans are disabled.
+   */
+  int32_t GetParallelScanPartitions() const;
+
+  /**
+   * Set number of partitions used for parallel collection scans.
+   *
+   * @param partitions Number of partitions.
+   */
+  void SetParallelScanPartitions(int32_t partitions);
+
+  /**
+   * Check if the value set.
+   *
+   * @return @true if the value set.
+   */
+  bool IsParallelScanPartitionsSet() const;
+
+  /**
+   * Get approximate count flag.
+   *
+   * @return @true if unfiltered COUNT(*) queries may use the collection
+   *     metadata estimate.
+   */
+  bool IsApproximateCount() const;
+
+  /**
+   * Set approximate count flag.
+   *
+   * @param val Value to set.
+   */
+  void SetApproximateCount(bool val);
+
+  /**
+   * Check if the value set.
+   *
+   * @return @true if the value set.
+   */
+  bool IsApproximateCountSet() const;
+
+  /**
+   * Get allow disk use flag.
+   *
+   * @return @true if aggregate stages may write temporary files.
+   */
+  bool IsAllowDiskUse() const;
+
+  /**
+   * Set allow disk use flag.
+   *
+   * @param val Value to set.
+   */
+  void SetAllowDiskUse(bool val);
+
+  /**
+   * Check if the value set.
+   *
+   * @return @true if the value set.
+   */
+  bool IsAllowDiskUseSet() const;
+
+  /**
+   * Get read concern level.
+   *
+   * @return Read concern level.
+   */
+  ReadConcern::Type GetReadConcern() const;
+
+  /**
+   * Set read concern level.
+   *
+   * @param level Read concern level.
+   */
+  void SetReadConcern(const ReadConcern::Type level);
+
+  /**
+   * Check if the value set.
+   *
+   * @return @true if the value set.
+   */
+  bool IsReadConcernSet() const;
+
+  /**
+   * Get the comment attached to the queries.
+   *
+   * @return Comment.
+   */
+  const std::string& GetComment() const;
+
+  /**
+   * Set the comment attached to the queries.
+   *
+   * @param comment Comment.
+   */
+  void SetComment(const std::string& comment);
+
+  /**
+   * Check if the value set.
+   *
+   * @return @true if the value set.
+   */
+  bool IsCommentSet() const;
+
+  /**
+   * Get maximum number of idle pooled connections for this configuration.
+   *
+   * @return Pool size. Zero means connection pooling is disabled.
+   */
+  int32_t GetConnectionPoolSize() const;
+
+  /**
+   * Set maximum number of idle pooled connections for this configuration.
+   *
+   * @param size Pool size.
+   */
+  void SetConnectionPoolSize(int32_t size);
+
+  /**
+   * Check if the value set.
+   *
+   * @return @true if the value set.
+   */
+  bool IsConnectionPoolSizeSet() const;
+
+  /**
+   * Get time an idle pooled connection is kept before it is closed.
+   *
+   * @return Idle timeout in seconds.
+   */
+  int32_t GetConnectionPoolIdleTimeout() const;
+
+  /**
+   * Set time an idle pooled connection is kept before it is closed.
+   *
+   * @param seconds Idle timeout in seconds.
+   */
+  void SetConnectionPoolIdleTimeout(int32_t seconds);
+
+  /**
+   * Check if the value set.
+   *
+   * @return @true if the value set.
+   */
+  bool IsConnectionPoolIdleTimeoutSet() const;
+
+  /**
+   * Get maximum number of MongoDB clients of a connection, which bounds the
+   * number of statements executing concurrently on the connection.
+   *
+   * @return Client pool size.
+   */
+  int32_t GetClientPoolSize() const;
+
+  /**
+   * Set maximum number of MongoDB clients of a connection.
+   *
+   * @param size Client pool size.
+   */
+  void SetClientPoolSize(int32_t size);
+
+  /**
+   * Check if the value set.
+   *
+   * @return @true if the value set.
+   */
+  bool IsClientPoolSizeSet() const;
+
+  /**
+   * Get number of attempts to restore a broken connection before a query
+   * fails.
+   *
+   * @return Number of attempts.
+   */
+  int32_t GetReconnectAttempts() const;
+
+  /**
+   * Set number of attempts to restore a broken connection.
+   *
+   * @param attempts Number of attempts.
+   */
+  void SetReconnectAttempts(int32_t attempts);
+
+  /**
+   * Check if the value set.
+   *
+   * @return @true if the value set.
+   */
+  bool IsReconnectAttemptsSet() const;
+
+  /**
+   * Get initial delay before an attempt to restore a broken connection. The
+   * delay doubles with each failed attempt.
+   *
+   * @return Delay in milliseconds.
+   */
+  int32_t GetReconnectBackoffMs() const;
+
+  /**
+   * Set initial delay before an attempt to restore a broken connection.
+   *
+   * @param milliseconds Delay in milliseconds.
+   */
+  void SetReconnectBackoffMs(int32_t milliseconds);
+
+  /**
+   * Check if the value set.
+   *
+   * @return @true if the value set.
+   */
+  bool IsReconnectBackoffMsSet() const;
+
+  /**
+   * Get wire compressors offered to the server, in order of preference, as
+   * a comma-separated list.
+   *
+   * @return Compressors.
+   */
+  const std::string& GetCompressors() const;
+
+  /**
+   * Set wire compressors offered to the server.
+   *
+   * @param compressors Comma-separated list of compressors.
+   */
+  void SetCompressors(const std::string& compressors);
+
+  /**
+   * Check if the value set.
+   *
+   * @return @true if the value set.
+   */
+  bool IsCompressorsSet() const;
+
+  /**
+   * Parse and normalize a comma-separated list of wire compressors.
+   *
+   * @param value List to parse.
+   * @param compressors Resulting list, lower case and without blanks.
+   * @return @c true if all compressors are supported.
+   */
+  static bool ParseCompressors(const std::string& value,
+                               std::string& compressors);
+
+  /**
+   * Get zlib compression level, from 0 (none) to 9 (best). -1 uses the zlib
+   * default level.
+   *
+   * @return Compression level.
+   */
+  int32_t GetZlibCompressionLevel() const;
+
+  /**
+   * Set zlib compression level.
+   *
+   * @param level Compression level.
+   */
+  void SetZlibCompressionLevel(int32_t level);
+
+  /**
+   * Check if the value set.
+   *
+   * @return @true if the value set.
+   */
+  bool IsZlibCompressionLevelSet() const;
+
+  /**
+   * Check if analytic queries are routed to secondaries.
+   *
+   * @return @c true if analytic queries are routed to secondaries.
+   */
+  bool IsAnalyticsRouting() const;
+
+  /**
+   * Set analytics routing flag.
+   *
+   * @param analyticsRouting Analytics routing flag.
+   */
+  void SetAnalyticsRouting(bool analyticsRouting);
+
+  /**
+   * Check if the value set.
+   *
+   * @return @true if the value set.
+   */
+  bool IsAnalyticsRoutingSet() const;
+
+  /**
+   * Get the latency window of server selection in milliseconds.
+   *
+   * @return Latency window in milliseconds.
+   */
+  int32_t GetLocalThresholdMs() const;
+
+  /**
+   * Set the latency window of server selection.
+   *
+   * @param milliseconds Latency window in milliseconds.
+   */
+  void SetLocalThresholdMs(int32_t milliseconds);
+
+  /**
+   * Check if the value set.
+   *
+   * @return @true if the value set.
+   */
+  bool IsLocalThresholdMsSet() const;
+
+  /**
+   * Get the number of connections opened in the background when the
+   * connection pool is first used.
+   *
+   * @return Number of pre-warmed connections.
+   */
+  int32_t GetPoolPrewarmSize() const;
+
+  /**
+   * Set the number of pre-warmed connections.
+   *
+   * @param size Number of pre-warmed connections.
+   */
+  void SetPoolPrewarmSize(int32_t size);
+
+  /**
+   * Check if the value set.
+   *
+   * @return @true if the value set.
+   */
+  bool IsPoolPrewarmSizeSet() const;
+
+  /**
+   * Get the path of the file of SQL statements translated when the pool is
+   * pre-warmed.
+   *
+   * @return Warm-up SQL file path.
+   */
+  const std::string& GetWarmUpSqlFile() const;
+
+  /**
+   * Set the warm-up SQL file path.
+   *
+   * @param path Warm-up SQL file path.
+   */
+  void SetWarmUpSqlFile(const std::string& path);
+
+  /**
+   * Check if the value set.
+   *
+   * @return @true if the value set.
+   */
+  bool IsWarmUpSqlFileSet() const;
+
+  /**
+   * Get the path of the file the driver metrics are written to.
+   *
+   * @return Metrics file path.
+   */
+  const std::string& GetMetricsPath() const;
+
+  /**
+   * Set the metrics file path.
+   *
+   * @param path Metrics file path.
+   */
+  void SetMetricsPath(const std::string& path);
+
+  /**
+   * Check if the value set.
+   *
+   * @return @true if the value set.
+   */
+  bool IsMetricsPathSet() const;
+
+  /**
+   * Get the localhost port the driver metrics are served on.
+   *
+   * @return Metrics port.
+   */
+  int32_t GetMetricsPort() const;
+
+  /**
+   * Set the metrics port.
+   *
+   * @param port Metrics port.
+   */
+  void SetMetricsPort(int32_t port);
+
+  /**
+   * Check if the value set.
+   *
+   * @return @true if the value set.
+   */
+  bool IsMetricsPortSet() const;
+
+  /**
+   * Get the interval, in seconds, of the metrics file export.
+   *
+   * @return Interval in seconds.
+   */
+  int32_t GetMetricsInterval() const;
+
+  /**
+   * Set the interval of the metrics file export.
+   *
+   * @param interval Interval in seconds.
+   */
+  void SetMetricsInterval(int32_t interval);
+
+  /**
+   * Check if the value set.
+   *
+   * @return @true if the value set.
+   */
+  bool IsMetricsIntervalSet() const;
+
+  /**
+   * Get the maximum number of diagnostic records kept for a statement.
+   *
+   * @return Maximum number of diagnostic records.
+   */
+  int32_t GetDiagRecordLimit() const;
+
+  /**
+   * Set the maximum number of diagnostic records kept for a statement.
+   *
+   * @param limit Maximum number of diagnostic records.
+   */
+  void SetDiagRecordLimit(int32_t limit);
+
+  /**
+   * Check if the value set.
+   *
+   * @return @true if the value set.
+   */
+  bool IsDiagRecordLimitSet() const;
+
+  /**
+   * Get the time, in milliseconds, above which a query is written to the
+   * slow query log.
+   *
+   * @return Threshold in milliseconds, 0 if the slow query log is disabled.
+   */
+  int32_t GetSlowQueryThresholdMs() const;
+
+  /**
+   * Set the time, in milliseconds, above which a query is written to the
+   * slow query log.
+   *
+   * @param threshold Threshold in milliseconds, 0 to disable the log.
+   */
+  void SetSlowQueryThresholdMs(int32_t threshold);
+
+  /**
+   * Check if the value set.
+   *
+   * @return @true if the value set.
+   */
+  bool IsSlowQueryThresholdMsSet() const;
+
   /**
    * Get argument map.
    *
@@ -870,6 +1504,15 @@ class Configuration {
    */
   void ToMongoCommonOptionsMap(ArgumentMap& res) const;
 
+  /**
+   * Get the argument map of the options that only apply to the native
+   * client: its pool, wire compression and server selection. They are not
+   * passed to the JDBC connection, which only carries metadata traffic.
+   *
+   * @param res Resulting argument map.
+   */
+  void ToMongoNativeOptionsMap(ArgumentMap& res) const;
+
   /** DSN. */
   SettableValue< std::string > dsn = DefaultValue::dsn;
 
@@ -948,6 +1591,15 @@ class Configuration {
   /** The logging file path. */
   SettableValue< std::string > logPath = DefaultValue::logPath;
 
+  /** Write log records from a background thread. */
+  SettableValue< bool > logAsync = DefaultValue::logAsync;
+
+  /** What happens to a log record when the log buffer is full. */
+  SettableValue< std::string > logOverflow = DefaultValue::logOverflow;
+
+  /** Format of the log records. */
+  SettableValue< std::string > logFormat = DefaultValue::logFormat;
+
   /** Scan method. */
   SettableValue< ScanMethod::Type > scanMethod = DefaultValue::scanMethod;
 
@@ -962,6 +1614,78 @@ class Configuration {
 
   /** Default fetch size. */
   SettableValue< int32_t > defaultFetchSize = DefaultValue::defaultFetchSize;
+
+  /** Number of partitions for parallel collection scans. */
+  SettableValue< int32_t > parallelScanPartitions =
+      DefaultValue::parallelScanPartitions;
+
+  /** Approximate count flag. */
+  SettableValue< bool > approximateCount = DefaultValue::approximateCount;
+
+  /** Allow disk use flag. */
+  SettableValue< bool > allowDiskUse = DefaultValue::allowDiskUse;
+
+  /** Read concern level. */
+  SettableValue< ReadConcern::Type > readConcern = DefaultValue::readConcern;
+
+  /** Comment attached to the queries. */
+  SettableValue< std::string > comment = DefaultValue::comment;
+
+  /** Maximum number of idle pooled connections. */
+  SettableValue< int32_t > connectionPoolSize =
+      DefaultValue::connectionPoolSize;
+
+  /** Idle timeout of pooled connections in seconds. */
+  SettableValue< int32_t > connectionPoolIdleTimeout =
+      DefaultValue::connectionPoolIdleTimeout;
+
+  /** Maximum number of MongoDB clients of a connection. */
+  SettableValue< int32_t > clientPoolSize = DefaultValue::clientPoolSize;
+
+  /** Number of attempts to restore a broken connection. */
+  SettableValue< int32_t > reconnectAttempts = DefaultValue::reconnectAttempts;
+
+  /** Initial delay before a reconnect attempt in milliseconds. */
+  SettableValue< int32_t > reconnectBackoffMs =
+      DefaultValue::reconnectBackoffMs;
+
+  /** Wire compressors offered to the server. */
+  SettableValue< std::string > compressors = DefaultValue::compressors;
+
+  /** Compression level of the zlib compressor. */
+  SettableValue< int32_t > zlibCompressionLevel =
+      DefaultValue::zlibCompressionLevel;
+
+  /** Route analytic queries to secondaries. */
+  SettableValue< bool > analyticsRouting = DefaultValue::analyticsRouting;
+
+  /** Latency window of server selection in milliseconds. */
+  SettableValue< int32_t > localThresholdMs = DefaultValue::localThresholdMs;
+
+  /** Number of connections opened in the background to fill the pool. */
+  SettableValue< int32_t > poolPrewarmSize = DefaultValue::poolPrewarmSize;
+
+  /** File of SQL statements translated when the pool is pre-warmed. */
+  SettableValue< std::string > warmUpSqlFile = DefaultValue::warmUpSqlFile;
+
+  /** File the driver metrics are written to. */
+  SettableValue< std::string > metricsPath = DefaultValue::metricsPath;
+
+  /** Localhost port the driver metrics are served on. */
+  SettableValue< int32_t > metricsPort = DefaultValue::metricsPort;
+
+  /** Interval of the metrics file export, in seconds. */
+  SettableValue< int32_t > metricsInterval = DefaultValue::metricsInterval;
+
+  /** Maximum number of diagnostic records kept for a statement. */
+  SettableValue< int32_t > diagRecordLimit = DefaultValue::diagRecordLimit;
+
+  /**
+   * Time above which a query is written to the slow query log, in
+   * milliseconds.
+   */
+  SettableValue< int32_t > slowQueryThresholdMs =
+      DefaultValue::slowQueryThresholdMs;
 };
 
 template <>
@@ -988,6 +1712,11 @@ void Configuration::AddToMap< ReadPreference::Type >(
     ArgumentMap& map, const std::string& key,
     const SettableValue< ReadPreference::Type >& value, bool isJdbcFormat);
 
+template <>
+void Configuration::AddToMap< ReadConcern::Type >(
+    ArgumentMap& map, const std::string& key,
+    const SettableValue< ReadConcern::Type >& value);
+
 template <>
 void Configuration::AddToMap< LogLevel::Type >(
     ArgumentMap& map, const std::string& key,
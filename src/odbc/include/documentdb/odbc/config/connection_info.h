@@ -24,6 +24,9 @@
 #include <stdint.h>
 
 #include <map>
+#include <string>
+#include <utility>
+#include <vector>
 
 // Missing definition in iODBC sqlext.h
 #if (ODBCVER >= 0x0300)
@@ -88,14 +91,50 @@ class ConnectionInfo {
   /** Associative array of unsigned short parameters. */
   typedef std::map< InfoType, unsigned short > UshortInfoMap;
 
-  /** String parameters. */
-  StringInfoMap strParams;
+  /** Table of parameters, sorted by info type. */
+  template < typename T >
+  using InfoTable = std::vector< std::pair< InfoType, T > >;
 
-  /** Integer parameters. */
-  UintInfoMap intParams;
+  /**
+   * Parameters that are the same for all connections.
+   */
+  struct StaticInfo {
+    /** String parameters. */
+    InfoTable< std::string > strParams;
+
+    /** Integer parameters. */
+    InfoTable< unsigned int > intParams;
+
+    /** Short parameters. */
+    InfoTable< unsigned short > shortParams;
+  };
+
+  /**
+   * Get the parameters that are the same for all connections.
+   *
+   * @return Process-wide parameters.
+   */
+  static const StaticInfo& GetStaticInfo();
+
+  /**
+   * Build the parameters that are the same for all connections.
+   *
+   * @return Parameters.
+   */
+  static StaticInfo BuildStaticInfo();
+
+  /**
+   * Find a parameter in a table.
+   *
+   * @param table Table.
+   * @param type Info type.
+   * @return Parameter value, or null if not found.
+   */
+  template < typename T >
+  static const T* FindInfo(const InfoTable< T >& table, InfoType type);
 
-  /** Short parameters. */
-  UshortInfoMap shortParams;
+  /** String parameters set for this connection, such as the user name. */
+  StringInfoMap runtimeParams;
 
   /** Configuration. */
   const Configuration& config;
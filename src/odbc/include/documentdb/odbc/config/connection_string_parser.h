@@ -105,6 +105,15 @@ class ConnectionStringParser {
     /** Connection attribute keyword for log path. */
     static const std::string logPath;
 
+    /** Connection attribute keyword for logAsync attribute. */
+    static const std::string logAsync;
+
+    /** Connection attribute keyword for logOverflow attribute. */
+    static const std::string logOverflow;
+
+    /** Connection attribute keyword for logFormat attribute. */
+    static const std::string logFormat;
+
     /** Connection attribute keyword for scanMethod attribute. */
     static const std::string scanMethod;
 
@@ -120,6 +129,70 @@ class ConnectionStringParser {
     /** Connection attribute keyword for defaultFetchSize attribute. */
     static const std::string defaultFetchSize;
 
+    /** Connection attribute keyword for parallelScanPartitions attribute. */
+    static const std::string parallelScanPartitions;
+
+    /** Connection attribute keyword for approximateCount attribute. */
+    static const std::string approximateCount;
+
+    /** Connection attribute keyword for allowDiskUse attribute. */
+    static const std::string allowDiskUse;
+
+    /** Connection attribute keyword for readConcern attribute. */
+    static const std::string readConcern;
+
+    /** Connection attribute keyword for comment attribute. */
+    static const std::string comment;
+
+    /** Connection attribute keyword for connectionPoolSize attribute. */
+    static const std::string connectionPoolSize;
+
+    /** Connection attribute keyword for connectionPoolIdleTimeout attribute.
+     */
+    static const std::string connectionPoolIdleTimeout;
+
+    /** Connection attribute keyword for clientPoolSize attribute. */
+    static const std::string clientPoolSize;
+
+    /** Connection attribute keyword for reconnectAttempts attribute. */
+    static const std::string reconnectAttempts;
+
+    /** Connection attribute keyword for reconnectBackoffMs attribute. */
+    static const std::string reconnectBackoffMs;
+
+    /** Connection attribute keyword for compressors attribute. */
+    static const std::string compressors;
+
+    /** Connection attribute keyword for zlibCompressionLevel attribute. */
+    static const std::string zlibCompressionLevel;
+
+    /** Connection attribute keyword for analyticsRouting attribute. */
+    static const std::string analyticsRouting;
+
+    /** Connection attribute keyword for localThresholdMs attribute. */
+    static const std::string localThresholdMs;
+
+    /** Connection attribute keyword for poolPrewarmSize attribute. */
+    static const std::string poolPrewarmSize;
+
+    /** Connection attribute keyword for warmUpSqlFile attribute. */
+    static const std::string warmUpSqlFile;
+
+    /** Connection attribute keyword for metricsPath attribute. */
+    static const std::string metricsPath;
+
+    /** Connection attribute keyword for metricsPort attribute. */
+    static const std::string metricsPort;
+
+    /** Connection attribute keyword for metricsInterval attribute. */
+    static const std::string metricsInterval;
+
+    /** Connection attribute keyword for diagRecordLimit attribute. */
+    static const std::string diagRecordLimit;
+
+    /** Connection attribute keyword for slowQueryThresholdMs attribute. */
+    static const std::string slowQueryThresholdMs;
+
     /** Connection attribute keyword for sslMode attribute. */
     static const std::string sslMode;
 
@@ -206,6 +279,24 @@ class ConnectionStringParser {
    */
   static BoolParseResult::Type StringToBool(const std::string& value);
 
+  /**
+   * Convert string to integer value within the given range.
+   *
+   * @param name Attribute name used in the diagnostic messages.
+   * @param key Key.
+   * @param value Value to convert to integer.
+   * @param minValue Minimum allowed value.
+   * @param maxValue Maximum allowed value.
+   * @param res Resulting value.
+   * @param diag Diagnostics collector.
+   * @return @c true on success. On failure, a diagnostic record is added and
+   *     the default value should be kept.
+   */
+  static bool StringToInt(const std::string& name, const std::string& key,
+                          const std::string& value, int64_t minValue,
+                          int64_t maxValue, int32_t& res,
+                          diagnostic::DiagnosticRecordStorage* diag);
+
   /**
    * Convert string to boolean value.
    *
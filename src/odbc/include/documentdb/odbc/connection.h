@@ -21,6 +21,7 @@
 #include <documentdb/odbc/common/concurrent.h>
 #include <stdint.h>
 
+#include <atomic>
 #include <vector>
 
 #include "documentdb/odbc/config/configuration.h"
@@ -35,8 +36,12 @@
 #include "documentdb/odbc/log.h"
 #include "documentdb/odbc/odbc_error.h"
 #include "documentdb/odbc/parser.h"
+#include "documentdb/odbc/server_capabilities.h"
 #include "documentdb/odbc/streaming/streaming_context.h"
+#include "documentdb/odbc/wire_statistics.h"
 #include "mongocxx/client.hpp"
+#include "mongocxx/exception/exception.hpp"
+#include "mongocxx/pool.hpp"
 
 using documentdb::odbc::common::concurrent::SharedPointer;
 using documentdb::odbc::jni::DatabaseMetaData;
@@ -181,6 +186,12 @@ class Connection : public diagnostic::DiagnosableAdapter {
    */
   const config::Configuration& GetConfiguration() const;
 
+  /**
+   * Get the connection id the log records of the API calls are tagged with.
+   *
+   * @return Connection id.
+   */
+  virtual uint64_t GetLogConnectionId() const;
 
   /**
    * Create diagnostic record associated with the Connection instance.
@@ -257,9 +268,70 @@ class Connection : public diagnostic::DiagnosableAdapter {
    */
   void SetAttribute(int attr, void* value, SQLINTEGER valueLen);
 
-  inline std::shared_ptr< mongocxx::client >& GetMongoClient() {
-    return mongoClient_;
-  }
+  /**
+   * Take a MongoDB client from the connection client pool. The client is
+   * returned to the pool when the last reference to it is released, so a
+   * query keeps it for the life of its cursor. Clients are not thread-safe,
+   * but clients of the pool can be used concurrently by different threads.
+   * Waits while all clients of the pool are in use, up to the timeout.
+   *
+   * @param timeout Longest wait in seconds, or zero for the default of 30
+   *     seconds.
+   * @return Client.
+   * @throw mongocxx::exception on failure, see IsClientPoolTimeout.
+   */
+  std::shared_ptr< mongocxx::client > AcquireMongoClient(int32_t timeout = 0);
+
+  /**
+   * Get the capabilities of the server. They are fetched from the server
+   * only if not in the process-wide cache yet.
+   *
+   * @param caps Resulting capabilities.
+   * @return @c true on success.
+   */
+  bool GetServerCapabilities(ServerCapabilities& caps);
+
+  /**
+   * Create a new MongoDB client with the same settings as the clients of
+   * this connection, outside of the connection client pool. Used by worker
+   * threads of a query that already holds a pooled client, so they never
+   * wait on the pool.
+   *
+   * @return New client.
+   * @throw mongocxx::exception on failure.
+   */
+  std::shared_ptr< mongocxx::client > CreateMongoClient() const;
+
+  /**
+   * Restore the connection to the server after the transport was lost, e.g.
+   * on a failover. Only the broken transport is re-established: the JNI
+   * context, the schema and the translation state are kept. The attempts
+   * are spaced with a jittered exponential backoff. Only the initial
+   * aggregate of a query is retried: the rows of an open cursor cannot be
+   * resumed, so a getMore that fails is reported to the application.
+   *
+   * @param err Error of the last attempt on failure.
+   * @return @c true if the connection is usable again.
+   */
+  bool Reconnect(DocumentDbError& err);
+
+  /**
+   * Check if an error means that no client of the connection client pool
+   * was released before the timeout of AcquireMongoClient.
+   *
+   * @param xcp Error.
+   * @return @c true if the client pool is exhausted.
+   */
+  static bool IsClientPoolTimeout(const mongocxx::exception& xcp);
+
+  /**
+   * Check if an error means that the transport to the server was lost, as
+   * opposed to an error of the command itself.
+   *
+   * @param xcp Error.
+   * @return @c true if the connection should be restored.
+   */
+  static bool IsTransportError(const mongocxx::exception& xcp);
 
  private:
   DOCUMENTDB_NO_COPY_ASSIGNMENT(Connection);
@@ -465,26 +537,76 @@ class Connection : public diagnostic::DiagnosableAdapter {
    */
   bool TryRestoreConnection(DocumentDbError& err);
 
+  /**
+   * Open the JDBC connection.
+   *
+   * @param config Configuration of the JDBC connection. Goes through the
+   *     shared SSH tunnel rather than the configured one, if any.
+   * @param err Error.
+   * @return @c true on success and @c false otherwise.
+   */
+  bool OpenJdbcConnection(const config::Configuration& config,
+                          DocumentDbError& err);
+
   /**
    * Connect to DocumentDB using Mongo cxx driver
    *
    * @param localSSHTunnelPort internal SSH tunnel port
+   * @param ping @c true to establish and check the connection now, @c false
+   *     to leave it to the first command.
    * @param err
    * @return @c true on success and @c false otherwise.
    */
-  bool ConnectCPPDocumentDB(int32_t localSSHTunnelPort, DocumentDbError& err);
+  bool ConnectCPPDocumentDB(int32_t localSSHTunnelPort, bool ping,
+                            DocumentDbError& err);
 
   /**
-   * Helper function to get internall SSH tunnel Port
+   * Take a live connection of the same configuration from the environment
+   * connection pool, if pooling is enabled.
    *
-   * @param localSSHTunnelPort internal SSH tunnel port
-   * @param ctx java context
-   * @param err
-   * @return bool
+   * @return @c true if a pooled connection is now used.
+   */
+  bool TryCheckoutPooledConnection();
+
+  /**
+   * Return the connection to the environment connection pool instead of
+   * closing it, if pooling is enabled.
+   *
+   * @return @c true if the connection was pooled.
+   */
+  bool TryReturnToPool();
+
+  /**
+   * Release the reference to the shared SSH tunnel, if any.
+   */
+  void ReleaseSshTunnel();
+
+  /**
+   * Replace the shared SSH tunnel after it stopped forwarding connections.
+   *
+   * @param localSSHTunnelPort Resulting local port of the new tunnel.
+   * @param err Error.
+   * @return @c true on success.
+   */
+  bool ReacquireSshTunnel(int32_t& localSSHTunnelPort, DocumentDbError& err);
+
+  /**
+   * Make one attempt to re-establish the broken transports. If the native
+   * connection cannot be re-established through the shared SSH tunnel, the
+   * tunnel is replaced.
+   *
+   * @param err Error.
+   * @return @c true on success.
    */
-  bool GetInternalSSHTunnelPort(int32_t& localSSHTunnelPort,
-                                SharedPointer< jni::java::JniContext > ctx,
-                                DocumentDbError& err);
+  bool RestoreTransport(DocumentDbError& err);
+
+  /**
+   * Get the local port of the internal SSH tunnel. Safe to call while a
+   * reconnect replaces the tunnel.
+   *
+   * @return Local port, or zero if not used.
+   */
+  int32_t GetLocalSSHTunnelPort() const;
 
   /**
    * Creates JVM options
@@ -525,6 +647,9 @@ class Connection : public diagnostic::DiagnosableAdapter {
   /** Configuration. */
   config::Configuration config_;
 
+  /** Connection id, unique in the process. */
+  uint64_t id_;
+
   /** Connection info. */
   config::ConnectionInfo info_;
 
@@ -533,7 +658,39 @@ class Connection : public diagnostic::DiagnosableAdapter {
 
   SharedPointer< JniContext > jniContext_;
 
-  std::shared_ptr< mongocxx::client > mongoClient_;
+  /** MongoDB client pool. */
+  std::shared_ptr< mongocxx::pool > mongoPool_;
+
+  /** Local port of the internal SSH tunnel, or zero if not used. */
+  int32_t localSSHTunnelPort_ = 0;
+
+  /** Key of the shared SSH tunnel, or empty if not used. */
+  std::string sshTunnelKey_;
+
+  /**
+   * Guards the MongoDB client pool and the local port of the SSH tunnel
+   * while they are replaced.
+   */
+  mutable common::concurrent::CriticalSection transportLock_;
+
+  /** Serializes reconnects of concurrent statements. */
+  common::concurrent::CriticalSection reconnectLock_;
+
+  /** Number of failed reconnects in a row, which scales the backoff. */
+  int32_t reconnectFailuresInRow_ = 0;
+
+  /** Number of reconnect attempts. */
+  std::atomic< uint32_t > reconnectAttempts_{0};
+
+  /** Number of reconnects that failed after all their attempts. */
+  std::atomic< uint32_t > reconnectFailures_{0};
+
+  /** Total time spent reconnecting in milliseconds. */
+  std::atomic< uint32_t > reconnectTimeMs_{0};
+
+  /** Wire traffic counters, shared with the monitoring callbacks. */
+  std::shared_ptr< WireStatistics > wireStatistics_ =
+      std::make_shared< WireStatistics >();
 
   /** JVM options */
   std::vector< char* > opts_;
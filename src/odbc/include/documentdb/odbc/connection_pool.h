@@ -0,0 +1,174 @@
+/*
+ * Copyright <2022> Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ */
+
+
+#ifndef _DOCUMENTDB_ODBC_CONNECTION_POOL
+#define _DOCUMENTDB_ODBC_CONNECTION_POOL
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "documentdb/odbc/common/common.h"
+#include "documentdb/odbc/common/concurrent.h"
+#include "documentdb/odbc/config/configuration.h"
+#include "documentdb/odbc/jni/documentdb_connection.h"
+#include "documentdb/odbc/jni/java.h"
+#include "documentdb/odbc/wire_statistics.h"
+#include "mongocxx/pool.hpp"
+
+namespace documentdb {
+namespace odbc {
+/**
+ * Pool of idle established connections, owned by the environment.
+ *
+ * Connections are pooled per configuration. Pooled connections keep their
+ * JDBC connection (and SSH tunnel, if any) and MongoDB clients open, so a new
+ * connection with the same configuration skips authentication and the
+ * schema load.
+ */
+class ConnectionPool {
+ public:
+  /**
+   * Established connection.
+   */
+  struct Entry {
+    /** JNI context of the JDBC connection. */
+    common::concurrent::SharedPointer< jni::java::JniContext > jniContext;
+
+    /** JDBC connection. */
+    common::concurrent::SharedPointer< jni::DocumentDbConnection > connection;
+
+    /** MongoDB client pool. */
+    std::shared_ptr< mongocxx::pool > mongoPool;
+
+    /** Local port of the internal SSH tunnel, or zero if not used. */
+    int32_t localSSHTunnelPort = 0;
+
+    /** Key of the shared SSH tunnel, or empty if not used. */
+    std::string sshTunnelKey;
+
+    /** Wire traffic counters updated by the clients of the pool. */
+    std::shared_ptr< WireStatistics > wireStatistics;
+  };
+
+  /**
+   * Constructor.
+   */
+  ConnectionPool() = default;
+
+  /**
+   * Destructor. Closes all idle connections.
+   */
+  ~ConnectionPool();
+
+  /**
+   * Make the pool key of a configuration. The key holds every connection
+   * option except the DSN name, the password and the login timeout, which
+   * only applies while the connection is opened. The user name and the
+   * password are only included as a hash, so that connections of different
+   * credentials never share an entry.
+   *
+   * @param config Configuration.
+   * @return Pool key.
+   */
+  static std::string MakeKey(const config::Configuration& config);
+
+  /**
+   * Take the most recently returned idle connection of the key. Expired
+   * connections are closed. The caller must check that the connection is
+   * still alive.
+   *
+   * @param key Pool key.
+   * @param entry Resulting connection.
+   * @return @c true if a connection was taken.
+   */
+  bool Checkout(const std::string& key, Entry& entry);
+
+  /**
+   * Return a connection to the pool.
+   *
+   * @param key Pool key.
+   * @param entry Connection.
+   * @param maxSize Maximum number of idle connections of the key.
+   * @param idleTimeout Time in seconds the connection is kept idle.
+   * @return @c true if the connection was pooled, @c false if the pool is
+   *     full and the caller keeps ownership.
+   */
+  bool Return(const std::string& key, const Entry& entry, int32_t maxSize,
+              int32_t idleTimeout);
+
+  /**
+   * Close an established connection.
+   *
+   * @param entry Connection.
+   */
+  static void Close(Entry& entry);
+
+  /**
+   * Get the number of idle connections of the key.
+   *
+   * @param key Pool key.
+   * @return Number of idle connections.
+   */
+  size_t GetIdleCount(const std::string& key);
+
+  /**
+   * Close all idle connections.
+   */
+  void Clear();
+
+ private:
+  DOCUMENTDB_NO_COPY_ASSIGNMENT(ConnectionPool);
+
+  /** Clock type. */
+  typedef std::chrono::steady_clock Clock;
+
+  /**
+   * Idle connection.
+   */
+  struct IdleEntry {
+    /** Connection. */
+    Entry entry;
+
+    /** Time the connection expires at. */
+    Clock::time_point expires;
+  };
+
+  /** Idle connections of a key, the most recently returned last. */
+  typedef std::vector< IdleEntry > IdleList;
+
+  /**
+   * Move the expired connections out of the pool.
+   * Must be called under the lock.
+   *
+   * @param now Current time.
+   * @param expired Resulting expired connections.
+   */
+  void TakeExpired(Clock::time_point now, std::vector< Entry >& expired);
+
+  /** Lock. */
+  common::concurrent::CriticalSection lock;
+
+  /** Idle connections by key. */
+  std::map< std::string, IdleList > idle;
+};
+}  // namespace odbc
+}  // namespace documentdb
+
+#endif  //_DOCUMENTDB_ODBC_CONNECTION_POOL
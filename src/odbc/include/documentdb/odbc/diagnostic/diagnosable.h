@@ -63,6 +63,18 @@ class Diagnosable {
                                const std::string& message, int32_t rowNum,
                                int32_t columnNum) = 0;
 
+  /**
+   * Add new status record. The message is only copied if a new record is
+   * stored, not when the occurrence is merged or dropped.
+   *
+   * @param sqlState SQL state.
+   * @param message Message.
+   * @param rowNum Associated row number.
+   * @param columnNum Associated column number.
+   */
+  virtual void AddStatusRecord(SqlState::Type sqlState, const char* message,
+                               int32_t rowNum, int32_t columnNum) = 0;
+
   /**
    * Add new status record.
    *
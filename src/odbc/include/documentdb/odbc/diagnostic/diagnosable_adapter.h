@@ -18,11 +18,16 @@
 #ifndef _DOCUMENTDB_ODBC_DIAGNOSTIC_DIAGNOSABLE_ADAPTER
 #define _DOCUMENTDB_ODBC_DIAGNOSTIC_DIAGNOSABLE_ADAPTER
 
+#include <stdint.h>
+
 #include "documentdb/odbc/diagnostic/diagnosable.h"
+#include "documentdb/odbc/log.h"
 
-#define DOCUMENTDB_ODBC_API_CALL(...)         \
-  diagnosticRecords.Reset();              \
-  SqlResult::Type result = (__VA_ARGS__); \
+#define DOCUMENTDB_ODBC_API_CALL(...)                                      \
+  documentdb::odbc::Logger::ContextScope logContext(GetLogConnectionId(), \
+                                                    GetLogStatementId()); \
+  diagnosticRecords.Reset();                                              \
+  SqlResult::Type result = (__VA_ARGS__);                                 \
   diagnosticRecords.SetHeaderRecord(result)
 
 #define DOCUMENTDB_ODBC_API_CALL_ALWAYS_SUCCESS \
@@ -88,6 +93,18 @@ class DiagnosableAdapter : public Diagnosable {
                                const std::string& message, int32_t rowNum,
                                int32_t columnNum);
 
+  /**
+   * Add new status record. The message is only copied if a new record is
+   * stored, not when the occurrence is merged or dropped.
+   *
+   * @param sqlState SQL state.
+   * @param message Message.
+   * @param rowNum Associated row number.
+   * @param columnNum Associated column number.
+   */
+  virtual void AddStatusRecord(SqlState::Type sqlState, const char* message,
+                               int32_t rowNum, int32_t columnNum);
+
   /**
    * Add new status record.
    *
@@ -118,6 +135,24 @@ class DiagnosableAdapter : public Diagnosable {
    */
   virtual void AddStatusRecord(const DiagnosticRecord& rec);
 
+  /**
+   * Get the connection id the log records of the API calls are tagged with.
+   *
+   * @return Connection id, 0 if none.
+   */
+  virtual uint64_t GetLogConnectionId() const {
+    return 0;
+  }
+
+  /**
+   * Get the statement id the log records of the API calls are tagged with.
+   *
+   * @return Statement id, 0 if none.
+   */
+  virtual uint64_t GetLogStatementId() const {
+    return 0;
+  }
+
  protected:
   /** Diagnostic records. */
   DiagnosticRecordStorage diagnosticRecords;
@@ -79,6 +79,10 @@ class DiagnosticRecord {
   /**
    * Get record message text.
    *
+   * The text of a record that merges several occurrences is formatted on
+   * the first call and ends with the number of occurrences and the range
+   * of rows.
+   *
    * @return An informational message on the error or warning.
    */
   const std::string& GetMessageText() const;
@@ -106,6 +110,13 @@ class DiagnosticRecord {
    */
   const std::string& GetSqlState() const;
 
+  /**
+   * Get SQL state code of the record.
+   *
+   * @return SQL state code.
+   */
+  SqlState::Type GetSqlStateCode() const;
+
   /**
    * Get row number.
    *
@@ -124,6 +135,27 @@ class DiagnosticRecord {
    */
   int32_t GetColumnNumber() const;
 
+  /**
+   * Get the row number of the last merged occurrence.
+   *
+   * @return Row number of the last occurrence.
+   */
+  int32_t GetLastRowNumber() const;
+
+  /**
+   * Get the number of occurrences merged into the record.
+   *
+   * @return Number of occurrences.
+   */
+  int64_t GetOccurrences() const;
+
+  /**
+   * Merge another occurrence of the same condition into the record.
+   *
+   * @param rowNum Row number of the occurrence.
+   */
+  void AddOccurrence(int32_t rowNum);
+
   /**
    * Check if the record was retrieved with the SQLError previously.
    *
@@ -168,6 +200,15 @@ class DiagnosticRecord {
    */
   int32_t columnNum;
 
+  /** Row number of the last merged occurrence. */
+  int32_t lastRowNum;
+
+  /** Number of occurrences merged into the record. */
+  int64_t occurrences;
+
+  /** Message text with the occurrences, formatted on demand. */
+  mutable std::string formattedMessage;
+
   /**
    * Flag that shows if the record was retrieved with the
    * SQLError previously.
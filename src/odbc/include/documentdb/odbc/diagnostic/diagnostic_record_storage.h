@@ -21,6 +21,8 @@
 #include <documentdb/odbc/common/common.h>
 #include <stdint.h>
 
+#include <map>
+#include <utility>
 #include <vector>
 
 #include "documentdb/odbc/app/application_data_buffer.h"
@@ -37,14 +39,19 @@ namespace diagnostic {
  * descriptor handle are diagnostic records. These records contain
  * diagnostic information about the last function called that used
  * a particular handle. The records are replaced only when another
- * function is called using that handle. There is no limit to the
- * number of diagnostic records that can be stored at any one time.
+ * function is called using that handle. The records of the same
+ * SQLSTATE and column, such as the truncation warnings of a bulk
+ * fetch, are merged into one record, and the number of records that
+ * can be stored at any one time is limited.
  *
  * This class provides interface for interaction with all handle
  * diagnostic records. That means both header and status records.
  */
 class DiagnosticRecordStorage {
  public:
+  /** Default maximum number of status records. */
+  static const int32_t DEFAULT_RECORD_LIMIT;
+
   /**
    * Default constructor.
    */
@@ -77,6 +84,44 @@ class DiagnosticRecordStorage {
    */
   void AddStatusRecord(const DiagnosticRecord& record);
 
+  /**
+   * Merge an occurrence into the existing status record of the same SQL
+   * state and column, or drop it if it is a warning and the record limit is
+   * reached. Errors are stored beyond the limit.
+   *
+   * Lets the caller skip building a record that would not be stored.
+   *
+   * @param sqlState SQL state.
+   * @param rowNum Associated row number.
+   * @param columnNum Associated column number.
+   * @return True if the occurrence was merged or dropped, false if it
+   *  needs a new status record.
+   */
+  bool MergeStatusRecord(SqlState::Type sqlState, int32_t rowNum,
+                         int32_t columnNum);
+
+  /**
+   * Set the maximum number of status records.
+   *
+   * @param limit Maximum number of status records.
+   */
+  void SetRecordLimit(int32_t limit);
+
+  /**
+   * Get the maximum number of status records.
+   *
+   * @return Maximum number of status records.
+   */
+  int32_t GetRecordLimit() const;
+
+  /**
+   * Get the number of status records dropped since the last reset
+   * because the record limit was reached.
+   *
+   * @return Number of dropped status records.
+   */
+  int64_t GetDroppedRecordsNumber() const;
+
   /**
    * Reset diagnostic records state.
    */
@@ -179,6 +224,16 @@ class DiagnosticRecordStorage {
  private:
   DOCUMENTDB_NO_COPY_ASSIGNMENT(DiagnosticRecordStorage);
 
+  /** Key of a status record associated with a column. */
+  typedef std::pair< SqlState::Type, int32_t > ColumnRecordKey;
+
+  /**
+   * Count an error occurrence in the driver metrics.
+   *
+   * @param record Status record.
+   */
+  static void CountError(const DiagnosticRecord& record);
+
   /**
    * Header record field. This field contains the count of rows
    * in the cursor.
@@ -211,6 +266,15 @@ class DiagnosticRecordStorage {
 
   /** Status records. */
   std::vector< DiagnosticRecord > statusRecords;
+
+  /** Index of the status records associated with a column. */
+  std::map< ColumnRecordKey, size_t > columnRecords;
+
+  /** Maximum number of status records. */
+  int32_t recordLimit;
+
+  /** Number of status records dropped since the last reset. */
+  int64_t droppedRecords;
 };
 }  // namespace diagnostic
 }  // namespace odbc
@@ -23,8 +23,12 @@
 #include <map>
 #include <memory>
 
+#include <boost/optional.hpp>
+
 #include "documentdb/odbc/common_types.h"
 #include "documentdb/odbc/result_page.h"
+#include "documentdb/odbc/documentdb_error.h"
+#include "documentdb/odbc/documentdb_partitioned_scan.h"
 #include "documentdb/odbc/documentdb_row.h"
 #include "mongocxx/client.hpp"
 #include "mongocxx/cursor.hpp"
@@ -44,6 +48,28 @@ class DocumentDbCursor {
                    std::vector< JdbcColumnMetadata >& columnMetadata,
                    std::vector< std::string >& paths);
 
+  /**
+   * Constructor for the results of a partitioned scan.
+   *
+   * @param scan Started partitioned scan.
+   * @param columnMetadata Column metadata.
+   * @param paths Document path of each column.
+   */
+  DocumentDbCursor(std::unique_ptr< DocumentDbPartitionedScan > scan,
+                   std::vector< JdbcColumnMetadata >& columnMetadata,
+                   std::vector< std::string >& paths);
+
+  /**
+   * Constructor for a result computed by the driver, made of a single row.
+   *
+   * @param document Document of the single row.
+   * @param columnMetadata Column metadata.
+   * @param paths Document path of each column.
+   */
+  DocumentDbCursor(bsoncxx::document::value document,
+                   std::vector< JdbcColumnMetadata >& columnMetadata,
+                   std::vector< std::string >& paths);
+
   /**
    * Destructor.
    */
@@ -71,17 +97,25 @@ class DocumentDbCursor {
    */
   DocumentDbRow* GetRow();
 
+  /**
+   * Get the error which ended the iteration, if any.
+   *
+   * @param error Resulting error.
+   * @return @c true if the iteration ended with an error.
+   */
+  bool GetError(DocumentDbError& error) const;
+
  private:
   DOCUMENTDB_NO_COPY_ASSIGNMENT(DocumentDbCursor);
 
   /** The resulting cursor to query/aggregate call */
-  mongocxx::cursor cursor_;
+  std::unique_ptr< mongocxx::cursor > cursor_;
 
   /** The iterator to beginning of cursor */
-  mongocxx::cursor::iterator iterator_;
+  boost::optional< mongocxx::cursor::iterator > iterator_;
 
   /** The iterator to end of cursor */
-  mongocxx::cursor::iterator iteratorEnd_;
+  boost::optional< mongocxx::cursor::iterator > iteratorEnd_;
 
   /** The column metadata */
   std::vector< JdbcColumnMetadata > columnMetadata_;
@@ -94,6 +128,18 @@ class DocumentDbCursor {
 
   // Is this the first row of the iterator?
   bool isFirstRow_ = true;
+
+  /** The partitioned scan, used instead of the cursor when set */
+  std::unique_ptr< DocumentDbPartitionedScan > scan_;
+
+  /** The document owned by the cursor for the current row */
+  std::unique_ptr< bsoncxx::document::value > currentDocument_;
+
+  /** Whether the partitioned scan is exhausted */
+  bool scanExhausted_ = false;
+
+  /** Whether the result is the single document held by the cursor */
+  bool singleDocument_ = false;
 };
 }  // namespace odbc
 }  // namespace documentdb
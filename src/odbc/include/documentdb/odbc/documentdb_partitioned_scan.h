@@ -0,0 +1,192 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _DOCUMENTDB_ODBC_DOCUMENTDB_PARTITIONED_SCAN
+#define _DOCUMENTDB_ODBC_DOCUMENTDB_PARTITIONED_SCAN
+
+#include <stdint.h>
+
+#include <bsoncxx/document/value.hpp>
+#include <deque>
+#include <memory>
+#include <mongocxx/collection.hpp>
+#include <mongocxx/options/aggregate.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "documentdb/odbc/common/common.h"
+#include "documentdb/odbc/common/concurrent.h"
+#include "documentdb/odbc/documentdb_error.h"
+
+namespace documentdb {
+namespace odbc {
+/** Connection forward-declaration. */
+class Connection;
+
+/**
+ * Parallel scan of a collection split into ranges of _id.
+ *
+ * Each range runs the same aggregate pipeline, prefixed with a $match on the
+ * range, on its own worker thread and MongoDB client. Result documents are
+ * pushed into a bounded queue from which the consumer pulls them in no
+ * particular order.
+ */
+class DocumentDbPartitionedScan {
+ public:
+  /**
+   * Constructor.
+   *
+   * @param connection Connection used to create a client per worker.
+   * @param databaseName Database name.
+   * @param collectionName Collection name.
+   * @param stages Aggregate pipeline stages in JSON format.
+   * @param options Aggregate options applied to each partition.
+   * @param queueCapacity Maximum number of buffered documents.
+   */
+  DocumentDbPartitionedScan(const Connection& connection,
+                            const std::string& databaseName,
+                            const std::string& collectionName,
+                            const std::vector< std::string >& stages,
+                            const mongocxx::options::aggregate& options,
+                            size_t queueCapacity);
+
+  /**
+   * Destructor. Cancels and joins the workers.
+   */
+  ~DocumentDbPartitionedScan();
+
+  /**
+   * Check if the pipeline returns documents in an order-independent way
+   * and so can be split into partitions.
+   *
+   * @param stages Aggregate pipeline stages in JSON format.
+   * @return @c true if the pipeline can be partitioned.
+   */
+  static bool IsPartitionable(const std::vector< std::string >& stages);
+
+  /**
+   * Compute the partition boundaries by sampling _id values and start the
+   * workers. The partitions are ObjectId ranges of _id, plus one partition
+   * for the _id values of the other types.
+   *
+   * @param collection Collection to sample the boundaries from.
+   * @param partitions Requested number of partitions.
+   * @return @c true if the scan started. @c false if the collection could
+   *     not be split, in which case the caller should use a single cursor.
+   */
+  bool Start(mongocxx::collection& collection, int32_t partitions);
+
+  /**
+   * Get the next document. Blocks until a document is available or all the
+   * partitions are exhausted.
+   *
+   * @param document Resulting document.
+   * @return @c true if a document was returned.
+   */
+  bool Next(std::unique_ptr< bsoncxx::document::value >& document);
+
+  /**
+   * Stop the workers and discard buffered documents.
+   */
+  void Cancel();
+
+  /**
+   * Get the first error reported by a worker.
+   *
+   * @param error Resulting error.
+   * @return @c true if any worker failed.
+   */
+  bool GetError(DocumentDbError& error) const;
+
+ private:
+  DOCUMENTDB_NO_COPY_ASSIGNMENT(DocumentDbPartitionedScan);
+
+  /**
+   * Worker thread routine. Runs partitions until none are left.
+   */
+  void Run();
+
+  /**
+   * Run the pipeline for the given partition filter.
+   *
+   * @param collection Collection.
+   * @param filter $match filter of the partition.
+   */
+  void RunPartition(mongocxx::collection& collection,
+                    const bsoncxx::document::value& filter);
+
+  /**
+   * Push a document to the queue. Blocks while the queue is full.
+   *
+   * @param document Document.
+   * @return @c false if the scan was cancelled.
+   */
+  bool Push(const bsoncxx::document::view& document);
+
+  /** Connection. */
+  const Connection& connection_;
+
+  /** Database name. */
+  std::string databaseName_;
+
+  /** Collection name. */
+  std::string collectionName_;
+
+  /** Aggregate pipeline stages. */
+  std::vector< std::string > stages_;
+
+  /** Aggregate options. */
+  mongocxx::options::aggregate options_;
+
+  /** Maximum number of buffered documents. */
+  size_t queueCapacity_;
+
+  /** Partition filters. */
+  std::vector< bsoncxx::document::value > filters_;
+
+  /** Index of the next partition to run. */
+  size_t nextPartition_ = 0;
+
+  /** Number of running workers. */
+  size_t activeWorkers_ = 0;
+
+  /** Cancellation flag. */
+  bool cancelled_ = false;
+
+  /** First worker error. */
+  DocumentDbError error_;
+
+  /** Buffered documents. */
+  std::deque< bsoncxx::document::value > queue_;
+
+  /** Lock guarding the state shared with the workers. */
+  mutable common::concurrent::CriticalSection lock_;
+
+  /** Signalled when a document is pushed or a worker completes. */
+  common::concurrent::ConditionVariable notEmpty_;
+
+  /** Signalled when a document is pulled or the scan is cancelled. */
+  common::concurrent::ConditionVariable notFull_;
+
+  /** Worker threads. */
+  std::vector< std::thread > workers_;
+};
+}  // namespace odbc
+}  // namespace documentdb
+
+#endif  //_DOCUMENTDB_ODBC_DOCUMENTDB_PARTITIONED_SCAN
@@ -19,7 +19,13 @@
 #define _DOCUMENTDB_ODBC_ENVIRONMENT
 
 #include <set>
+#include <string>
+#include <thread>
+#include <vector>
 
+#include "documentdb/odbc/common/concurrent.h"
+#include "documentdb/odbc/config/configuration.h"
+#include "documentdb/odbc/connection_pool.h"
 #include "documentdb/odbc/diagnostic/diagnosable_adapter.h"
 
 namespace documentdb {
@@ -40,7 +46,8 @@ class Environment : public diagnostic::DiagnosableAdapter {
   Environment();
 
   /**
-   * Destructor.
+   * Destructor. Cancels the pre-warm and waits for the connections being
+   * opened, see CancelPrewarm.
    */
   ~Environment();
 
@@ -75,6 +82,36 @@ class Environment : public diagnostic::DiagnosableAdapter {
    */
   void GetAttribute(int32_t attr, app::ApplicationDataBuffer& buffer);
 
+  /**
+   * Get the pool of idle connections of the environment.
+   *
+   * @return Connection pool.
+   */
+  ConnectionPool& GetConnectionPool() {
+    return connectionPool;
+  }
+
+  /**
+   * Open the pre-warmed connections of the configuration on a background
+   * thread and put them in the pool. Done once per pool key.
+   *
+   * @param config Configuration.
+   */
+  void Prewarm(const config::Configuration& config);
+
+  /**
+   * Wait for the pre-warm threads to finish.
+   */
+  void WaitForPrewarm();
+
+  /**
+   * Cancel the pre-warm. The connections that are not being opened yet are
+   * not opened, and the warm-up queries are skipped. The wait for the
+   * pre-warm threads is then bounded by the login timeout of the connections
+   * being opened, which is at most PREWARM_LOGIN_TIMEOUT_SECONDS.
+   */
+  void CancelPrewarm();
+
  private:
   DOCUMENTDB_NO_COPY_ASSIGNMENT(Environment);
 
@@ -109,6 +146,42 @@ class Environment : public diagnostic::DiagnosableAdapter {
   SqlResult::Type InternalGetAttribute(int32_t attr,
                                        app::ApplicationDataBuffer& buffer);
 
+  /**
+   * Open the pre-warmed connections and return them to the pool.
+   *
+   * @param config Configuration.
+   */
+  void RunPrewarm(const config::Configuration config);
+
+  /**
+   * Read the configuration of a DSN and pre-warm its connections. Runs on a
+   * pre-warm thread, so that the DSN is not read while the environment is
+   * allocated.
+   *
+   * @param dsn DSN name.
+   */
+  void RunDsnPrewarm(const std::string dsn);
+
+  /**
+   * Check if the pre-warm was cancelled.
+   *
+   * @return @c true if cancelled.
+   */
+  bool IsPrewarmCancelled();
+
+  /**
+   * Translate the warm-up SQL statements of the file, so that the translator
+   * is loaded and compiled before the first queries.
+   *
+   * @param connection Established connection.
+   * @param path Path of the file of SQL statements, one per line.
+   */
+  static void RunWarmUpQueries(Connection& connection,
+                               const std::string& path);
+
+  /** Guards connections, which pre-warm threads also update. */
+  common::concurrent::CriticalSection connectionsLock;
+
   /** Assotiated connections. */
   ConnectionSet connections;
 
@@ -117,6 +190,21 @@ class Environment : public diagnostic::DiagnosableAdapter {
 
   /** ODBC null-termintaion of string behaviour. */
   int32_t odbcNts;
+
+  /** Idle connections. */
+  ConnectionPool connectionPool;
+
+  /** Guards prewarmedKeys, prewarmThreads and prewarmCancelled. */
+  common::concurrent::CriticalSection prewarmLock;
+
+  /** Pool keys that were pre-warmed. */
+  std::set< std::string > prewarmedKeys;
+
+  /** Pre-warm threads. */
+  std::vector< std::thread > prewarmThreads;
+
+  /** Whether the pre-warm was cancelled. */
+  bool prewarmCancelled;
 };
 }  // namespace odbc
 }  // namespace documentdb
@@ -18,6 +18,7 @@
 #ifndef _DOCUMENTDB_ODBC_LOG
 #define _DOCUMENTDB_ODBC_LOG
 
+#include <atomic>
 #include <fstream>
 #include <iomanip>
 #include <memory>
@@ -25,6 +26,7 @@
 #include <string>
 #include <thread>
 
+#include "documentdb/odbc/async_log_writer.h"
 #include "documentdb/odbc/common/common.h"
 #include "documentdb/odbc/common/concurrent.h"
 #include "documentdb/odbc/log_level.h"
@@ -35,34 +37,39 @@ using documentdb::odbc::common::concurrent::CriticalSection;
 
 #define DEFAULT_LOG_PATH documentdb::odbc::Logger::GetDefaultLogPath()
 
+// Lowest log level compiled into the driver, see LOG_COMPILE_LEVEL in
+// CMakeLists.txt. Messages below this level are removed by the compiler.
+#ifndef DOCUMENTDB_LOG_COMPILE_LEVEL
+#define DOCUMENTDB_LOG_COMPILE_LEVEL 0
+#endif
+
 #define WRITE_LOG_MSG(param, logLevel, msgPrefix) \
   WRITE_MSG_TO_STREAM(param, logLevel, msgPrefix, (std::ostream*)nullptr)
 
 #define WRITE_MSG_TO_STREAM(param, logLevel, msgPrefix, logStream)            \
   {                                                                           \
-    std::shared_ptr< documentdb::odbc::Logger > p =                           \
-        documentdb::odbc::Logger::GetLoggerInstance();                        \
-    if (p->GetLogLevel() <= logLevel && (p->IsEnabled() || p->EnableLog())) { \
-      std::ostream* prevStream = p.get()->GetLogStream();                     \
-      if (logStream) {                                                        \
-        /* Override the stream temporarily */                                 \
-        p.get()->SetLogStream(logStream);                                     \
-      }                                                                       \
-      std::unique_ptr< documentdb::odbc::LogStream > lstream(                 \
-          new documentdb::odbc::LogStream(p.get()));                          \
-      auto now = std::chrono::system_clock::now();                            \
-      auto now_time_t = std::chrono::system_clock::to_time_t(now);            \
-      auto locTime = std::localtime(&now_time_t);                             \
-      std::ostringstream fmt_time;                                            \
-      fmt_time << std::put_time(locTime, "%T %x ");                           \
-      /* Write the formatted message to the stream */                         \
-      *lstream << "TID: " << std::this_thread::get_id() << " "                \
-               << fmt_time.str() << msgPrefix << __FUNCTION__ << ": "         \
-               << param;                                                      \
-      /* This will trigger the write to stream */                             \
-      lstream = nullptr;                                                      \
-      if (logStream) { /* Restore the stream if it was set */                 \
-        p.get()->SetLogStream(prevStream);                                    \
+    /* Cheap checks first: compiled-out levels and the atomic level */        \
+    if (DOCUMENTDB_LOG_COMPILE_LEVEL                                          \
+            <= documentdb::odbc::LogLevel::ToInt(logLevel)                    \
+        && documentdb::odbc::Logger::IsLevelEnabled(logLevel)) {              \
+      documentdb::odbc::Logger* p =                                           \
+          documentdb::odbc::Logger::GetRawLoggerInstance();                   \
+      if (p->IsEnabled() || p->EnableLog()) {                                 \
+        std::ostream* prevStream = p->GetLogStream();                         \
+        if (logStream) {                                                      \
+          /* Override the stream temporarily */                               \
+          p->SetLogStream(logStream);                                         \
+        }                                                                     \
+        std::unique_ptr< documentdb::odbc::LogStream > lstream(               \
+            new documentdb::odbc::LogStream(p, logLevel, msgPrefix,           \
+                                            __FUNCTION__));                   \
+        /* Write the message to the stream */                                 \
+        *lstream << param;                                                    \
+        /* This will trigger the write to stream */                           \
+        lstream = nullptr;                                                    \
+        if (logStream) { /* Restore the stream if it was set */               \
+          p->SetLogStream(prevStream);                                        \
+        }                                                                     \
       }                                                                       \
     }                                                                         \
   }
@@ -111,10 +118,16 @@ class Logger;
 class LogStream : public std::basic_ostream< char > {
  public:
   /**
-   * Constructor.
+   * Constructor. In the text format, the line starts with the thread id,
+   * the timestamp, the prefix and the function name; in the JSON format
+   * they are fields of the record built upon destruction.
    * @param parent pointer to Logger.
+   * @param level Level of the message.
+   * @param prefix Prefix of the message in the text format.
+   * @param function Name of the function writing the message.
    */
-  LogStream(Logger* parent);
+  LogStream(Logger* parent, LogLevel::Type level, const char* prefix,
+            const char* function);
 
   /**
    * Conversion operator helpful to determine if log is enabled
@@ -135,6 +148,15 @@ class LogStream : public std::basic_ostream< char > {
 
   /** Parent logger object */
   Logger* logger;
+
+  /** Level of the message. */
+  LogLevel::Type level;
+
+  /** Name of the function writing the message. */
+  const char* function;
+
+  /** Whether the line is written as a JSON record. */
+  bool json;
 };
 
 /**
@@ -170,6 +192,131 @@ class Logger {
     return stream;
   }
 
+  /**
+   * Write the log records from a background thread, or stop doing so.
+   * @param enable True to write the records from a background thread.
+   */
+  void SetAsync(bool enable);
+
+  /**
+   * Stop the asynchronous writer and join its thread, once the queued
+   * records are written. The records are then written synchronously until
+   * SetAsync enables the writer again. Called when the last environment is
+   * freed, so that the thread is not joined by the static destructors, which
+   * run under the loader lock when the driver is unloaded on Windows.
+   * Threads still logging keep the writer until their record is queued, in
+   * which case the last of them joins the thread instead.
+   */
+  void StopAsync();
+
+  /**
+   * Set what happens to a log record when the asynchronous log buffer is
+   * full.
+   * @param drop True to drop the record, false to wait for room.
+   */
+  void SetDropOnOverflow(bool drop);
+
+  /**
+   * Get the number of log records dropped because the asynchronous log
+   * buffer was full.
+   * @return Dropped record count.
+   */
+  uint64_t GetDroppedCount() const;
+
+  /**
+   * Write the queued log records, if any, and flush the log stream.
+   */
+  void Flush();
+
+  /**
+   * Write the log records as JSON objects, one per line, or as text.
+   * @param enable True to write JSON records.
+   */
+  void SetJsonFormat(bool enable);
+
+  /**
+   * Checks if the log records are written as JSON objects.
+   * @return True, if the log format is JSON.
+   */
+  static bool IsJsonFormat() {
+    return jsonFormat_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Format a log record as a JSON object, on a single line. The fields are
+   * the time in microseconds since the epoch, the thread id, the level, the
+   * function, the connection and statement ids of the current thread (0 if
+   * none, see ContextScope) and the message, whose credentials, and the
+   * literals of its sensitive parts, are redacted.
+   * @param level Level of the message.
+   * @param function Name of the function writing the message.
+   * @param message Message.
+   * @return JSON record.
+   */
+  static std::string FormatJsonRecord(LogLevel::Type level,
+                                      const char* function,
+                                      const std::string& message);
+
+  /**
+   * Redact the values of the credential keywords (PWD, PASSWORD and
+   * SSH_PRIVATE_KEY_PASSPHRASE) and the passwords of the URIs in a message.
+   * @param message Message.
+   * @return Message with the credentials replaced by REDACTED_STRING.
+   */
+  static std::string RedactCredentials(const std::string& message);
+
+  /**
+   * Redact the literals and the credentials of a message: the contents of
+   * the single-quoted and double-quoted strings, and the numbers.
+   * @param message Message.
+   * @return Message with the literals replaced by REDACTED_STRING.
+   */
+  static std::string RedactLiterals(const std::string& message);
+
+  /**
+   * Redact the sensitive parts of a log message, see MarkSensitive.
+   * @param message Log message.
+   * @param json True to redact the literals of the sensitive parts, false to
+   *     replace them by REDACTED_STRING.
+   * @return Message without markers.
+   */
+  static std::string RedactSensitive(const std::string& message, bool json);
+
+  /**
+   * Tags the log records written by the current thread with a connection
+   * and a statement id until it is destroyed.
+   */
+  class ContextScope {
+   public:
+    /**
+     * Constructor.
+     * @param connectionId Connection id, 0 if none.
+     * @param statementId Statement id, 0 if none.
+     */
+    ContextScope(uint64_t connectionId, uint64_t statementId);
+
+    /**
+     * Destructor. Restores the ids of the enclosing scope.
+     */
+    ~ContextScope();
+
+   private:
+    DOCUMENTDB_NO_COPY_ASSIGNMENT(ContextScope);
+
+    /** Connection id of the enclosing scope. */
+    uint64_t prevConnectionId;
+
+    /** Statement id of the enclosing scope. */
+    uint64_t prevStatementId;
+  };
+
+  /**
+   * Get the timestamp of log records, formatted as "%T %x ". The formatted
+   * timestamp is cached per thread and only rebuilt once per second.
+   * @return Current timestamp.
+   */
+  static const std::string& GetTimestamp();
+
   /**
    * Get default log path.
    * @return Logger default path.
@@ -192,6 +339,29 @@ class Logger {
     return logger_;
   }
 
+  /**
+   * Get singleton instance of Logger without taking a reference.
+   * If there is no instance, create new instance.
+   * @return Logger instance.
+   */
+  static Logger* GetRawLoggerInstance() {
+    if (!logger_)
+      GetLoggerInstance();
+
+    return logger_.get();
+  }
+
+  /**
+   * Checks if messages of the given level are logged. This is a relaxed
+   * atomic load so it can be called on every row of a fetch.
+   * @param level Level of the message.
+   * @return True, if the level is at or above the logger's set log level.
+   */
+  static bool IsLevelEnabled(LogLevel::Type level) {
+    return LogLevel::ToInt(level)
+           >= activeLevel_.load(std::memory_order_relaxed);
+  }
+
 /**
  * Will redact the message if the log level is not DEBUG
  * 
@@ -203,6 +373,17 @@ class Logger {
                : REDACTED_STRING;
   }
 
+  /**
+   * Mark a part of a log message as sensitive, for the LOG_* macros only.
+   * Unless the log level is DEBUG, the part is redacted when the record is
+   * built: replaced by REDACTED_STRING in the text format, and with its
+   * literals and credentials redacted in the JSON format, see
+   * RedactLiterals. Use RedactMessage for text that is not logged.
+   * @param message Sensitive part of a log message.
+   * @return Marked message.
+   */
+  static std::string MarkSensitive(const std::string& message);
+
   /**
    * Get the logger's set log level.
    * @return logLevel.
@@ -242,6 +423,12 @@ class Logger {
  private:
   static std::shared_ptr< Logger > logger_;  // a singleton instance
 
+  /** Copy of the log level of the singleton, read by IsLevelEnabled. */
+  static std::atomic< int > activeLevel_;
+
+  /** Whether the records are written as JSON objects. */
+  static std::atomic< bool > jsonFormat_;
+
   /**
    * Constructor.
    */
@@ -253,6 +440,13 @@ class Logger {
    */
   std::string CreateFileName() const;
 
+  /**
+   * Get the asynchronous writer.
+   *
+   * @return Writer, or null if it was never enabled or is stopped.
+   */
+  std::shared_ptr< AsyncLogWriter > GetAsyncWriter() const;
+
   DOCUMENTDB_NO_COPY_ASSIGNMENT(Logger);
 
   /** Mutex for writes synchronization. */
@@ -275,6 +469,22 @@ class Logger {
 
   /** Log file path */
   std::string logFilePath;
+
+  /** Whether records are written by the asynchronous writer. */
+  std::atomic< bool > async{false};
+
+  /** Whether records are dropped when the asynchronous buffer is full. */
+  std::atomic< bool > dropOnOverflow{false};
+
+  /** Lock of the asynchronous writer pointer. */
+  mutable CriticalSection asyncWriterLock;
+
+  /**
+   * Asynchronous writer, created the first time it is enabled. Shared with
+   * the threads queuing a record, so that StopAsync does not free it under
+   * them.
+   */
+  std::shared_ptr< AsyncLogWriter > asyncWriter;
 };
 }  // namespace odbc
 }  // namespace documentdb
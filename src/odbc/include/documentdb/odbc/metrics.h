@@ -0,0 +1,296 @@
+/*
+ * Copyright <2022> Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ */
+
+
+#ifndef _DOCUMENTDB_ODBC_METRICS
+#define _DOCUMENTDB_ODBC_METRICS
+
+#include <stdint.h>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "documentdb/odbc/common/common.h"
+#include "documentdb/odbc/common/concurrent.h"
+
+namespace documentdb {
+namespace odbc {
+/**
+ * Process-wide registry of driver metrics.
+ *
+ * Counters and histograms are sharded per thread: each thread only updates
+ * its own shard, with relaxed atomic stores, and readers sum the shards. The
+ * shard of a thread is folded into the totals when the thread exits. The
+ * registry can be exported in the Prometheus text format to a file, which
+ * is rewritten periodically, and served over HTTP on a localhost port.
+ */
+class Metrics {
+ public:
+  /**
+   * Counters.
+   */
+  struct Counter {
+    enum Type {
+      /** Connections established. */
+      CONNECTIONS_OPENED,
+
+      /** Connections taken from the connection pool. */
+      POOL_HITS,
+
+      /** Connections that could not be taken from the connection pool. */
+      POOL_MISSES,
+
+      /** SQL statements executed. */
+      STATEMENTS_EXECUTED,
+
+      /** SQL statements translated to aggregate pipelines. */
+      TRANSLATIONS,
+
+      /** Rows fetched by the applications. */
+      ROWS_FETCHED,
+
+      /** Size of the replies received from the servers, in bytes. */
+      BYTES_FETCHED,
+
+      /** Calls to the JDBC driver through JNI. */
+      JNI_CALLS,
+
+      /** Attempts to restore a lost connection. */
+      RECONNECT_ATTEMPTS,
+
+      /** Lost connections that could not be restored. */
+      RECONNECT_FAILURES,
+
+      /** Number of counters. */
+      COUNT
+    };
+  };
+
+  /**
+   * Histograms of durations.
+   */
+  struct Histogram {
+    enum Type {
+      /** Time spent translating SQL statements. */
+      TRANSLATION,
+
+      /** Time from sending a query to receiving its first batch. */
+      FIRST_BATCH,
+
+      /** Number of histograms. */
+      COUNT
+    };
+  };
+
+  /** Number of histogram buckets, not counting the +Inf bucket. */
+  static const size_t BUCKET_COUNT = 13;
+
+  /** Upper bounds of the histogram buckets, in microseconds. */
+  static const int64_t BUCKET_BOUNDS[BUCKET_COUNT];
+
+  /** Default interval of the file export, in seconds. */
+  static const int32_t DEFAULT_EXPORT_INTERVAL = 10;
+
+  /**
+   * Get the registry instance.
+   *
+   * @return Instance.
+   */
+  static Metrics& GetInstance();
+
+  /**
+   * Add to a counter of the calling thread.
+   *
+   * @param counter Counter.
+   * @param value Value to add.
+   */
+  static void Increment(Counter::Type counter, uint64_t value = 1);
+
+  /**
+   * Record a duration in a histogram of the calling thread.
+   *
+   * @param histogram Histogram.
+   * @param micros Duration in microseconds.
+   */
+  static void Observe(Histogram::Type histogram, int64_t micros);
+
+  /**
+   * Add to the number of open connections.
+   *
+   * @param delta Value to add.
+   */
+  void AddOpenConnections(int64_t delta);
+
+  /**
+   * Count an error reported to an application.
+   *
+   * @param sqlState SQLSTATE of the error.
+   */
+  void AddError(const std::string& sqlState);
+
+  /**
+   * Get the value of a counter, summed over all threads.
+   *
+   * @param counter Counter.
+   * @return Value.
+   */
+  uint64_t GetCounter(Counter::Type counter);
+
+  /**
+   * Get the number of open connections.
+   *
+   * @return Number of open connections.
+   */
+  int64_t GetOpenConnections() const;
+
+  /**
+   * Get the number of errors of a SQLSTATE.
+   *
+   * @param sqlState SQLSTATE.
+   * @return Number of errors.
+   */
+  uint64_t GetErrors(const std::string& sqlState);
+
+  /**
+   * Format the metrics in the Prometheus text exposition format.
+   *
+   * @return Metrics text.
+   */
+  std::string ToPrometheus();
+
+  /**
+   * Write the metrics to a file. The file is replaced atomically where the
+   * platform allows it.
+   *
+   * @param path File path.
+   * @return @c true on success.
+   */
+  bool WriteFile(const std::string& path);
+
+  /**
+   * Configure the export. Restarts the export if the settings changed, and
+   * stops it if neither a path nor a port is given.
+   *
+   * @param path File the metrics are written to, or empty.
+   * @param port Localhost port the metrics are served on, or zero.
+   * @param intervalSeconds Interval of the file export, in seconds.
+   */
+  void ConfigureExport(const std::string& path, int32_t port,
+                       int32_t intervalSeconds);
+
+  /**
+   * Stop the export and join its thread. Called when the last environment
+   * is freed, so that the thread is not joined by the static destructors,
+   * which run under the loader lock when the driver is unloaded on Windows.
+   * The next connection that configures the export starts it again.
+   */
+  void StopExport();
+
+  /**
+   * Get the port the metrics are served on.
+   *
+   * @return Port, or zero if the metrics are not served.
+   */
+  int32_t GetExportPort();
+
+ private:
+  DOCUMENTDB_NO_COPY_ASSIGNMENT(Metrics);
+
+  /**
+   * Counters and histograms of one thread. Only the owning thread writes
+   * them.
+   */
+  struct Shard {
+    /**
+     * Constructor.
+     */
+    Shard();
+
+    /**
+     * Add the values of another shard.
+     *
+     * @param other Shard.
+     */
+    void Add(const Shard& other);
+
+    /** Counter values. */
+    std::atomic< uint64_t > counters[Counter::COUNT];
+
+    /** Histogram bucket counts, the +Inf bucket last. Not cumulative. */
+    std::atomic< uint64_t > buckets[Histogram::COUNT][BUCKET_COUNT + 1];
+
+    /** Histogram sums, in microseconds. */
+    std::atomic< uint64_t > sums[Histogram::COUNT];
+  };
+
+  /** Registration of the shard of a thread. */
+  class ThreadShard;
+
+  /** Export to a file and a port. */
+  class Exporter;
+
+  /**
+   * Constructor.
+   */
+  Metrics();
+
+  /**
+   * Destructor. Stops the export.
+   */
+  ~Metrics();
+
+  /**
+   * Get the shard of the calling thread.
+   *
+   * @return Shard.
+   */
+  static Shard& GetShard();
+
+  /**
+   * Sum the shards of all threads.
+   *
+   * @param total Resulting sum. Must be zero.
+   */
+  void Collect(Shard& total);
+
+  /** Guards shards, retired and errors. */
+  common::concurrent::CriticalSection lock;
+
+  /** Shards of the running threads. */
+  std::vector< Shard* > shards;
+
+  /** Sum of the shards of the exited threads. */
+  Shard retired;
+
+  /** Number of errors by SQLSTATE. */
+  std::map< std::string, uint64_t > errors;
+
+  /** Number of open connections. */
+  std::atomic< int64_t > openConnections;
+
+  /** Guards exporter. */
+  common::concurrent::CriticalSection exportLock;
+
+  /** Running export. */
+  std::unique_ptr< Exporter > exporter;
+};
+}  // namespace odbc
+}  // namespace documentdb
+
+#endif  //_DOCUMENTDB_ODBC_METRICS
@@ -0,0 +1,62 @@
+/*
+ * Copyright <2022> Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ */
+
+
+#ifndef _DOCUMENTDB_ODBC_PROBES
+#define _DOCUMENTDB_ODBC_PROBES
+
+/**
+ * Static tracepoints (USDT) of the driver, for perf, bpftrace and
+ * SystemTap. They are compiled in with the WITH_USDT CMake option, which
+ * needs <sys/sdt.h> (systemtap-sdt-dev). Each probe is a single nop until a
+ * tracer attaches to it. Without the option the macros expand to nothing and
+ * their arguments are not evaluated, so arguments must not have side
+ * effects.
+ *
+ * Probes of the "documentdb_odbc" provider:
+ *  - connect_start(), connect_done(int ok)
+ *  - execute_start(uint64 statementId, const char* sql),
+ *    execute_done(uint64 statementId, int result)
+ *  - translate_start(uint64 statementId),
+ *    translate_done(uint64 statementId, int ok)
+ *  - aggregate(uint64 statementId, int stages)
+ *  - reply_received(const char* command, uint64 bytes, int64 durationMicros),
+ *    for every reply from a server, including the batches of the cursors
+ *  - row_fetch(uint64 statementId, uint64 row)
+ *  - jni_call_start(), jni_call_done(int exception)
+ *
+ * See src/tests/tracing for bpftrace scripts using them.
+ */
+
+#ifdef DOCUMENTDB_WITH_USDT
+#include <sys/sdt.h>
+
+#define DOCUMENTDB_PROBE(name) DTRACE_PROBE(documentdb_odbc, name)
+#define DOCUMENTDB_PROBE1(name, a1) DTRACE_PROBE1(documentdb_odbc, name, a1)
+#define DOCUMENTDB_PROBE2(name, a1, a2) \
+  DTRACE_PROBE2(documentdb_odbc, name, a1, a2)
+#define DOCUMENTDB_PROBE3(name, a1, a2, a3) \
+  DTRACE_PROBE3(documentdb_odbc, name, a1, a2, a3)
+#else
+#define DOCUMENTDB_PROBE(name) \
+  do {                         \
+  } while (false)
+#define DOCUMENTDB_PROBE1(name, a1) DOCUMENTDB_PROBE(name)
+#define DOCUMENTDB_PROBE2(name, a1, a2) DOCUMENTDB_PROBE(name)
+#define DOCUMENTDB_PROBE3(name, a1, a2, a3) DOCUMENTDB_PROBE(name)
+#endif  // DOCUMENTDB_WITH_USDT
+
+#endif  //_DOCUMENTDB_ODBC_PROBES
@@ -20,8 +20,14 @@
 
 #include "documentdb/odbc/app/parameter_set.h"
 #include "documentdb/odbc/documentdb_cursor.h"
+#include "documentdb/odbc/query/data_query_options.h"
 #include "documentdb/odbc/query/query.h"
 #include "documentdb/odbc/jni/documentdb_mql_query_context.h"
+#include "documentdb/odbc/statement_trace.h"
+#include "mongocxx/client.hpp"
+#include "mongocxx/hint.hpp"
+#include "mongocxx/options/aggregate.hpp"
+#include "mongocxx/read_preference.hpp"
 
 using documentdb::odbc::jni::DocumentDbMqlQueryContext;
 
@@ -44,10 +50,11 @@ class DataQuery : public Query {
    * @param sql SQL query string.
    * @param params SQL params.
    * @param timeout Timeout.
+   * @param options Statement level query options.
    */
   DataQuery(diagnostic::DiagnosableAdapter& diag, Connection& connection,
             const std::string& sql, const app::ParameterSet& params,
-            int32_t& timeout);
+            int32_t& timeout, const DataQueryOptions& options);
 
   /**
    * Destructor.
@@ -123,6 +130,25 @@ class DataQuery : public Query {
     return sql_;
   }
 
+  /**
+   * Get the phase timings and counters of the last execution.
+   *
+   * @return Statement trace.
+   */
+  const StatementTrace& GetTrace() const {
+    return trace_;
+  }
+
+  /**
+   * Translate the query and explain its execution on the server, without
+   * returning its result set.
+   *
+   * @param rows Resulting list of (item, value) pairs.
+   * @return Operation result.
+   */
+  SqlResult::Type Explain(
+      std::vector< std::pair< std::string, std::string > >& rows);
+
  private:
   DOCUMENTDB_NO_COPY_ASSIGNMENT(DataQuery);
 
@@ -152,9 +178,17 @@ class DataQuery : public Query {
   /**
    * Make data fetch request and use response to set internal state.
    *
+   * @param reconnect Restore the connection and retry once if it was lost.
    * @return Result.
    */
-  SqlResult::Type MakeRequestFetch();
+  SqlResult::Type MakeRequestFetch(bool reconnect);
+
+  /**
+   * Record the time the first batch of the query took to arrive.
+   *
+   * @param start Time the query was sent.
+   */
+  void RecordFirstBatch(StatementTrace::Clock::time_point start);
 
   /**
    * Gets the MQL query context.
@@ -165,6 +199,82 @@ class DataQuery : public Query {
       SharedPointer< DocumentDbMqlQueryContext >& mqlQueryContext,
       DocumentDbError& error);
 
+  /**
+   * Push the statement row count and column length limits down into the
+   * aggregate pipeline.
+   *
+   * @param stages Aggregate pipeline stages to update.
+   * @param columnMetadata Column metadata.
+   * @param paths Document path of each column.
+   */
+  void AppendResultLimits(
+      std::vector< std::string >& stages,
+      const std::vector< JdbcColumnMetadata >& columnMetadata,
+      const std::vector< std::string >& paths) const;
+
+  /**
+   * Fill the aggregate options from the statement options and the
+   * connection configuration.
+   *
+   * @param options Aggregate options to fill.
+   */
+  void MakeAggregateOptions(mongocxx::options::aggregate& options) const;
+
+  /**
+   * Make the index hint from the statement options. The hint must be set.
+   *
+   * @return Index hint.
+   */
+  mongocxx::hint MakeHint() const;
+
+  /**
+   * Get the read preference from the statement options, or the connection
+   * configuration if unset. Analytic queries read from secondaries if
+   * analytics routing is enabled.
+   *
+   * @return Read preference.
+   */
+  ReadPreference::Type GetReadPreference() const;
+
+  /**
+   * Make the read preference of the queries, with the statement maximum
+   * staleness.
+   *
+   * @return Read preference.
+   */
+  mongocxx::read_preference MakeReadPreference() const;
+
+  /**
+   * Decide if the query is routed as an analytic query.
+   *
+   * @param stages Aggregate pipeline stages.
+   */
+  void UpdateRouting(const std::vector< std::string >& stages);
+
+  /**
+   * Make the comment attached to the queries. It is tagged with the
+   * application name and statement id so that server-side logs can be
+   * correlated with the client.
+   *
+   * @return Comment.
+   */
+  std::string MakeComment() const;
+
+  /**
+   * Answer a plain COUNT(*) query with a count command instead of the
+   * aggregate pipeline.
+   *
+   * @param collection Collection to count.
+   * @param stages Aggregate pipeline stages.
+   * @param columnMetadata Column metadata.
+   * @param paths Document path of each column.
+   * @return @c true if the query was a plain count and the cursor is set.
+   */
+  bool MakeRequestCount(mongocxx::collection& collection,
+                        const std::vector< std::string >& stages,
+                        std::vector< JdbcColumnMetadata >& columnMetadata,
+                        std::vector< std::string >& paths);
+
   /**
    * Make next result set request and use response to set internal state.
    *
@@ -213,6 +323,12 @@ class DataQuery : public Query {
    */
   SqlResult::Type InternalClose();
 
+  /**
+   * Write the query to the slow query log if it took longer than the
+   * SLOW_QUERY_THRESHOLD_MS of the connection.
+   */
+  void WriteSlowQuery();
+
   /** Connection associated with the statement. */
   Connection& connection_;
 
@@ -228,11 +344,29 @@ class DataQuery : public Query {
   /** Result set metadata. */
   meta::ColumnMetaVector resultMeta_{};
 
+  /** MongoDB client of the cursor. Must outlive the cursor. */
+  std::shared_ptr< mongocxx::client > mongoClient_{};
+
   /** Cursor. */
   std::unique_ptr< DocumentDbCursor > cursor_{};
 
+  /** Whether the current query is routed as an analytic query. */
+  bool analytic_ = false;
+
+  /** Phase timings and counters of the last execution. */
+  StatementTrace trace_;
+
+  /** Collection of the last execution, for the slow query log. */
+  std::string collectionName_;
+
+  /** Pipeline stages of the last execution, for the slow query log. */
+  std::vector< std::string > stages_;
+
   /** Timeout. */
   int32_t& timeout_;
+
+  /** Statement level query options. */
+  const DataQueryOptions& options_;
 };
 }  // namespace query
 }  // namespace odbc
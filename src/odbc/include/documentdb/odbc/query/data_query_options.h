@@ -0,0 +1,78 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _DOCUMENTDB_ODBC_QUERY_DATA_QUERY_OPTIONS
+#define _DOCUMENTDB_ODBC_QUERY_DATA_QUERY_OPTIONS
+
+#include <stdint.h>
+
+#include <boost/optional.hpp>
+#include <string>
+
+#include "documentdb/odbc/common_types.h"
+#include "documentdb/odbc/read_concern.h"
+#include "documentdb/odbc/read_preference.h"
+
+namespace documentdb {
+namespace odbc {
+namespace query {
+/**
+ * Statement level options applied when a data query is executed. Unset
+ * values fall back to the connection configuration.
+ */
+struct DataQueryOptions {
+  /** Number of partitions used for a parallel collection scan. */
+  boost::optional< int32_t > parallelScanPartitions;
+
+  /** Maximum number of rows to return. Zero means no limit. */
+  SqlUlen maxRows = 0;
+
+  /** Maximum length of character column values. Zero means no limit. */
+  SqlUlen maxLength = 0;
+
+  /** Whether aggregate stages may write temporary files. */
+  boost::optional< bool > allowDiskUse;
+
+  /** Index hint: an index name or a JSON key pattern. Empty for none. */
+  std::string hint;
+
+  /** Comment attached to the aggregate command. */
+  boost::optional< std::string > comment;
+
+  /** Read concern level. */
+  boost::optional< ReadConcern::Type > readConcern;
+
+  /** Read preference. */
+  boost::optional< ReadPreference::Type > readPreference;
+
+  /** Maximum replication lag of a secondary to read from, in seconds. */
+  boost::optional< int32_t > maxStalenessSeconds;
+
+  /** Collation as a JSON document. Empty for none. */
+  std::string collation;
+
+  /** Cursor batch size. Zero means the default fetch size. */
+  SqlUlen batchSize = 0;
+
+  /** Identifier of the statement, used to tag the queries. */
+  uint64_t statementId = 0;
+};
+}  // namespace query
+}  // namespace odbc
+}  // namespace documentdb
+
+#endif  //_DOCUMENTDB_ODBC_QUERY_DATA_QUERY_OPTIONS
@@ -0,0 +1,144 @@
+/*
+ * Copyright <2022> Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ */
+
+
+#ifndef _DOCUMENTDB_ODBC_QUERY_EXPLAIN_QUERY
+#define _DOCUMENTDB_ODBC_QUERY_EXPLAIN_QUERY
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "documentdb/odbc/query/data_query.h"
+#include "documentdb/odbc/query/query.h"
+
+namespace documentdb {
+namespace odbc {
+namespace query {
+/**
+ * Explain query. Returns the translated aggregate pipeline of the explained
+ * SQL query and the server explain plan as ITEM/VALUE rows.
+ */
+class ExplainQuery : public Query {
+ public:
+  /**
+   * Constructor.
+   *
+   * @param diag Diagnostics collector.
+   * @param connection Associated connection.
+   * @param sql Explained SQL query string.
+   * @param params SQL params.
+   * @param timeout Timeout.
+   * @param options Statement level query options.
+   */
+  ExplainQuery(diagnostic::DiagnosableAdapter& diag, Connection& connection,
+               const std::string& sql, const app::ParameterSet& params,
+               int32_t& timeout, const DataQueryOptions& options);
+
+  /**
+   * Destructor.
+   */
+  virtual ~ExplainQuery();
+
+  /**
+   * Execute query.
+   *
+   * @return True on success.
+   */
+  virtual SqlResult::Type Execute();
+
+  /**
+   * Get column metadata.
+   *
+   * @return Column metadata.
+   */
+  virtual const meta::ColumnMetaVector* GetMeta();
+
+  /**
+   * Fetch next result row to application buffers.
+   *
+   * @param columnBindings Application buffers to put data to.
+   * @return Operation result.
+   */
+  virtual SqlResult::Type FetchNextRow(app::ColumnBindingMap& columnBindings);
+
+  /**
+   * Get data of the specified column in the result set.
+   *
+   * @param columnIdx Column index.
+   * @param buffer Buffer to put column data to.
+   * @return Operation result.
+   */
+  virtual SqlResult::Type GetColumn(uint16_t columnIdx,
+                                    app::ApplicationDataBuffer& buffer);
+
+  /**
+   * Close query.
+   *
+   * @return True on success.
+   */
+  virtual SqlResult::Type Close();
+
+  /**
+   * Check if data is available.
+   *
+   * @return True if data is available.
+   */
+  virtual bool DataAvailable() const;
+
+  /**
+   * Get number of rows affected by the statement.
+   *
+   * @return Number of rows affected by the statement.
+   */
+  virtual int64_t AffectedRows() const;
+
+  /**
+   * Move to the next result set.
+   *
+   * @return Operation result.
+   */
+  virtual SqlResult::Type NextResultSet();
+
+ private:
+  DOCUMENTDB_NO_COPY_ASSIGNMENT(ExplainQuery);
+
+  /** Row list type. */
+  typedef std::vector< std::pair< std::string, std::string > > RowVector;
+
+  /** Explained query. */
+  DataQuery query;
+
+  /** Query executed. */
+  bool executed;
+
+  /** Fetched flag. */
+  bool fetched;
+
+  /** Columns metadata. */
+  meta::ColumnMetaVector columnsMeta;
+
+  /** Explain rows. */
+  RowVector rows;
+
+  /** Resultset cursor. */
+  RowVector::iterator cursor;
+};
+}  // namespace query
+}  // namespace odbc
+}  // namespace documentdb
+
+#endif  //_DOCUMENTDB_ODBC_QUERY_EXPLAIN_QUERY
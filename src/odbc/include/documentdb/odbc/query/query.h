@@ -60,6 +60,9 @@ struct QueryType {
     /** Type info query type. */
     TYPE_INFO,
 
+    /** Explain query type. */
+    EXPLAIN,
+
     /** Internal query, that should be parsed by a driver itself. */
     INTERNAL
   };
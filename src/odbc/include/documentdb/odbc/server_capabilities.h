@@ -0,0 +1,162 @@
+/*
+ * Copyright <2022> Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ */
+
+
+#ifndef _DOCUMENTDB_ODBC_SERVER_CAPABILITIES
+#define _DOCUMENTDB_ODBC_SERVER_CAPABILITIES
+
+#include <stdint.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "documentdb/odbc/common/common.h"
+#include "documentdb/odbc/common/concurrent.h"
+#include "documentdb/odbc/config/configuration.h"
+#include "mongocxx/database.hpp"
+
+namespace documentdb {
+namespace odbc {
+/**
+ * Capabilities of a server, as reported by the buildInfo and isMaster
+ * commands.
+ */
+struct ServerCapabilities {
+  /** Server version string. */
+  std::string version;
+
+  /** Server version components. */
+  std::vector< int64_t > versionArray;
+
+  /** Highest wire protocol version supported by the server. */
+  int32_t maxWireVersion = 0;
+
+  /** Replica set name, or empty if not a replica set. */
+  std::string setName;
+
+  /**
+   * Get the version in the SQL_DBMS_VER format: ##.##.####.
+   *
+   * @return Formatted version, or empty if unknown.
+   */
+  std::string GetDbmsVer() const;
+
+  /**
+   * Check if the $sample stage is supported.
+   *
+   * @return @c true if supported.
+   */
+  bool IsSampleSupported() const;
+};
+
+/**
+ * Process-wide cache of server capabilities, keyed by host and replica set.
+ *
+ * The capabilities are fetched by the first connection that needs them, and
+ * reused by the later connections to the same server. An entry is dropped
+ * when a connection to the server is found to be dead, so that it is
+ * fetched again by the next connection.
+ */
+class ServerCapabilitiesCache {
+ public:
+  /**
+   * Get the cache instance.
+   *
+   * @return Instance.
+   */
+  static ServerCapabilitiesCache& GetInstance();
+
+  /**
+   * Make the cache key of a configuration.
+   *
+   * @param config Configuration.
+   * @return Cache key.
+   */
+  static std::string MakeKey(const config::Configuration& config);
+
+  /**
+   * Fetch the capabilities of a server.
+   *
+   * @param db Database to run the commands on.
+   * @param caps Resulting capabilities.
+   * @return @c true if the server answered the commands.
+   * @throw mongocxx::exception on failure.
+   */
+  static bool Fetch(mongocxx::database& db, ServerCapabilities& caps);
+
+  /**
+   * Get the cached capabilities of a server.
+   *
+   * @param key Cache key.
+   * @param caps Resulting capabilities.
+   * @return @c true if found.
+   */
+  bool Get(const std::string& key, ServerCapabilities& caps);
+
+  /**
+   * Cache the capabilities of a server.
+   *
+   * @param key Cache key.
+   * @param caps Capabilities.
+   */
+  void Put(const std::string& key, const ServerCapabilities& caps);
+
+  /**
+   * Drop the cached capabilities of a server.
+   *
+   * @param key Cache key.
+   */
+  void Invalidate(const std::string& key);
+
+  /**
+   * Get the number of lookups answered from the cache.
+   *
+   * @return Number of hits.
+   */
+  size_t GetHitCount();
+
+  /**
+   * Get the number of capabilities fetched from a server and cached.
+   *
+   * @return Number of fetches.
+   */
+  size_t GetFetchCount();
+
+ private:
+  DOCUMENTDB_NO_COPY_ASSIGNMENT(ServerCapabilitiesCache);
+
+  /**
+   * Constructor.
+   */
+  ServerCapabilitiesCache() = default;
+
+  /** Lock. */
+  common::concurrent::CriticalSection lock;
+
+  /** Capabilities by key. */
+  std::map< std::string, ServerCapabilities > entries;
+
+  /** Number of lookups answered from the cache. */
+  size_t hits = 0;
+
+  /** Number of capabilities cached after a fetch. */
+  size_t fetches = 0;
+};
+}  // namespace odbc
+}  // namespace documentdb
+
+#endif  //_DOCUMENTDB_ODBC_SERVER_CAPABILITIES
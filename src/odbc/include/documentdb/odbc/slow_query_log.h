@@ -0,0 +1,122 @@
+/*
+ * Copyright <2022> Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ */
+
+
+#ifndef _DOCUMENTDB_ODBC_SLOW_QUERY_LOG
+#define _DOCUMENTDB_ODBC_SLOW_QUERY_LOG
+
+#include <stdint.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "documentdb/odbc/common/common.h"
+#include "documentdb/odbc/common/concurrent.h"
+
+namespace documentdb {
+namespace odbc {
+/**
+ * Log of the queries whose driver time, see StatementTrace::GetDriverMicros,
+ * is longer than the SLOW_QUERY_THRESHOLD_MS of their connection. It is written whatever the log level, one JSON object
+ * per line, to the file docdb_odbc_slow_YYYYMMDD.log in the log path of the
+ * driver log.
+ */
+class SlowQueryLog {
+ public:
+  /**
+   * A slow query.
+   */
+  struct Entry {
+    /** SQL of the query. */
+    std::string sql;
+
+    /** Collection the query read. */
+    std::string collection;
+
+    /** Aggregate pipeline stages, as JSON documents. */
+    std::vector< std::string > stages;
+
+    /** Comment sent to the server with the aggregate command. */
+    std::string comment;
+
+    /** Threshold of the connection, in milliseconds. */
+    int32_t thresholdMs = 0;
+
+    /** Time from the execution to the last row, in microseconds. */
+    int64_t elapsedMicros = 0;
+
+    /**
+     * Time spent in the driver and waiting for the server, in microseconds.
+     */
+    int64_t driverMicros = 0;
+
+    /** Statement trace of the query, as a JSON object. */
+    std::string trace;
+  };
+
+  /**
+   * Get the slow query log.
+   *
+   * @return Slow query log instance.
+   */
+  static SlowQueryLog& GetInstance();
+
+  /**
+   * Format an entry as a JSON object. The SQL and the pipeline are redacted
+   * unless the driver log level is DEBUG; in the JSON log format only the
+   * literals of the SQL are, see Logger::RedactLiterals.
+   *
+   * @param entry Slow query.
+   * @return JSON object, on a single line.
+   */
+  static std::string Format(const Entry& entry);
+
+  /**
+   * Append an entry to the log file.
+   *
+   * @param entry Slow query.
+   */
+  void Write(const Entry& entry);
+
+  /**
+   * Get the path of the log file last written to.
+   *
+   * @return File path, empty if nothing was written.
+   */
+  std::string GetFilePath();
+
+ private:
+  DOCUMENTDB_NO_COPY_ASSIGNMENT(SlowQueryLog);
+
+  /**
+   * Constructor.
+   */
+  SlowQueryLog() = default;
+
+  /** Mutex for writes synchronization. */
+  common::concurrent::CriticalSection mutex;
+
+  /** File stream. */
+  std::ofstream fileStream;
+
+  /** Path of the open file. */
+  std::string filePath;
+};
+}  // namespace odbc
+}  // namespace documentdb
+
+#endif  //_DOCUMENTDB_ODBC_SLOW_QUERY_LOG
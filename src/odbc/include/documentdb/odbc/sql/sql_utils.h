@@ -52,6 +52,15 @@ inline OdbcExpected< bool > TokenToBoolean(const SqlToken& token) {
  * @return @c true if internal.
  */
 bool IsInternalCommand(const std::string& sql);
+
+/**
+ * Check if the SQL is an EXPLAIN pseudo-statement.
+ *
+ * @param sql SQL request string.
+ * @param explainedSql Resulting SQL query that follows the EXPLAIN keyword.
+ * @return @c true if the request is EXPLAIN followed by a query.
+ */
+bool ParseExplainCommand(const std::string& sql, std::string& explainedSql);
 }  // namespace sql_utils
 }  // namespace odbc
 }  // namespace documentdb
@@ -0,0 +1,189 @@
+/*
+ * Copyright <2022> Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ */
+
+
+#ifndef _DOCUMENTDB_ODBC_SSH_TUNNEL_MANAGER
+#define _DOCUMENTDB_ODBC_SSH_TUNNEL_MANAGER
+
+#include <map>
+#include <string>
+
+#include "documentdb/odbc/common/common.h"
+#include "documentdb/odbc/common/concurrent.h"
+#include "documentdb/odbc/config/configuration.h"
+#include "documentdb/odbc/documentdb_error.h"
+#include "documentdb/odbc/jni/documentdb_connection.h"
+#include "documentdb/odbc/jni/java.h"
+
+namespace documentdb {
+namespace odbc {
+/**
+ * Process-wide manager of the internal SSH tunnels.
+ *
+ * Connections that go through the same SSH host, user and key to the same
+ * cluster share one tunnel (one SSH session and local port). The tunnel is
+ * opened by a dedicated JDBC connection, and is closed when the last
+ * connection using it releases it. Both the JDBC and the native connections
+ * of an ODBC connection go through the local port of the shared tunnel.
+ */
+class SshTunnelManager {
+ public:
+  /**
+   * Get the manager instance.
+   *
+   * @return Instance.
+   */
+  static SshTunnelManager& GetInstance();
+
+  /**
+   * Check if the configuration uses an internal SSH tunnel.
+   *
+   * @param config Configuration.
+   * @return @c true if a tunnel is needed.
+   */
+  static bool IsTunnelConfigured(const config::Configuration& config);
+
+  /**
+   * Make the tunnel key of a configuration: the SSH host, user, key and
+   * host key checking settings, and the target host and port. The key
+   * passphrase is only included as a hash.
+   *
+   * @param config Configuration.
+   * @return Tunnel key.
+   */
+  static std::string MakeKey(const config::Configuration& config);
+
+  /**
+   * Make the configuration that connects through the local port of a
+   * tunnel instead of opening its own tunnel. Invalid host names are
+   * allowed, as the server certificate is not issued for localhost, unless
+   * TLS_ALLOW_INVALID_HOSTNAMES is set explicitly.
+   *
+   * @param config Configuration.
+   * @param localPort Local port of the tunnel.
+   * @return Tunneled configuration.
+   */
+  static config::Configuration MakeTunneledConfiguration(
+      const config::Configuration& config, int32_t localPort);
+
+  /**
+   * Take a reference to the tunnel of the configuration, opening it if
+   * needed. Each successful call must be paired with a call to Release.
+   *
+   * @param config Configuration.
+   * @param ctx JNI context.
+   * @param key Resulting key of the tunnel instance, made of the tunnel key
+   *     and a unique number.
+   * @param localPort Resulting local port of the tunnel.
+   * @param err Error.
+   * @return @c true on success.
+   */
+  bool Acquire(const config::Configuration& config,
+               common::concurrent::SharedPointer< jni::java::JniContext > ctx,
+               std::string& key, int32_t& localPort, DocumentDbError& err);
+
+  /**
+   * Replace a tunnel that no longer forwards connections. The tunnel is no
+   * longer shared with new connections, and the reference to it is swapped
+   * for a reference to a new tunnel, or to the one another connection
+   * already opened to replace it.
+   *
+   * @param config Configuration.
+   * @param ctx JNI context.
+   * @param key Key of the broken tunnel instance. Replaced on success.
+   * @param localPort Local port of the tunnel. Replaced on success.
+   * @param err Error.
+   * @return @c true on success. On failure, the reference to the broken
+   *     tunnel is kept and must still be released.
+   */
+  bool Reacquire(const config::Configuration& config,
+                 common::concurrent::SharedPointer< jni::java::JniContext > ctx,
+                 std::string& key, int32_t& localPort, DocumentDbError& err);
+
+  /**
+   * Release a reference to a tunnel. The tunnel is closed with its last
+   * reference.
+   *
+   * @param key Key of the tunnel instance.
+   */
+  void Release(const std::string& key);
+
+  /**
+   * Get the number of references to a tunnel.
+   *
+   * @param key Key of the tunnel instance.
+   * @return Number of references, or zero if the tunnel is not open.
+   */
+  size_t GetRefCount(const std::string& key);
+
+ private:
+  DOCUMENTDB_NO_COPY_ASSIGNMENT(SshTunnelManager);
+
+  /**
+   * Constructor.
+   */
+  SshTunnelManager() = default;
+
+  /**
+   * Forget a tunnel instance, so that it is no longer shared. Must be called
+   * with the lock held.
+   *
+   * @param key Key of the tunnel instance.
+   */
+  void Forget(const std::string& key);
+
+  /**
+   * Shared tunnel.
+   */
+  struct Tunnel {
+    /** Tunnel key, see MakeKey. */
+    std::string tunnelKey;
+
+    /** JDBC connection that owns the tunnel. */
+    common::concurrent::SharedPointer< jni::DocumentDbConnection > owner;
+
+    /** Local port of the tunnel. */
+    int32_t localPort = 0;
+
+    /** Number of connections using the tunnel. */
+    size_t refCount = 0;
+
+    /** Whether the tunnel is being opened by a connection. */
+    bool opening = false;
+  };
+
+  /** Lock. */
+  common::concurrent::CriticalSection lock;
+
+  /**
+   * Notified when a tunnel is opened or fails to open, so that a tunnel is
+   * only opened once.
+   */
+  common::concurrent::ConditionVariable opened;
+
+  /** Open tunnels by instance key. */
+  std::map< std::string, Tunnel > tunnels;
+
+  /** Instance keys of the tunnels shared with new connections, by key. */
+  std::map< std::string, std::string > currentTunnels;
+
+  /** Number of the next tunnel instance. */
+  uint64_t nextTunnelId = 1;
+};
+}  // namespace odbc
+}  // namespace documentdb
+
+#endif  //_DOCUMENTDB_ODBC_SSH_TUNNEL_MANAGER
@@ -28,6 +28,7 @@
 #include "documentdb/odbc/common_types.h"
 #include "documentdb/odbc/diagnostic/diagnosable_adapter.h"
 #include "documentdb/odbc/meta/column_meta.h"
+#include "documentdb/odbc/query/data_query_options.h"
 #include "documentdb/odbc/query/query.h"
 #include "sql/sql_set_streaming_command.h"
 
@@ -358,6 +359,20 @@ class Statement : public diagnostic::DiagnosableAdapter {
   void DescribeParam(int16_t paramNum, int16_t* dataType, SqlUlen* paramSize,
                      int16_t* decimalDigits, int16_t* nullable);
 
+  /**
+   * Get the connection id the log records of the API calls are tagged with.
+   *
+   * @return Connection id.
+   */
+  virtual uint64_t GetLogConnectionId() const;
+
+  /**
+   * Get the statement id the log records of the API calls are tagged with.
+   *
+   * @return Statement id.
+   */
+  virtual uint64_t GetLogStatementId() const;
+
  private:
   DOCUMENTDB_NO_COPY_ASSIGNMENT(Statement);
 
@@ -444,6 +459,18 @@ class Statement : public diagnostic::DiagnosableAdapter {
   SqlResult::Type InternalGetAttribute(int attr, void* buf, SQLINTEGER bufLen,
                                        SQLINTEGER* valueLen);
 
+  /**
+   * Copy a string attribute value to the application buffer.
+   *
+   * @param value Attribute value.
+   * @param buf Buffer for value.
+   * @param bufLen Buffer length in bytes.
+   * @param valueLen Resulting value length in bytes.
+   * @return Operation result.
+   */
+  SqlResult::Type GetStringAttribute(const std::string& value, void* buf,
+                                     SQLINTEGER bufLen, SQLINTEGER* valueLen);
+
   /**
    * Get number parameters required by the prepared statement.
    *
@@ -724,6 +751,9 @@ class Statement : public diagnostic::DiagnosableAdapter {
 
   /** Query timeout in seconds. */
   int32_t timeout;
+
+  /** Statement level data query options. */
+  query::DataQueryOptions dataQueryOptions;
 };
 }  // namespace odbc
 }  // namespace documentdb
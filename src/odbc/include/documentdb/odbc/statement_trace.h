@@ -0,0 +1,174 @@
+/*
+ * Copyright <2022> Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ */
+
+#ifndef _DOCUMENTDB_ODBC_STATEMENT_TRACE
+#define _DOCUMENTDB_ODBC_STATEMENT_TRACE
+
+#include <stdint.h>
+
+#include <chrono>
+#include <string>
+
+#include "documentdb/odbc/allocation_tracker.h"
+#include "documentdb/odbc/common/common.h"
+
+namespace documentdb {
+namespace odbc {
+/**
+ * Time spent in each phase of a statement, and counters of its results.
+ * Updated by the thread running the statement, including from the MongoDB
+ * driver monitoring callbacks while the trace is the current one of the
+ * thread, see StatementTrace::Scope.
+ */
+struct StatementTrace {
+  /** Clock of the phase timestamps. */
+  typedef std::chrono::steady_clock Clock;
+
+  /**
+   * Makes a trace the current one of the thread while in scope.
+   */
+  class Scope {
+   public:
+    /**
+     * Constructor.
+     *
+     * @param trace Trace to make current.
+     */
+    explicit Scope(StatementTrace& trace);
+
+    /**
+     * Destructor. Restores the previous current trace.
+     */
+    ~Scope();
+
+   private:
+    DOCUMENTDB_NO_COPY_ASSIGNMENT(Scope);
+
+    /** Previous current trace. */
+    StatementTrace* previous;
+  };
+
+  /** When the statement was executed. */
+  Clock::time_point started;
+
+  /** When the last row was fetched or the statement closed. */
+  Clock::time_point finished;
+
+  /** Time spent translating the SQL to a pipeline, in microseconds. */
+  int64_t translateMicros = 0;
+
+  /** Time spent parsing the pipeline stages, in microseconds. */
+  int64_t parseMicros = 0;
+
+  /** Time until the first batch was received, in microseconds. */
+  int64_t firstBatchMicros = 0;
+
+  /** Time spent waiting for getMore replies, in microseconds. */
+  int64_t getMoreMicros = 0;
+
+  /** Time spent converting BSON values to ODBC buffers, in microseconds. */
+  int64_t convertMicros = 0;
+
+  /** Number of rows fetched. */
+  uint64_t rows = 0;
+
+  /** Size of the replies received, in bytes. */
+  uint64_t bytes = 0;
+
+  /** Number of batches received. */
+  uint64_t batches = 0;
+
+  /** Number of column values converted. */
+  uint64_t conversions = 0;
+
+  /** Number of truncation warnings. */
+  uint64_t truncations = 0;
+
+  /**
+   * Memory allocated while the trace is current. Only counted when the
+   * driver is built with WITH_ALLOCATION_TRACKING.
+   */
+  AllocationTracker::Stats allocations;
+
+  /**
+   * Clear the trace and set its start time to now.
+   */
+  void Start();
+
+  /**
+   * Set the finish time to now, unless it is already set.
+   */
+  void Finish();
+
+  /**
+   * Count a reply of the server to a command of the statement.
+   *
+   * @param command Command name.
+   * @param durationMicros Round-trip time of the command, in microseconds.
+   * @param length Size of the reply, in bytes.
+   */
+  void AddReply(const std::string& command, int64_t durationMicros,
+                uint64_t length);
+
+  /**
+   * Get the time from the execution to the finish time, or to now if the
+   * trace is not finished.
+   *
+   * @return Elapsed time in microseconds, 0 if the statement was not
+   *  executed.
+   */
+  int64_t GetElapsedMicros() const;
+
+  /**
+   * Get the time spent in the driver and waiting for the server: the
+   * translation, parsing, first batch, getMore and conversion times. Unlike
+   * the elapsed time, it does not include the time the application spends
+   * between fetches.
+   *
+   * @return Driver time in microseconds.
+   */
+  int64_t GetDriverMicros() const;
+
+  /**
+   * Format the trace as a JSON object.
+   *
+   * @return JSON object, or "{}" if the statement was not executed.
+   */
+  std::string ToJson() const;
+
+  /**
+   * Get the current trace of the thread.
+   *
+   * @return Current trace or nullptr.
+   */
+  static StatementTrace* GetCurrent();
+
+  /**
+   * Get the time elapsed since the given time point.
+   *
+   * @param start Time point.
+   * @return Elapsed time, in microseconds.
+   */
+  static int64_t MicrosSince(Clock::time_point start) {
+    return std::chrono::duration_cast< std::chrono::microseconds >(
+               Clock::now() - start)
+        .count();
+  }
+};
+}  // namespace odbc
+}  // namespace documentdb
+
+#endif  //_DOCUMENTDB_ODBC_STATEMENT_TRACE
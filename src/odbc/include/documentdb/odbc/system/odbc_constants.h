@@ -34,6 +34,64 @@
 #include <odbcinst.h>
 #include <sqlext.h>
 
+// Driver-specific statement attributes.
+
+/** Number of _id range partitions used to scan a collection in parallel. */
+#define SQL_ATTR_DOCUMENTDB_PARALLEL_SCAN_PARTITIONS \
+  (SQL_DRIVER_STMT_ATTR_BASE + 1)
+
+/** Allow aggregate stages to write temporary files (SQL_TRUE/SQL_FALSE). */
+#define SQL_ATTR_DOCUMENTDB_ALLOW_DISK_USE (SQL_DRIVER_STMT_ATTR_BASE + 2)
+
+/** Index hint: an index name or a JSON key pattern. */
+#define SQL_ATTR_DOCUMENTDB_HINT (SQL_DRIVER_STMT_ATTR_BASE + 3)
+
+/** Comment attached to the aggregate command. */
+#define SQL_ATTR_DOCUMENTDB_COMMENT (SQL_DRIVER_STMT_ATTR_BASE + 4)
+
+/** Read concern level, e.g. "majority". */
+#define SQL_ATTR_DOCUMENTDB_READ_CONCERN (SQL_DRIVER_STMT_ATTR_BASE + 5)
+
+/** Read preference, e.g. "secondary_preferred". */
+#define SQL_ATTR_DOCUMENTDB_READ_PREFERENCE (SQL_DRIVER_STMT_ATTR_BASE + 6)
+
+/** Collation as a JSON document. */
+#define SQL_ATTR_DOCUMENTDB_COLLATION (SQL_DRIVER_STMT_ATTR_BASE + 7)
+
+/** Cursor batch size. Zero uses the DEFAULT_FETCH_SIZE connection option. */
+#define SQL_ATTR_DOCUMENTDB_BATCH_SIZE (SQL_DRIVER_STMT_ATTR_BASE + 8)
+
+/** Maximum replication lag of a secondary to read from, in seconds. */
+#define SQL_ATTR_DOCUMENTDB_MAX_STALENESS_SECONDS \
+  (SQL_DRIVER_STMT_ATTR_BASE + 9)
+
+/** Phase timings and counters of the last execution, as JSON (read only). */
+#define SQL_ATTR_DOCUMENTDB_STATEMENT_TRACE (SQL_DRIVER_STMT_ATTR_BASE + 10)
+
+// Driver-specific connection attributes.
+
+/** Number of attempts to restore the lost connection (read only). */
+#define SQL_ATTR_DOCUMENTDB_RECONNECT_ATTEMPTS (SQL_DRIVER_CONN_ATTR_BASE + 1)
+
+/** Number of reconnects that failed after all attempts (read only). */
+#define SQL_ATTR_DOCUMENTDB_RECONNECT_FAILURES (SQL_DRIVER_CONN_ATTR_BASE + 2)
+
+/** Total time spent reconnecting, in milliseconds (read only). */
+#define SQL_ATTR_DOCUMENTDB_RECONNECT_TIME_MS (SQL_DRIVER_CONN_ATTR_BASE + 3)
+
+/** Size of the replies received, decompressed, in bytes (read only). */
+#define SQL_ATTR_DOCUMENTDB_REPLY_BYTES (SQL_DRIVER_CONN_ATTR_BASE + 4)
+
+/** Number of replies received (read only). */
+#define SQL_ATTR_DOCUMENTDB_MESSAGES_RECEIVED (SQL_DRIVER_CONN_ATTR_BASE + 5)
+
+/** Statements run per server, as "host:port=count;..." (read only). */
+#define SQL_ATTR_DOCUMENTDB_NODE_STATEMENT_COUNTS \
+  (SQL_DRIVER_CONN_ATTR_BASE + 7)
+
+/** Number of log records dropped by the asynchronous logger (read only). */
+#define SQL_ATTR_DOCUMENTDB_LOG_RECORDS_DROPPED (SQL_DRIVER_CONN_ATTR_BASE + 8)
+
 #ifndef UNREFERENCED_PARAMETER
 #define UNREFERENCED_PARAMETER(x) (void)(x)
 #endif  // UNREFERENCED_PARAMETER
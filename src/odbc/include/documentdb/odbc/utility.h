@@ -235,6 +235,14 @@ std::vector< SQLWCHAR > ToWCHARVector(const char* value);
  * @return standard string containing the formated hex dump
  */
 std::string HexDump(const void* data, size_t count);
+
+/**
+ * Escape a string for use as a JSON string value. The quotes around the
+ * value are not added.
+ * @param value String to escape.
+ * @return Escaped string.
+ */
+std::string EscapeJson(const std::string& value);
 }  // namespace utility
 }  // namespace odbc
 }  // namespace documentdb
@@ -0,0 +1,94 @@
+/*
+ * Copyright <2022> Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ */
+
+
+#ifndef _DOCUMENTDB_ODBC_WIRE_STATISTICS
+#define _DOCUMENTDB_ODBC_WIRE_STATISTICS
+
+#include <stdint.h>
+
+#include <atomic>
+#include <map>
+#include <sstream>
+#include <string>
+
+#include "documentdb/odbc/common/concurrent.h"
+
+namespace documentdb {
+namespace odbc {
+/**
+ * Wire traffic counters of a connection. Updated by the MongoDB driver
+ * monitoring callbacks, which run on any thread.
+ */
+struct WireStatistics {
+  /**
+   * Size of the replies received from the server, in bytes. The command
+   * monitoring callbacks see the decompressed replies, so this is not the
+   * size on the wire.
+   */
+  std::atomic< uint64_t > replyBytes{0};
+
+  /** Number of replies received from the server. */
+  std::atomic< uint64_t > messagesReceived{0};
+
+  /**
+   * Count a query sent to a server.
+   *
+   * @param node Server address as host:port.
+   */
+  void AddNodeQuery(const std::string& node) {
+    common::concurrent::CsLockGuard guard(nodeLock);
+
+    ++queriesPerNode[node];
+  }
+
+  /**
+   * Get the number of queries sent to each server.
+   *
+   * @return Counts as "host:port=count;...", ordered by address.
+   */
+  std::string GetNodeQueries() const {
+    common::concurrent::CsLockGuard guard(nodeLock);
+
+    std::stringstream res;
+    for (auto const& node : queriesPerNode) {
+      res << node.first << '=' << node.second << ';';
+    }
+    return res.str();
+  }
+
+  /**
+   * Reset the counters.
+   */
+  void Reset() {
+    replyBytes = 0;
+    messagesReceived = 0;
+
+    common::concurrent::CsLockGuard guard(nodeLock);
+    queriesPerNode.clear();
+  }
+
+ private:
+  /** Guards queriesPerNode. */
+  mutable common::concurrent::CriticalSection nodeLock;
+
+  /** Number of queries sent to each server, by address. */
+  std::map< std::string, uint64_t > queriesPerNode;
+};
+}  // namespace odbc
+}  // namespace documentdb
+
+#endif  //_DOCUMENTDB_ODBC_WIRE_STATISTICS
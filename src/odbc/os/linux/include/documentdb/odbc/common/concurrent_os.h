@@ -474,7 +474,13 @@ class ConditionVariable {
    */
   bool WaitFor(CriticalSection& cs, int32_t msTimeout) {
     timespec ts;
+    // The clock of the condition variable can only be set where supported,
+    // see the constructor.
+#if defined(__APPLE__)
+    int err = clock_gettime(CLOCK_REALTIME, &ts);
+#else
     int err = clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
     assert(!err);
 
     DOCUMENTDB_UNUSED(err);
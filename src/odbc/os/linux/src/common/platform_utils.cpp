@@ -50,7 +50,7 @@ bool ToGmTime(time_t in, tm& out) {
 }
 
 bool ToLocalTime(time_t in, tm& out) {
-  return localtime_r(&in, &out) == 0;
+  return localtime_r(&in, &out) != nullptr;
 }
 
 std::string GetEnv(const std::string& name) {
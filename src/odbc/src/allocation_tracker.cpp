@@ -0,0 +1,217 @@
+/*
+ * Copyright <2022> Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ */
+
+
+#include "documentdb/odbc/allocation_tracker.h"
+
+#include <sstream>
+
+#include "documentdb/odbc/statement_trace.h"
+
+#ifdef DOCUMENTDB_WITH_ALLOCATION_TRACKING
+#include <cstdlib>
+#include <new>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#else
+#include <malloc.h>
+#endif
+#endif  // DOCUMENTDB_WITH_ALLOCATION_TRACKING
+
+using documentdb::odbc::AllocationTracker;
+
+namespace {
+/** Current component of the thread. */
+thread_local AllocationTracker::Component::Type currentComponent =
+    AllocationTracker::Component::OTHER;
+}  // namespace
+
+namespace documentdb {
+namespace odbc {
+AllocationTracker::Stats::Stats() : liveBytes(0), peakBytes(0) {
+  for (int i = 0; i < Component::COUNT; ++i) {
+    allocations[i] = 0;
+    bytes[i] = 0;
+  }
+}
+
+uint64_t AllocationTracker::Stats::GetAllocations() const {
+  uint64_t total = 0;
+  for (int i = 0; i < Component::COUNT; ++i)
+    total += allocations[i];
+
+  return total;
+}
+
+uint64_t AllocationTracker::Stats::GetBytes() const {
+  uint64_t total = 0;
+  for (int i = 0; i < Component::COUNT; ++i)
+    total += bytes[i];
+
+  return total;
+}
+
+std::string AllocationTracker::Stats::ToJson() const {
+  std::stringstream json;
+  json << "{\"count\":" << GetAllocations() << ",\"bytes\":" << GetBytes()
+       << ",\"peak_bytes\":" << peakBytes;
+  for (int i = 0; i < Component::COUNT; ++i) {
+    json << ",\"" << GetComponentName(static_cast< Component::Type >(i))
+         << "\":{\"count\":" << allocations[i] << ",\"bytes\":" << bytes[i]
+         << "}";
+  }
+  json << "}";
+
+  return json.str();
+}
+
+AllocationTracker::ComponentScope::ComponentScope(Component::Type component)
+    : previous(currentComponent) {
+  currentComponent = component;
+}
+
+AllocationTracker::ComponentScope::~ComponentScope() {
+  currentComponent = previous;
+}
+
+bool AllocationTracker::IsEnabled() {
+#ifdef DOCUMENTDB_WITH_ALLOCATION_TRACKING
+  return true;
+#else
+  return false;
+#endif  // DOCUMENTDB_WITH_ALLOCATION_TRACKING
+}
+
+const char* AllocationTracker::GetComponentName(Component::Type component) {
+  switch (component) {
+    case Component::CURSOR:
+      return "cursor";
+
+    case Component::ROW:
+      return "row";
+
+    case Component::CONVERSION:
+      return "conversion";
+
+    case Component::DIAGNOSTICS:
+      return "diagnostics";
+
+    case Component::JNI:
+      return "jni";
+
+    default:
+      return "other";
+  }
+}
+
+void AllocationTracker::Allocated(size_t size) {
+  StatementTrace* trace = StatementTrace::GetCurrent();
+  if (!trace)
+    return;
+
+  Stats& stats = trace->allocations;
+  ++stats.allocations[currentComponent];
+  stats.bytes[currentComponent] += size;
+  stats.liveBytes += static_cast< int64_t >(size);
+  if (stats.liveBytes > stats.peakBytes)
+    stats.peakBytes = stats.liveBytes;
+}
+
+void AllocationTracker::Released(size_t size) {
+  StatementTrace* trace = StatementTrace::GetCurrent();
+  if (trace)
+    trace->allocations.liveBytes -= static_cast< int64_t >(size);
+}
+}  // namespace odbc
+}  // namespace documentdb
+
+#ifdef DOCUMENTDB_WITH_ALLOCATION_TRACKING
+namespace {
+/**
+ * Get the usable size of a block returned by malloc. Used for both the
+ * allocations and the releases, so that a block released by the driver is
+ * counted with the same size whichever operator new allocated it.
+ */
+size_t UsableSize(void* ptr) {
+#if defined(_WIN32)
+  return _msize(ptr);
+#elif defined(__APPLE__)
+  return malloc_size(ptr);
+#else
+  return malloc_usable_size(ptr);
+#endif
+}
+
+void* TrackedAllocate(size_t size) {
+  void* ptr = std::malloc(size == 0 ? 1 : size);
+  if (ptr)
+    AllocationTracker::Allocated(UsableSize(ptr));
+
+  return ptr;
+}
+
+void TrackedRelease(void* ptr) {
+  if (!ptr)
+    return;
+
+  AllocationTracker::Released(UsableSize(ptr));
+  std::free(ptr);
+}
+}  // namespace
+
+void* operator new(size_t size) {
+  void* ptr = TrackedAllocate(size);
+  if (!ptr)
+    throw std::bad_alloc();
+
+  return ptr;
+}
+
+void* operator new[](size_t size) {
+  void* ptr = TrackedAllocate(size);
+  if (!ptr)
+    throw std::bad_alloc();
+
+  return ptr;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  return TrackedAllocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+  return TrackedAllocate(size);
+}
+
+void operator delete(void* ptr) noexcept {
+  TrackedRelease(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+  TrackedRelease(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+  TrackedRelease(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+  TrackedRelease(ptr);
+}
+#endif  // DOCUMENTDB_WITH_ALLOCATION_TRACKING
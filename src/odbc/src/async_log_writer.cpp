@@ -0,0 +1,177 @@
+/*
+ * Copyright <2022> Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ */
+
+#include "documentdb/odbc/async_log_writer.h"
+
+using documentdb::odbc::common::concurrent::CsLockGuard;
+
+namespace {
+/** Longest time the writer thread sleeps when it finds the buffer empty. */
+const std::chrono::milliseconds POLL_INTERVAL(10);
+
+/** Maximum number of records handed over to the sink at once. */
+const size_t MAX_BATCH_SIZE = 1024;
+
+/** Number of times a blocked push yields before it starts sleeping. */
+const int MAX_PUSH_YIELDS = 16;
+
+/** Time a blocked push sleeps between attempts. */
+const std::chrono::microseconds PUSH_BACKOFF(100);
+}  // namespace
+
+namespace documentdb {
+namespace odbc {
+LogRingBuffer::LogRingBuffer(size_t capacity) : enqueuePos(0), dequeuePos(0) {
+  size_t size = 2;
+  while (size < capacity)
+    size <<= 1;
+
+  cells.reset(new Cell[size]);
+  for (size_t i = 0; i < size; ++i)
+    cells[i].sequence.store(i, std::memory_order_relaxed);
+
+  mask = size - 1;
+}
+
+bool LogRingBuffer::TryPush(std::string& record) {
+  size_t pos = enqueuePos.load(std::memory_order_relaxed);
+  Cell* cell;
+  for (;;) {
+    cell = &cells[pos & mask];
+    size_t seq = cell->sequence.load(std::memory_order_acquire);
+    if (seq == pos) {
+      // The slot is free, claim it.
+      if (enqueuePos.compare_exchange_weak(pos, pos + 1,
+                                           std::memory_order_relaxed))
+        break;
+    } else if (seq < pos) {
+      // The slot still holds the record of the previous lap.
+      return false;
+    } else {
+      // Another producer claimed the slot.
+      pos = enqueuePos.load(std::memory_order_relaxed);
+    }
+  }
+
+  cell->record.swap(record);
+  cell->sequence.store(pos + 1, std::memory_order_release);
+
+  return true;
+}
+
+bool LogRingBuffer::TryPop(std::string& record) {
+  Cell& cell = cells[dequeuePos & mask];
+  if (cell.sequence.load(std::memory_order_acquire) != dequeuePos + 1)
+    return false;
+
+  record.swap(cell.record);
+  cell.record.clear();
+  cell.sequence.store(dequeuePos + mask + 1, std::memory_order_release);
+  ++dequeuePos;
+
+  return true;
+}
+
+AsyncLogWriter::AsyncLogWriter(size_t capacity,
+                               std::chrono::milliseconds flushInterval,
+                               Sink sink)
+    : buffer(capacity), flushInterval(flushInterval), sink(std::move(sink)) {
+  thread = std::thread(&AsyncLogWriter::Run, this);
+}
+
+AsyncLogWriter::~AsyncLogWriter() {
+  stopping = true;
+  WakeUp();
+  if (thread.joinable())
+    thread.join();
+}
+
+bool AsyncLogWriter::Push(const std::string& record, bool block) {
+  std::string copy(record);
+  for (int attempt = 0; !buffer.TryPush(copy); ++attempt) {
+    if (!block || stopping) {
+      ++dropped;
+      return false;
+    }
+    // Wake the writer thread up, then back off.
+    if (attempt == 0)
+      WakeUp();
+    if (attempt < MAX_PUSH_YIELDS)
+      std::this_thread::yield();
+    else
+      std::this_thread::sleep_for(PUSH_BACKOFF);
+  }
+  ++pushed;
+
+  return true;
+}
+
+void AsyncLogWriter::Flush() {
+  uint64_t target = pushed;
+  WakeUp();
+  while (written < target && !stopping)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+  sink(std::vector< std::string >(), true);
+}
+
+void AsyncLogWriter::Run() {
+  std::vector< std::string > batch;
+  batch.reserve(MAX_BATCH_SIZE);
+  std::string record;
+  bool unflushed = false;
+  auto lastFlush = std::chrono::steady_clock::now();
+
+  for (;;) {
+    // Read the flag first so records queued before the stop are written.
+    bool stop = stopping;
+
+    while (batch.size() < MAX_BATCH_SIZE && buffer.TryPop(record))
+      batch.push_back(std::move(record));
+    bool drained = batch.size() < MAX_BATCH_SIZE;
+    bool idle = batch.empty();
+
+    auto now = std::chrono::steady_clock::now();
+    bool flush = (stop && drained) || now - lastFlush >= flushInterval;
+    if (!batch.empty() || (flush && unflushed)) {
+      sink(batch, flush);
+      written += batch.size();
+      unflushed = !flush;
+      batch.clear();
+    }
+    if (flush)
+      lastFlush = now;
+
+    if (stop && drained)
+      break;
+
+    if (idle) {
+      CsLockGuard guard(wakeUpLock);
+      if (!wakeUpRequested)
+        wakeUpCondition.WaitFor(wakeUpLock,
+                                static_cast< int32_t >(POLL_INTERVAL.count()));
+      wakeUpRequested = false;
+    }
+  }
+}
+
+void AsyncLogWriter::WakeUp() {
+  CsLockGuard guard(wakeUpLock);
+  wakeUpRequested = true;
+  wakeUpCondition.NotifyOne();
+}
+}  // namespace odbc
+}  // namespace documentdb
@@ -202,6 +202,43 @@ DOCUMENTDB_IMPORT_EXPORT bool AllDigits(const std::string& val) {
   return i == val.end();
 }
 
+DOCUMENTDB_IMPORT_EXPORT void AppendEscapedJson(std::string& out,
+                                                const std::string& value) {
+  static const char HEX_DIGITS[] = "0123456789abcdef";
+
+  out.reserve(out.size() + value.size());
+  for (std::string::const_iterator it = value.begin(); it != value.end();
+       ++it) {
+    const unsigned char c = static_cast< unsigned char >(*it);
+    switch (c) {
+      case '"':
+        out.append("\\\"");
+        break;
+      case '\\':
+        out.append("\\\\");
+        break;
+      case '\n':
+        out.append("\\n");
+        break;
+      case '\r':
+        out.append("\\r");
+        break;
+      case '\t':
+        out.append("\\t");
+        break;
+      default:
+        if (c < 0x20) {
+          out.append("\\u00");
+          out.push_back(HEX_DIGITS[c >> 4]);
+          out.push_back(HEX_DIGITS[c & 0xf]);
+        } else {
+          out.push_back(*it);
+        }
+        break;
+    }
+  }
+}
+
 }  // namespace common
 }  // namespace odbc
 }  // namespace documentdb
@@ -17,6 +17,7 @@
 #include "documentdb/odbc/config/configuration.h"
 
 #include <iterator>
+#include <set>
 #include <sstream>
 #include <string>
 
@@ -65,6 +66,9 @@ const std::string Configuration::DefaultValue::sshKnownHostsFile = "";
 const LogLevel::Type Configuration::DefaultValue::logLevel =
     LogLevel::Type::ERROR_LEVEL;
 const std::string Configuration::DefaultValue::logPath = DEFAULT_LOG_PATH;
+const bool Configuration::DefaultValue::logAsync = false;
+const std::string Configuration::DefaultValue::logOverflow = "block";
+const std::string Configuration::DefaultValue::logFormat = "text";
 
 // Additional options
 const std::string Configuration::DefaultValue::appName =
@@ -75,6 +79,28 @@ const ReadPreference::Type Configuration::DefaultValue::readPreference =
 const std::string Configuration::DefaultValue::replicaSet = "";
 const bool Configuration::DefaultValue::retryReads = true;
 const int32_t Configuration::DefaultValue::defaultFetchSize = 2000;
+const int32_t Configuration::DefaultValue::parallelScanPartitions = 0;
+const bool Configuration::DefaultValue::approximateCount = false;
+const bool Configuration::DefaultValue::allowDiskUse = false;
+const ReadConcern::Type Configuration::DefaultValue::readConcern =
+    ReadConcern::Type::LOCAL;
+const std::string Configuration::DefaultValue::comment = "";
+const int32_t Configuration::DefaultValue::connectionPoolSize = 0;
+const int32_t Configuration::DefaultValue::connectionPoolIdleTimeout = 60;
+const int32_t Configuration::DefaultValue::clientPoolSize = 100;
+const int32_t Configuration::DefaultValue::reconnectAttempts = 3;
+const int32_t Configuration::DefaultValue::reconnectBackoffMs = 100;
+const std::string Configuration::DefaultValue::compressors = "";
+const int32_t Configuration::DefaultValue::zlibCompressionLevel = -1;
+const bool Configuration::DefaultValue::analyticsRouting = false;
+const int32_t Configuration::DefaultValue::localThresholdMs = 15;
+const int32_t Configuration::DefaultValue::poolPrewarmSize = 0;
+const std::string Configuration::DefaultValue::warmUpSqlFile = "";
+const std::string Configuration::DefaultValue::metricsPath = "";
+const int32_t Configuration::DefaultValue::metricsPort = 0;
+const int32_t Configuration::DefaultValue::metricsInterval = 10;
+const int32_t Configuration::DefaultValue::diagRecordLimit = 1000;
+const int32_t Configuration::DefaultValue::slowQueryThresholdMs = 0;
 
 std::string Configuration::ToConnectString() const {
   ArgumentMap arguments;
@@ -369,6 +395,45 @@ bool Configuration::IsLogPathSet() const {
   return logPath.IsSet();
 }
 
+bool Configuration::IsLogAsync() const {
+  return logAsync.GetValue();
+}
+
+void Configuration::SetLogAsync(bool logAsync) {
+  this->logAsync.SetValue(logAsync);
+  Logger::GetLoggerInstance()->SetAsync(logAsync);
+}
+
+bool Configuration::IsLogAsyncSet() const {
+  return logAsync.IsSet();
+}
+
+const std::string& Configuration::GetLogOverflow() const {
+  return logOverflow.GetValue();
+}
+
+void Configuration::SetLogOverflow(const std::string& policy) {
+  this->logOverflow.SetValue(policy);
+  Logger::GetLoggerInstance()->SetDropOnOverflow(policy == "drop");
+}
+
+bool Configuration::IsLogOverflowSet() const {
+  return logOverflow.IsSet();
+}
+
+const std::string& Configuration::GetLogFormat() const {
+  return logFormat.GetValue();
+}
+
+void Configuration::SetLogFormat(const std::string& format) {
+  this->logFormat.SetValue(format);
+  Logger::GetLoggerInstance()->SetJsonFormat(format == "json");
+}
+
+bool Configuration::IsLogFormatSet() const {
+  return logFormat.IsSet();
+}
+
 ScanMethod::Type Configuration::GetScanMethod() const {
   return scanMethod.GetValue();
 }
@@ -453,6 +518,280 @@ bool Configuration::IsDefaultFetchSizeSet() const {
   return defaultFetchSize.IsSet();
 }
 
+int32_t Configuration::GetParallelScanPartitions() const {
+  return parallelScanPartitions.GetValue();
+}
+
+void Configuration::SetParallelScanPartitions(int32_t partitions) {
+  this->parallelScanPartitions.SetValue(partitions);
+}
+
+bool Configuration::IsParallelScanPartitionsSet() const {
+  return parallelScanPartitions.IsSet();
+}
+
+bool Configuration::IsApproximateCount() const {
+  return approximateCount.GetValue();
+}
+
+void Configuration::SetApproximateCount(bool val) {
+  this->approximateCount.SetValue(val);
+}
+
+bool Configuration::IsApproximateCountSet() const {
+  return approximateCount.IsSet();
+}
+
+bool Configuration::IsAllowDiskUse() const {
+  return allowDiskUse.GetValue();
+}
+
+void Configuration::SetAllowDiskUse(bool val) {
+  this->allowDiskUse.SetValue(val);
+}
+
+bool Configuration::IsAllowDiskUseSet() const {
+  return allowDiskUse.IsSet();
+}
+
+ReadConcern::Type Configuration::GetReadConcern() const {
+  return readConcern.GetValue();
+}
+
+void Configuration::SetReadConcern(const ReadConcern::Type level) {
+  this->readConcern.SetValue(level);
+}
+
+bool Configuration::IsReadConcernSet() const {
+  return readConcern.IsSet();
+}
+
+const std::string& Configuration::GetComment() const {
+  return comment.GetValue();
+}
+
+void Configuration::SetComment(const std::string& comment) {
+  this->comment.SetValue(comment);
+}
+
+bool Configuration::IsCommentSet() const {
+  return comment.IsSet();
+}
+
+int32_t Configuration::GetConnectionPoolSize() const {
+  return connectionPoolSize.GetValue();
+}
+
+void Configuration::SetConnectionPoolSize(int32_t size) {
+  this->connectionPoolSize.SetValue(size);
+}
+
+bool Configuration::IsConnectionPoolSizeSet() const {
+  return connectionPoolSize.IsSet();
+}
+
+int32_t Configuration::GetConnectionPoolIdleTimeout() const {
+  return connectionPoolIdleTimeout.GetValue();
+}
+
+void Configuration::SetConnectionPoolIdleTimeout(int32_t seconds) {
+  this->connectionPoolIdleTimeout.SetValue(seconds);
+}
+
+bool Configuration::IsConnectionPoolIdleTimeoutSet() const {
+  return connectionPoolIdleTimeout.IsSet();
+}
+
+int32_t Configuration::GetClientPoolSize() const {
+  return clientPoolSize.GetValue();
+}
+
+void Configuration::SetClientPoolSize(int32_t size) {
+  this->clientPoolSize.SetValue(size);
+}
+
+bool Configuration::IsClientPoolSizeSet() const {
+  return clientPoolSize.IsSet();
+}
+
+int32_t Configuration::GetReconnectAttempts() const {
+  return reconnectAttempts.GetValue();
+}
+
+void Configuration::SetReconnectAttempts(int32_t attempts) {
+  this->reconnectAttempts.SetValue(attempts);
+}
+
+bool Configuration::IsReconnectAttemptsSet() const {
+  return reconnectAttempts.IsSet();
+}
+
+int32_t Configuration::GetReconnectBackoffMs() const {
+  return reconnectBackoffMs.GetValue();
+}
+
+void Configuration::SetReconnectBackoffMs(int32_t milliseconds) {
+  this->reconnectBackoffMs.SetValue(milliseconds);
+}
+
+bool Configuration::IsReconnectBackoffMsSet() const {
+  return reconnectBackoffMs.IsSet();
+}
+
+const std::string& Configuration::GetCompressors() const {
+  return compressors.GetValue();
+}
+
+void Configuration::SetCompressors(const std::string& compressors) {
+  this->compressors.SetValue(compressors);
+}
+
+bool Configuration::IsCompressorsSet() const {
+  return compressors.IsSet();
+}
+
+bool Configuration::ParseCompressors(const std::string& value,
+                                     std::string& compressors) {
+  static const std::set< std::string > supported = {"snappy", "zlib", "zstd"};
+
+  std::stringstream list(value);
+  std::string result;
+  std::string compressor;
+  while (std::getline(list, compressor, ',')) {
+    common::StripSurroundingWhitespaces(compressor);
+    compressor = common::ToLower(compressor);
+    if (supported.count(compressor) == 0)
+      return false;
+
+    if (!result.empty())
+      result.append(",");
+    result.append(compressor);
+  }
+
+  compressors = result;
+  return true;
+}
+
+int32_t Configuration::GetZlibCompressionLevel() const {
+  return zlibCompressionLevel.GetValue();
+}
+
+void Configuration::SetZlibCompressionLevel(int32_t level) {
+  this->zlibCompressionLevel.SetValue(level);
+}
+
+bool Configuration::IsZlibCompressionLevelSet() const {
+  return zlibCompressionLevel.IsSet();
+}
+
+bool Configuration::IsAnalyticsRouting() const {
+  return analyticsRouting.GetValue();
+}
+
+void Configuration::SetAnalyticsRouting(bool analyticsRouting) {
+  this->analyticsRouting.SetValue(analyticsRouting);
+}
+
+bool Configuration::IsAnalyticsRoutingSet() const {
+  return analyticsRouting.IsSet();
+}
+
+int32_t Configuration::GetLocalThresholdMs() const {
+  return localThresholdMs.GetValue();
+}
+
+void Configuration::SetLocalThresholdMs(int32_t milliseconds) {
+  this->localThresholdMs.SetValue(milliseconds);
+}
+
+bool Configuration::IsLocalThresholdMsSet() const {
+  return localThresholdMs.IsSet();
+}
+
+int32_t Configuration::GetPoolPrewarmSize() const {
+  return poolPrewarmSize.GetValue();
+}
+
+void Configuration::SetPoolPrewarmSize(int32_t size) {
+  this->poolPrewarmSize.SetValue(size);
+}
+
+bool Configuration::IsPoolPrewarmSizeSet() const {
+  return poolPrewarmSize.IsSet();
+}
+
+const std::string& Configuration::GetWarmUpSqlFile() const {
+  return warmUpSqlFile.GetValue();
+}
+
+void Configuration::SetWarmUpSqlFile(const std::string& path) {
+  this->warmUpSqlFile.SetValue(path);
+}
+
+bool Configuration::IsWarmUpSqlFileSet() const {
+  return warmUpSqlFile.IsSet();
+}
+
+const std::string& Configuration::GetMetricsPath() const {
+  return metricsPath.GetValue();
+}
+
+void Configuration::SetMetricsPath(const std::string& path) {
+  this->metricsPath.SetValue(path);
+}
+
+bool Configuration::IsMetricsPathSet() const {
+  return metricsPath.IsSet();
+}
+
+int32_t Configuration::GetMetricsPort() const {
+  return metricsPort.GetValue();
+}
+
+void Configuration::SetMetricsPort(int32_t port) {
+  this->metricsPort.SetValue(port);
+}
+
+bool Configuration::IsMetricsPortSet() const {
+  return metricsPort.IsSet();
+}
+
+int32_t Configuration::GetMetricsInterval() const {
+  return metricsInterval.GetValue();
+}
+
+void Configuration::SetMetricsInterval(int32_t interval) {
+  this->metricsInterval.SetValue(interval);
+}
+
+bool Configuration::IsMetricsIntervalSet() const {
+  return metricsInterval.IsSet();
+}
+
+int32_t Configuration::GetDiagRecordLimit() const {
+  return diagRecordLimit.GetValue();
+}
+
+void Configuration::SetDiagRecordLimit(int32_t limit) {
+  this->diagRecordLimit.SetValue(limit);
+}
+
+bool Configuration::IsDiagRecordLimitSet() const {
+  return diagRecordLimit.IsSet();
+}
+
+int32_t Configuration::GetSlowQueryThresholdMs() const {
+  return slowQueryThresholdMs.GetValue();
+}
+
+void Configuration::SetSlowQueryThresholdMs(int32_t threshold) {
+  this->slowQueryThresholdMs.SetValue(threshold);
+}
+
+bool Configuration::IsSlowQueryThresholdMsSet() const {
+  return slowQueryThresholdMs.IsSet();
+}
+
 void Configuration::ToMap(ArgumentMap& res) const {
   AddToMap(res, ConnectionStringParser::Key::dsn, dsn);
   AddToMap(res, ConnectionStringParser::Key::driver, driver);
@@ -484,12 +823,46 @@ void Configuration::ToMap(ArgumentMap& res) const {
            sshKnownHostsFile);
   AddToMap(res, ConnectionStringParser::Key::logLevel, logLevel);
   AddToMap(res, ConnectionStringParser::Key::logPath, logPath);
+  AddToMap(res, ConnectionStringParser::Key::logAsync, logAsync);
+  AddToMap(res, ConnectionStringParser::Key::logOverflow, logOverflow);
+  AddToMap(res, ConnectionStringParser::Key::logFormat, logFormat);
   AddToMap(res, ConnectionStringParser::Key::scanMethod, scanMethod, false);
   AddToMap(res, ConnectionStringParser::Key::scanLimit, scanLimit);
   AddToMap(res, ConnectionStringParser::Key::schemaName, schemaName);
   AddToMap(res, ConnectionStringParser::Key::refreshSchema, refreshSchema);
   AddToMap(res, ConnectionStringParser::Key::defaultFetchSize,
            defaultFetchSize);
+  AddToMap(res, ConnectionStringParser::Key::parallelScanPartitions,
+           parallelScanPartitions);
+  AddToMap(res, ConnectionStringParser::Key::approximateCount,
+           approximateCount);
+  AddToMap(res, ConnectionStringParser::Key::allowDiskUse, allowDiskUse);
+  AddToMap(res, ConnectionStringParser::Key::readConcern, readConcern);
+  AddToMap(res, ConnectionStringParser::Key::comment, comment);
+  AddToMap(res, ConnectionStringParser::Key::connectionPoolSize,
+           connectionPoolSize);
+  AddToMap(res, ConnectionStringParser::Key::connectionPoolIdleTimeout,
+           connectionPoolIdleTimeout);
+  AddToMap(res, ConnectionStringParser::Key::clientPoolSize, clientPoolSize);
+  AddToMap(res, ConnectionStringParser::Key::reconnectAttempts,
+           reconnectAttempts);
+  AddToMap(res, ConnectionStringParser::Key::reconnectBackoffMs,
+           reconnectBackoffMs);
+  AddToMap(res, ConnectionStringParser::Key::compressors, compressors);
+  AddToMap(res, ConnectionStringParser::Key::zlibCompressionLevel,
+           zlibCompressionLevel);
+  AddToMap(res, ConnectionStringParser::Key::analyticsRouting,
+           analyticsRouting);
+  AddToMap(res, ConnectionStringParser::Key::localThresholdMs,
+           localThresholdMs);
+  AddToMap(res, ConnectionStringParser::Key::poolPrewarmSize, poolPrewarmSize);
+  AddToMap(res, ConnectionStringParser::Key::warmUpSqlFile, warmUpSqlFile);
+  AddToMap(res, ConnectionStringParser::Key::metricsPath, metricsPath);
+  AddToMap(res, ConnectionStringParser::Key::metricsPort, metricsPort);
+  AddToMap(res, ConnectionStringParser::Key::metricsInterval, metricsInterval);
+  AddToMap(res, ConnectionStringParser::Key::diagRecordLimit, diagRecordLimit);
+  AddToMap(res, ConnectionStringParser::Key::slowQueryThresholdMs,
+           slowQueryThresholdMs);
 }
 
 void Configuration::Validate() const {
@@ -572,6 +945,13 @@ void Configuration::ToMongoCommonOptionsMap(ArgumentMap& res) const {
   AddToMap(res, MONGO_URI_TLSCAFILE, tlsCaFile);
 }
 
+void Configuration::ToMongoNativeOptionsMap(ArgumentMap& res) const {
+  AddToMap(res, MONGO_URI_MAXPOOLSIZE, clientPoolSize);
+  AddToMap(res, MONGO_URI_COMPRESSORS, compressors);
+  AddToMap(res, MONGO_URI_ZLIBCOMPRESSIONLEVEL, zlibCompressionLevel);
+  AddToMap(res, MONGO_URI_LOCALTHRESHOLDMS, localThresholdMs);
+}
+
 std::string Configuration::ToMongoDbConnectionString(
     int32_t localSSHTunnelPort) const {
   std::string host = "localhost";
@@ -608,6 +988,7 @@ std::string Configuration::ToMongoDbConnectionString(
 
   config::Configuration::ArgumentMap arguments;
   ToMongoCommonOptionsMap(arguments);
+  ToMongoNativeOptionsMap(arguments);
   std::stringstream options;
   for (config::Configuration::ArgumentMap::const_iterator it =
            arguments.begin();
@@ -670,6 +1051,13 @@ void Configuration::AddToMap(ArgumentMap& map, const std::string& key,
                             : ReadPreference::ToString(value.GetValue());
 }
 
+template <>
+void Configuration::AddToMap(ArgumentMap& map, const std::string& key,
+                             const SettableValue< ReadConcern::Type >& value) {
+  if (value.IsSet())
+    map[key] = ReadConcern::ToString(value.GetValue());
+}
+
 template <>
 void Configuration::AddToMap(ArgumentMap& map, const std::string& key,
                              const SettableValue< LogLevel::Type >& value) {
@@ -574,8 +574,58 @@ const char* ConnectionInfo::InfoTypeToString(InfoType type) {
 
 #undef DBG_STR_CASE
 
+namespace {
+/**
+ * Make a sorted table from an associative array.
+ *
+ * @param params Associative array.
+ * @param table Resulting table.
+ */
+template < typename M, typename T >
+void MakeInfoTable(const M& params, T& table) {
+  // The map is already sorted by type.
+  table.assign(params.begin(), params.end());
+}
+
+/**
+ * Compare a table entry by its info type.
+ */
+struct InfoTypeLess {
+  template < typename E >
+  bool operator()(const E& entry, unsigned short type) const {
+    return entry.first < type;
+  }
+};
+}  // namespace
+
 ConnectionInfo::ConnectionInfo(const Configuration& config)
-    : strParams(), intParams(), shortParams(), config(config) {
+    : runtimeParams(), config(config) {
+  // No-op.
+}
+
+const ConnectionInfo::StaticInfo& ConnectionInfo::GetStaticInfo() {
+  // Built once, on first use, and shared by all connections.
+  static const StaticInfo staticInfo = BuildStaticInfo();
+  return staticInfo;
+}
+
+template < typename T >
+const T* ConnectionInfo::FindInfo(const InfoTable< T >& table,
+                                  InfoType type) {
+  typename InfoTable< T >::const_iterator it =
+      std::lower_bound(table.begin(), table.end(), type, InfoTypeLess());
+
+  if (it == table.end() || it->first != type)
+    return nullptr;
+
+  return &it->second;
+}
+
+ConnectionInfo::StaticInfo ConnectionInfo::BuildStaticInfo() {
+  StringInfoMap strParams;
+  UintInfoMap intParams;
+  UshortInfoMap shortParams;
+
   //
   //======================= String Params =======================
   //
@@ -2852,6 +2902,13 @@ ConnectionInfo::ConnectionInfo(const Configuration& config)
   //     keywords.
   shortParams[SQL_NULL_COLLATION] = SQL_NC_LOW;
 #endif  // SQL_NULL_COLLATION
+
+  StaticInfo staticInfo;
+  MakeInfoTable(strParams, staticInfo.strParams);
+  MakeInfoTable(intParams, staticInfo.intParams);
+  MakeInfoTable(shortParams, staticInfo.shortParams);
+
+  return staticInfo;
 }
 
 ConnectionInfo::~ConnectionInfo() {
@@ -2860,17 +2917,23 @@ ConnectionInfo::~ConnectionInfo() {
 
 SqlResult::Type ConnectionInfo::GetInfo(InfoType type, void* buf, short buflen,
                                         short* reslen) const {
-  StringInfoMap::const_iterator itStr = strParams.find(type);
+  const StaticInfo& staticInfo = GetStaticInfo();
 
-  if (itStr != strParams.end()) {
+  const std::string* str = nullptr;
+  StringInfoMap::const_iterator itRuntime = runtimeParams.find(type);
+  if (itRuntime != runtimeParams.end())
+    str = &itRuntime->second;
+  else
+    str = FindInfo(staticInfo.strParams, type);
+
+  if (str) {
     if (buf && !buflen)
       return SqlResult::AI_ERROR;
 
     bool isTruncated = false;
     // Length is given in bytes, implicitly handles if buf is NULL.
     unsigned short strlen = static_cast< short >(utility::CopyStringToBuffer(
-        itStr->second, reinterpret_cast< SQLWCHAR* >(buf), buflen, isTruncated,
-        true));
+        *str, reinterpret_cast< SQLWCHAR* >(buf), buflen, isTruncated, true));
 
     if (reslen)
       *reslen = strlen;
@@ -2882,22 +2945,22 @@ SqlResult::Type ConnectionInfo::GetInfo(InfoType type, void* buf, short buflen,
   if (!buf)
     return SqlResult::AI_ERROR;
 
-  UintInfoMap::const_iterator itInt = intParams.find(type);
+  const unsigned int* intValue = FindInfo(staticInfo.intParams, type);
 
-  if (itInt != intParams.end()) {
+  if (intValue) {
     unsigned int* res = reinterpret_cast< unsigned int* >(buf);
 
-    *res = itInt->second;
+    *res = *intValue;
 
     return SqlResult::AI_SUCCESS;
   }
 
-  UshortInfoMap::const_iterator itShort = shortParams.find(type);
+  const unsigned short* shortValue = FindInfo(staticInfo.shortParams, type);
 
-  if (itShort != shortParams.end()) {
+  if (shortValue) {
     unsigned short* res = reinterpret_cast< unsigned short* >(buf);
 
-    *res = itShort->second;
+    *res = *shortValue;
 
     return SqlResult::AI_SUCCESS;
   }
@@ -2906,10 +2969,9 @@ SqlResult::Type ConnectionInfo::GetInfo(InfoType type, void* buf, short buflen,
 }
 
 SqlResult::Type ConnectionInfo::SetInfo(InfoType type, std::string value) {
-  StringInfoMap::const_iterator itStr = strParams.find(type);
-
-  if (itStr != strParams.end()) {
-    strParams[type] = value;
+  // Only the string parameters can be set per connection.
+  if (FindInfo(GetStaticInfo().strParams, type)) {
+    runtimeParams[type] = value;
     return SqlResult::AI_SUCCESS;
   }
   return SqlResult::AI_ERROR;
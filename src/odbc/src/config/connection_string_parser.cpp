@@ -57,12 +57,51 @@ const std::string ConnectionStringParser::Key::sshKnownHostsFile =
     "ssh_known_hosts_file";
 const std::string ConnectionStringParser::Key::logLevel = "log_level";
 const std::string ConnectionStringParser::Key::logPath = "log_path";
+const std::string ConnectionStringParser::Key::logAsync = "log_async";
+const std::string ConnectionStringParser::Key::logOverflow = "log_overflow";
+const std::string ConnectionStringParser::Key::logFormat = "log_format";
 const std::string ConnectionStringParser::Key::scanMethod = "scan_method";
 const std::string ConnectionStringParser::Key::scanLimit = "scan_limit";
 const std::string ConnectionStringParser::Key::schemaName = "schema_name";
 const std::string ConnectionStringParser::Key::refreshSchema = "refresh_schema";
 const std::string ConnectionStringParser::Key::defaultFetchSize =
     "default_fetch_size";
+const std::string ConnectionStringParser::Key::parallelScanPartitions =
+    "parallel_scan_partitions";
+const std::string ConnectionStringParser::Key::approximateCount =
+    "approximate_count";
+const std::string ConnectionStringParser::Key::allowDiskUse = "allow_disk_use";
+const std::string ConnectionStringParser::Key::readConcern = "read_concern";
+const std::string ConnectionStringParser::Key::comment = "comment";
+const std::string ConnectionStringParser::Key::connectionPoolSize =
+    "connection_pool_size";
+const std::string ConnectionStringParser::Key::connectionPoolIdleTimeout =
+    "connection_pool_idle_timeout";
+const std::string ConnectionStringParser::Key::clientPoolSize =
+    "client_pool_size";
+const std::string ConnectionStringParser::Key::reconnectAttempts =
+    "reconnect_attempts";
+const std::string ConnectionStringParser::Key::reconnectBackoffMs =
+    "reconnect_backoff_ms";
+const std::string ConnectionStringParser::Key::compressors = "compressors";
+const std::string ConnectionStringParser::Key::zlibCompressionLevel =
+    "zlib_compression_level";
+const std::string ConnectionStringParser::Key::analyticsRouting =
+    "analytics_routing";
+const std::string ConnectionStringParser::Key::localThresholdMs =
+    "local_threshold_ms";
+const std::string ConnectionStringParser::Key::poolPrewarmSize =
+    "pool_prewarm_size";
+const std::string ConnectionStringParser::Key::warmUpSqlFile =
+    "warm_up_sql_file";
+const std::string ConnectionStringParser::Key::metricsPath = "metrics_path";
+const std::string ConnectionStringParser::Key::metricsPort = "metrics_port";
+const std::string ConnectionStringParser::Key::metricsInterval =
+    "metrics_interval";
+const std::string ConnectionStringParser::Key::diagRecordLimit =
+    "diag_record_limit";
+const std::string ConnectionStringParser::Key::slowQueryThresholdMs =
+    "slow_query_threshold_ms";
 const std::string ConnectionStringParser::Key::uid = "uid";
 const std::string ConnectionStringParser::Key::pwd = "pwd";
 
@@ -362,6 +401,46 @@ void ConnectionStringParser::HandleAttributePair(
     cfg.SetLogLevel(level);
   } else if (lKey == Key::logPath) {
     cfg.SetLogPath(value);
+  } else if (lKey == Key::logAsync) {
+    BoolParseResult::Type res = StringToBool(value);
+
+    if (res == BoolParseResult::Type::AI_UNRECOGNIZED) {
+      if (diag) {
+        diag->AddStatusRecord(
+            SqlState::S01S02_OPTION_VALUE_CHANGED,
+            MakeErrorMessage("Unrecognized bool value. Using default value.",
+                             key, value));
+      }
+      return;
+    }
+
+    cfg.SetLogAsync(res == BoolParseResult::Type::AI_TRUE);
+  } else if (lKey == Key::logOverflow) {
+    std::string policy = common::ToLower(value);
+
+    if (policy != "block" && policy != "drop") {
+      if (diag) {
+        diag->AddStatusRecord(SqlState::S01S02_OPTION_VALUE_CHANGED,
+                              "Specified log overflow policy is not "
+                              "supported. Default value used ('block').");
+      }
+      return;
+    }
+
+    cfg.SetLogOverflow(policy);
+  } else if (lKey == Key::logFormat) {
+    std::string format = common::ToLower(value);
+
+    if (format != "text" && format != "json") {
+      if (diag) {
+        diag->AddStatusRecord(SqlState::S01S02_OPTION_VALUE_CHANGED,
+                              "Specified log format is not supported. "
+                              "Default value used ('text').");
+      }
+      return;
+    }
+
+    cfg.SetLogFormat(format);
   } else if (lKey == Key::scanMethod) {
     ScanMethod::Type method = ScanMethod::FromString(value);
 
@@ -476,6 +555,171 @@ void ConnectionStringParser::HandleAttributePair(
     }
 
     cfg.SetDefaultFetchSize(static_cast< int32_t >(numValue));
+  } else if (lKey == Key::parallelScanPartitions) {
+    int32_t partitions = 0;
+    if (!StringToInt("Parallel scan partitions", key, value, 0,
+                     MAX_PARALLEL_SCAN_PARTITIONS, partitions, diag))
+      return;
+
+    cfg.SetParallelScanPartitions(partitions);
+  } else if (lKey == Key::approximateCount) {
+    BoolParseResult::Type res = StringToBool(value);
+
+    if (res == BoolParseResult::Type::AI_UNRECOGNIZED) {
+      if (diag) {
+        diag->AddStatusRecord(
+            SqlState::S01S02_OPTION_VALUE_CHANGED,
+            MakeErrorMessage("Unrecognized bool value. Using default value.",
+                             key, value));
+      }
+      return;
+    }
+
+    cfg.SetApproximateCount(res == BoolParseResult::Type::AI_TRUE);
+  } else if (lKey == Key::allowDiskUse) {
+    BoolParseResult::Type res = StringToBool(value);
+
+    if (res == BoolParseResult::Type::AI_UNRECOGNIZED) {
+      if (diag) {
+        diag->AddStatusRecord(
+            SqlState::S01S02_OPTION_VALUE_CHANGED,
+            MakeErrorMessage("Unrecognized bool value. Using default value.",
+                             key, value));
+      }
+      return;
+    }
+
+    cfg.SetAllowDiskUse(res == BoolParseResult::Type::AI_TRUE);
+  } else if (lKey == Key::readConcern) {
+    ReadConcern::Type level = ReadConcern::FromString(value);
+
+    if (level == ReadConcern::Type::UNKNOWN) {
+      if (diag) {
+        diag->AddStatusRecord(SqlState::S01S02_OPTION_VALUE_CHANGED,
+                              "Specified read concern is not supported. "
+                              "Server default used.");
+      }
+      return;
+    }
+
+    cfg.SetReadConcern(level);
+  } else if (lKey == Key::comment) {
+    cfg.SetComment(value);
+  } else if (lKey == Key::connectionPoolSize) {
+    int32_t size = 0;
+    if (!StringToInt("Connection pool size", key, value, 0,
+                     MAX_CONNECTION_POOL_SIZE, size, diag))
+      return;
+
+    cfg.SetConnectionPoolSize(size);
+  } else if (lKey == Key::connectionPoolIdleTimeout) {
+    int32_t seconds = 0;
+    if (!StringToInt("Connection pool idle timeout", key, value, 0,
+                     MAX_CONNECTION_POOL_IDLE_TIMEOUT, seconds, diag))
+      return;
+
+    cfg.SetConnectionPoolIdleTimeout(seconds);
+  } else if (lKey == Key::clientPoolSize) {
+    int32_t size = 0;
+    if (!StringToInt("Client pool size", key, value, 1, MAX_CLIENT_POOL_SIZE,
+                     size, diag))
+      return;
+
+    cfg.SetClientPoolSize(size);
+  } else if (lKey == Key::reconnectAttempts) {
+    int32_t attempts = 0;
+    if (!StringToInt("Reconnect attempts", key, value, 0,
+                     MAX_RECONNECT_ATTEMPTS, attempts, diag))
+      return;
+
+    cfg.SetReconnectAttempts(attempts);
+  } else if (lKey == Key::reconnectBackoffMs) {
+    int32_t milliseconds = 0;
+    if (!StringToInt("Reconnect backoff", key, value, 1,
+                     MAX_RECONNECT_BACKOFF_MS, milliseconds, diag))
+      return;
+
+    cfg.SetReconnectBackoffMs(milliseconds);
+  } else if (lKey == Key::compressors) {
+    std::string compressors;
+    if (!Configuration::ParseCompressors(value, compressors)) {
+      if (diag) {
+        diag->AddStatusRecord(
+            SqlState::S01S02_OPTION_VALUE_CHANGED,
+            MakeErrorMessage("Specified compressor is not supported. "
+                             "Using default value.",
+                             key, value));
+      }
+      return;
+    }
+
+    cfg.SetCompressors(compressors);
+  } else if (lKey == Key::zlibCompressionLevel) {
+    int32_t level = 0;
+    if (!StringToInt("Zlib compression level", key, value, 0,
+                     MAX_ZLIB_COMPRESSION_LEVEL, level, diag))
+      return;
+
+    cfg.SetZlibCompressionLevel(level);
+  } else if (lKey == Key::analyticsRouting) {
+    BoolParseResult::Type res = StringToBool(value);
+
+    if (res == BoolParseResult::Type::AI_UNRECOGNIZED) {
+      if (diag) {
+        diag->AddStatusRecord(
+            SqlState::S01S02_OPTION_VALUE_CHANGED,
+            MakeErrorMessage("Unrecognized bool value. Using default value.",
+                             key, value));
+      }
+      return;
+    }
+
+    cfg.SetAnalyticsRouting(res == BoolParseResult::Type::AI_TRUE);
+  } else if (lKey == Key::localThresholdMs) {
+    int32_t milliseconds = 0;
+    if (!StringToInt("Local threshold", key, value, 0, MAX_LOCAL_THRESHOLD_MS,
+                     milliseconds, diag))
+      return;
+
+    cfg.SetLocalThresholdMs(milliseconds);
+  } else if (lKey == Key::poolPrewarmSize) {
+    int32_t size = 0;
+    if (!StringToInt("Pool pre-warm size", key, value, 0,
+                     MAX_CONNECTION_POOL_SIZE, size, diag))
+      return;
+
+    cfg.SetPoolPrewarmSize(size);
+  } else if (lKey == Key::warmUpSqlFile) {
+    cfg.SetWarmUpSqlFile(value);
+  } else if (lKey == Key::metricsPath) {
+    cfg.SetMetricsPath(value);
+  } else if (lKey == Key::metricsPort) {
+    int32_t port = 0;
+    if (!StringToInt("Metrics port", key, value, 0, UINT16_MAX, port, diag))
+      return;
+
+    cfg.SetMetricsPort(port);
+  } else if (lKey == Key::metricsInterval) {
+    int32_t interval = 0;
+    if (!StringToInt("Metrics interval", key, value, 1, MAX_METRICS_INTERVAL,
+                     interval, diag))
+      return;
+
+    cfg.SetMetricsInterval(interval);
+  } else if (lKey == Key::diagRecordLimit) {
+    int32_t limit = 0;
+    if (!StringToInt("Diagnostic record limit", key, value, 1,
+                     MAX_DIAG_RECORD_LIMIT, limit, diag))
+      return;
+
+    cfg.SetDiagRecordLimit(limit);
+  } else if (lKey == Key::slowQueryThresholdMs) {
+    int32_t threshold = 0;
+    if (!StringToInt("Slow query threshold", key, value, 0,
+                     MAX_SLOW_QUERY_THRESHOLD_MS, threshold, diag))
+      return;
+
+    cfg.SetSlowQueryThresholdMs(threshold);
   } else if (lKey == Key::driver) {
     cfg.SetDriver(value);
   } else if (lKey == Key::user || lKey == Key::uid) {
@@ -516,6 +760,55 @@ ConnectionStringParser::StringToBool(const std::string& value) {
   return BoolParseResult::Type::AI_UNRECOGNIZED;
 }
 
+bool ConnectionStringParser::StringToInt(
+    const std::string& name, const std::string& key, const std::string& value,
+    int64_t minValue, int64_t maxValue, int32_t& res,
+    diagnostic::DiagnosticRecordStorage* diag) {
+  if (!common::AllDigits(value)) {
+    if (diag) {
+      diag->AddStatusRecord(
+          SqlState::S01S02_OPTION_VALUE_CHANGED,
+          MakeErrorMessage(name
+                               + " attribute value contains unexpected "
+                                 "characters. Using default value.",
+                           key, value));
+    }
+    return false;
+  }
+
+  if (value.size() >= sizeof(std::to_string(UINT32_MAX))) {
+    if (diag) {
+      diag->AddStatusRecord(
+          SqlState::S01S02_OPTION_VALUE_CHANGED,
+          MakeErrorMessage(
+              name + " attribute value is too large. Using default value.",
+              key, value));
+    }
+    return false;
+  }
+
+  int64_t numValue = 0;
+  std::stringstream conv;
+
+  conv << value;
+  conv >> numValue;
+
+  if (numValue < minValue || numValue > maxValue) {
+    if (diag) {
+      diag->AddStatusRecord(
+          SqlState::S01S02_OPTION_VALUE_CHANGED,
+          MakeErrorMessage(
+              name + " attribute value is out of range. Using default value.",
+              key, value));
+    }
+    return false;
+  }
+
+  res = static_cast< int32_t >(numValue);
+
+  return true;
+}
+
 std::string ConnectionStringParser::MakeErrorMessage(const std::string& msg,
                                                      const std::string& key,
                                                      const std::string& value) {
@@ -27,18 +27,32 @@
 #include <bsoncxx/json.hpp>
 #include <bsoncxx/stdx/optional.hpp>
 #include <bsoncxx/stdx/string_view.hpp>
+#include <chrono>
 #include <cstddef>
 #include <cstring>
+#include <future>
 #include <mongocxx/client.hpp>
+#include <mongocxx/events/command_started_event.hpp>
+#include <mongocxx/events/command_succeeded_event.hpp>
+#include <mongocxx/exception/error_code.hpp>
 #include <mongocxx/exception/exception.hpp>
+#include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/exception/operation_exception.hpp>
+#include <mongocxx/options/apm.hpp>
+#include <mongocxx/pool.hpp>
 #include <mongocxx/uri.hpp>
+#include <random>
+#include <set>
 #include <sstream>
+#include <system_error>
+#include <thread>
 
 #include "documentdb/odbc/driver_instance.h"
 #include "documentdb/odbc/common/concurrent.h"
 #include "documentdb/odbc/common/utils.h"
 #include "documentdb/odbc/config/configuration.h"
 #include "documentdb/odbc/config/connection_string_parser.h"
+#include "documentdb/odbc/connection_pool.h"
 #include "documentdb/odbc/dsn_config.h"
 #include "documentdb/odbc/environment.h"
 #include "documentdb/odbc/jni/database_metadata.h"
@@ -47,8 +61,13 @@
 #include "documentdb/odbc/jni/utils.h"
 #include "documentdb/odbc/log.h"
 #include "documentdb/odbc/message.h"
+#include "documentdb/odbc/metrics.h"
+#include "documentdb/odbc/probes.h"
+#include "documentdb/odbc/server_capabilities.h"
+#include "documentdb/odbc/ssh_tunnel_manager.h"
 #include "documentdb/odbc/ssl_mode.h"
 #include "documentdb/odbc/statement.h"
+#include "documentdb/odbc/statement_trace.h"
 #include "documentdb/odbc/system/system_dsn.h"
 #include "documentdb/odbc/utility.h"
 
@@ -71,11 +90,55 @@ struct OdbcProtocolHeader {
   int32_t len;
 };
 #pragma pack(pop)
+
+/**
+ * Error codes of the client that mean the transport to the server was lost:
+ * stream and server selection errors. Only used for errors without a server
+ * reply, as the codes of the server overlap with them.
+ */
+const std::set< int > CLIENT_TRANSPORT_ERROR_CODES = {
+    3,     // MONGOC_ERROR_STREAM_NAME_RESOLUTION.
+    4,     // MONGOC_ERROR_STREAM_SOCKET.
+    5,     // MONGOC_ERROR_STREAM_CONNECT.
+    6,     // MONGOC_ERROR_STREAM_NOT_ESTABLISHED.
+    13053  // MONGOC_ERROR_SERVER_SELECTION_FAILURE.
+};
+
+/**
+ * Error codes of the server that mean it is going away or no longer primary.
+ */
+const std::set< int > SERVER_TRANSPORT_ERROR_CODES = {
+    89,     // NetworkTimeout.
+    91,     // ShutdownInProgress.
+    189,    // PrimarySteppedDown.
+    10107,  // NotWritablePrimary.
+    11600,  // InterruptedAtShutdown.
+    11602,  // InterruptedDueToReplStateChange.
+    13435,  // NotPrimaryNoSecondaryOk.
+    13436   // NotPrimaryOrSecondary.
+};
+
+/**
+ * Time a statement without a query timeout waits for a client of the
+ * connection client pool, in seconds.
+ */
+const int32_t CLIENT_POOL_WAIT_SECONDS = 30;
+
+/** Longest pause between two attempts to take a client from the pool. */
+const int64_t CLIENT_POOL_POLL_MAX_MS = 50;
+
+/** Commands sent to run a query. */
+const std::set< std::string > QUERY_COMMANDS = {"aggregate", "count", "explain",
+                                                "find"};
+
+/** Source of the connection identifiers used to tag the log records. */
+std::atomic< uint64_t > nextConnectionId(1);
 }  // namespace
 
 namespace documentdb {
 namespace odbc {
-Connection::Connection(Environment* env) : env_(env), info_(config_) {
+Connection::Connection(Environment* env)
+    : env_(env), id_(nextConnectionId++), info_(config_) {
   // No-op
 }
 
@@ -103,6 +166,16 @@ void Connection::GetInfo(config::ConnectionInfo::InfoType type, void* buf,
 SqlResult::Type Connection::InternalGetInfo(
     config::ConnectionInfo::InfoType type, void* buf, short buflen,
     short* reslen) {
+#ifdef SQL_DBMS_VER
+  // The server version is only queried when the application asks for it,
+  // and at most once per server.
+  if (type == SQL_DBMS_VER) {
+    ServerCapabilities caps;
+    if (GetServerCapabilities(caps) && !caps.GetDbmsVer().empty())
+      info_.SetInfo(SQL_DBMS_VER, caps.GetDbmsVer());
+  }
+#endif  // SQL_DBMS_VER
+
   const config::ConnectionInfo& info = GetInfo();
 
   SqlResult::Type res = info.GetInfo(type, buf, buflen, reslen);
@@ -167,8 +240,10 @@ SqlResult::Type Connection::InternalEstablish(
     return SqlResult::AI_ERROR;
   }
 
+  DOCUMENTDB_PROBE(connect_start);
   DocumentDbError err;
   bool connected = TryRestoreConnection(err);
+  DOCUMENTDB_PROBE1(connect_done, static_cast< int >(connected));
 
   if (!connected) {
     std::string errMessage = "Failed to establish connection with the host.\n";
@@ -178,6 +253,17 @@ SqlResult::Type Connection::InternalEstablish(
     return SqlResult::AI_ERROR;
   }
 
+  Metrics& metrics = Metrics::GetInstance();
+  Metrics::Increment(Metrics::Counter::CONNECTIONS_OPENED);
+  metrics.AddOpenConnections(1);
+  if (config_.IsMetricsPathSet() || config_.IsMetricsPortSet()) {
+    metrics.ConfigureExport(config_.GetMetricsPath(), config_.GetMetricsPort(),
+                            config_.GetMetricsInterval());
+  }
+
+  if (env_)
+    env_->Prewarm(config_);
+
   bool errors = GetDiagnosticRecords().GetStatusRecordsNumber() > 0;
 
   return errors ? SqlResult::AI_SUCCESS_WITH_INFO : SqlResult::AI_SUCCESS;
@@ -201,7 +287,10 @@ SqlResult::Type Connection::InternalRelease() {
     return SqlResult::AI_SUCCESS_WITH_INFO;
   }
 
-  Close();
+  if (!TryReturnToPool())
+    Close();
+
+  Metrics::GetInstance().AddOpenConnections(-1);
 
   return SqlResult::AI_SUCCESS;
 }
@@ -217,6 +306,8 @@ void Connection::Close() {
       connection_ = nullptr;
     }
   }
+
+  ReleaseSshTunnel();
 }
 
 Statement* Connection::CreateStatement() {
@@ -293,6 +384,9 @@ SqlResult::Type Connection::InternalCreateStatement(Statement*& statement) {
     return SqlResult::AI_ERROR;
   }
 
+  statement->GetDiagnosticRecords().SetRecordLimit(
+      config_.GetDiagRecordLimit());
+
   return SqlResult::AI_SUCCESS;
 }
 
@@ -300,6 +394,10 @@ const std::string& Connection::GetSchema() const {
   return config_.GetDatabase();
 }
 
+uint64_t Connection::GetLogConnectionId() const {
+  return id_;
+}
+
 const config::Configuration& Connection::GetConfiguration() const {
   return config_;
 }
@@ -317,7 +415,7 @@ void Connection::GetAttribute(int attr, void* buf, SQLINTEGER bufLen,
 }
 
 SqlResult::Type Connection::InternalGetAttribute(int attr, void* buf,
-                                                 SQLINTEGER,
+                                                 SQLINTEGER bufLen,
                                                  SQLINTEGER* valueLen) {
   if (!buf) {
     AddStatusRecord(SqlState::SHY009_INVALID_USE_OF_NULL_POINTER,
@@ -349,6 +447,99 @@ SqlResult::Type Connection::InternalGetAttribute(int attr, void* buf,
       break;
     }
 
+    case SQL_ATTR_DOCUMENTDB_RECONNECT_ATTEMPTS: {
+      SQLUINTEGER* val = reinterpret_cast< SQLUINTEGER* >(buf);
+
+      *val = reconnectAttempts_;
+
+      if (valueLen)
+        *valueLen = SQL_IS_UINTEGER;
+
+      break;
+    }
+
+    case SQL_ATTR_DOCUMENTDB_RECONNECT_FAILURES: {
+      SQLUINTEGER* val = reinterpret_cast< SQLUINTEGER* >(buf);
+
+      *val = reconnectFailures_;
+
+      if (valueLen)
+        *valueLen = SQL_IS_UINTEGER;
+
+      break;
+    }
+
+    case SQL_ATTR_DOCUMENTDB_RECONNECT_TIME_MS: {
+      SQLUINTEGER* val = reinterpret_cast< SQLUINTEGER* >(buf);
+
+      *val = reconnectTimeMs_;
+
+      if (valueLen)
+        *valueLen = SQL_IS_UINTEGER;
+
+      break;
+    }
+
+    case SQL_ATTR_DOCUMENTDB_REPLY_BYTES: {
+      SQLULEN* val = reinterpret_cast< SQLULEN* >(buf);
+
+      *val = static_cast< SQLULEN >(wireStatistics_->replyBytes);
+
+      if (valueLen)
+        *valueLen = sizeof(SQLULEN);
+
+      break;
+    }
+
+    case SQL_ATTR_DOCUMENTDB_MESSAGES_RECEIVED: {
+      SQLULEN* val = reinterpret_cast< SQLULEN* >(buf);
+
+      *val = static_cast< SQLULEN >(wireStatistics_->messagesReceived);
+
+      if (valueLen)
+        *valueLen = sizeof(SQLULEN);
+
+      break;
+    }
+
+    case SQL_ATTR_DOCUMENTDB_NODE_STATEMENT_COUNTS: {
+      if (bufLen < 0) {
+        AddStatusRecord(SqlState::SHY090_INVALID_STRING_OR_BUFFER_LENGTH,
+                        "Buffer length is negative.");
+
+        return SqlResult::AI_ERROR;
+      }
+
+      bool isTruncated = false;
+      size_t outSize = utility::CopyStringToBuffer(
+          wireStatistics_->GetNodeQueries(),
+          reinterpret_cast< SQLWCHAR* >(buf), bufLen, isTruncated, true);
+
+      if (valueLen)
+        *valueLen = static_cast< SQLINTEGER >(outSize);
+
+      if (isTruncated) {
+        AddStatusRecord(SqlState::S01004_DATA_TRUNCATED,
+                        "Attribute value was truncated.");
+
+        return SqlResult::AI_SUCCESS_WITH_INFO;
+      }
+
+      break;
+    }
+
+    case SQL_ATTR_DOCUMENTDB_LOG_RECORDS_DROPPED: {
+      SQLULEN* val = reinterpret_cast< SQLULEN* >(buf);
+
+      *val = static_cast< SQLULEN >(
+          Logger::GetLoggerInstance()->GetDroppedCount());
+
+      if (valueLen)
+        *valueLen = sizeof(SQLULEN);
+
+      break;
+    }
+
     default: {
       AddStatusRecord(SqlState::SHYC00_OPTIONAL_FEATURE_NOT_IMPLEMENTED,
                       "Specified attribute is not supported.");
@@ -367,7 +558,14 @@ void Connection::SetAttribute(int attr, void* value, SQLINTEGER valueLen) {
 SqlResult::Type Connection::InternalSetAttribute(int attr, void* value,
                                                  SQLINTEGER) {
   switch (attr) {
-    case SQL_ATTR_CONNECTION_DEAD: {
+    case SQL_ATTR_CONNECTION_DEAD:
+    case SQL_ATTR_DOCUMENTDB_RECONNECT_ATTEMPTS:
+    case SQL_ATTR_DOCUMENTDB_RECONNECT_FAILURES:
+    case SQL_ATTR_DOCUMENTDB_RECONNECT_TIME_MS:
+    case SQL_ATTR_DOCUMENTDB_REPLY_BYTES:
+    case SQL_ATTR_DOCUMENTDB_MESSAGES_RECEIVED:
+    case SQL_ATTR_DOCUMENTDB_NODE_STATEMENT_COUNTS:
+    case SQL_ATTR_DOCUMENTDB_LOG_RECORDS_DROPPED: {
       AddStatusRecord(SqlState::SHY092_OPTION_TYPE_OUT_OF_RANGE,
                       "Attribute is read only.");
 
@@ -432,6 +630,64 @@ bool Connection::TryRestoreConnection(DocumentDbError& err) {
     return true;
   }
 
+  if (TryCheckoutPooledConnection()) {
+    return true;
+  }
+
+  // With an internal SSH tunnel, both connections go through the local port
+  // of the tunnel shared by all the connections to the same cluster.
+  config::Configuration jdbcConfig = config_;
+  int32_t localSSHTunnelPort = 0;
+  if (SshTunnelManager::IsTunnelConfigured(config_)) {
+    JniErrorInfo errInfo;
+    SharedPointer< JniContext > ctx = GetJniContext(errInfo);
+    if (errInfo.code != JniErrorCode::DOCUMENTDB_JNI_ERR_SUCCESS) {
+      err = DocumentDbError(static_cast< int32_t >(errInfo.code),
+                            std::string(errInfo.errCls)
+                                .append(": ")
+                                .append(errInfo.errMsg)
+                                .c_str());
+      return false;
+    }
+
+    if (!SshTunnelManager::GetInstance().Acquire(
+            config_, ctx, sshTunnelKey_, localSSHTunnelPort, err)) {
+      sshTunnelKey_.clear();
+      return false;
+    }
+
+    jdbcConfig = SshTunnelManager::MakeTunneledConfiguration(
+        config_, localSSHTunnelPort);
+  }
+
+  // The native connection does not depend on the JDBC connection, so it is
+  // established concurrently with it.
+  DocumentDbError nativeErr;
+  std::future< bool > nativeConnected = std::async(
+      std::launch::async, [this, localSSHTunnelPort, &nativeErr]() {
+        return ConnectCPPDocumentDB(localSSHTunnelPort, true, nativeErr);
+      });
+
+  bool connected = OpenJdbcConnection(jdbcConfig, err);
+
+  if (!nativeConnected.get() && connected) {
+    err = nativeErr;
+    connected = false;
+  }
+
+  if (connected) {
+    UpdateConnectionRuntimeInfo(config_, info_);
+  } else {
+    ReleaseSshTunnel();
+    ServerCapabilitiesCache::GetInstance().Invalidate(
+        ServerCapabilitiesCache::MakeKey(config_));
+  }
+
+  return connected;
+}
+
+bool Connection::OpenJdbcConnection(const config::Configuration& config,
+                                    DocumentDbError& err) {
   JniErrorInfo errInfo;
   auto ctx = GetJniContext(errInfo);
   if (errInfo.code != JniErrorCode::DOCUMENTDB_JNI_ERR_SUCCESS) {
@@ -444,56 +700,40 @@ bool Connection::TryRestoreConnection(DocumentDbError& err) {
   }
   SharedPointer< DocumentDbConnection > conn = new DocumentDbConnection(ctx);
   if (!conn.IsValid()
-      || conn.Get()->Open(config_, errInfo)
+      || conn.Get()->Open(config, errInfo)
              != JniErrorCode::DOCUMENTDB_JNI_ERR_SUCCESS) {
     std::string message = errInfo.errMsg;
     err = DocumentDbError(DocumentDbError::DOCUMENTDB_ERR_SECURE_CONNECTION_FAILURE,
                       message.c_str());
   }
   connection_ = conn;
-  bool connected = connection_.IsValid() && connection_.Get()->IsOpen()
-                   && errInfo.code == JniErrorCode::DOCUMENTDB_JNI_ERR_SUCCESS;
-
-  if (!connected) {
-    return connected;
-  }
 
-  int32_t localSSHTunnelPort = 0;
-  if (!GetInternalSSHTunnelPort(localSSHTunnelPort, ctx, err)) {
-    return false;
-  }
-
-  connected = ConnectCPPDocumentDB(localSSHTunnelPort, err);
-
-  UpdateConnectionRuntimeInfo(config_, info_);
-
-  return connected;
+  return connection_.IsValid() && connection_.Get()->IsOpen()
+         && errInfo.code == JniErrorCode::DOCUMENTDB_JNI_ERR_SUCCESS;
 }
 
-bool Connection::GetInternalSSHTunnelPort(int32_t& localSSHTunnelPort,
-                                          SharedPointer< JniContext > ctx,
-                                          odbc::DocumentDbError& err) {
-  bool isSSHTunnelActive;
+bool Connection::ReacquireSshTunnel(int32_t& localSSHTunnelPort,
+                                    DocumentDbError& err) {
   JniErrorInfo errInfo;
-  JniErrorCode success =
-      connection_.Get()->IsSshTunnelActive(isSSHTunnelActive, errInfo);
-
-  if (success != JniErrorCode::DOCUMENTDB_JNI_ERR_SUCCESS) {
-    err = DocumentDbError(odbc::DocumentDbError::DOCUMENTDB_ERR_JVM_INIT,
-                      errInfo.errMsg.c_str());
+  SharedPointer< JniContext > ctx = GetJniContext(errInfo);
+  if (errInfo.code != JniErrorCode::DOCUMENTDB_JNI_ERR_SUCCESS) {
+    err = DocumentDbError(static_cast< int32_t >(errInfo.code),
+                          std::string(errInfo.errCls)
+                              .append(": ")
+                              .append(errInfo.errMsg)
+                              .c_str());
     return false;
   }
 
-  if (isSSHTunnelActive) {
-    success = connection_.Get()->GetSshLocalPort(localSSHTunnelPort, errInfo);
-    if (success != JniErrorCode::DOCUMENTDB_JNI_ERR_SUCCESS) {
-      err = DocumentDbError(odbc::DocumentDbError::DOCUMENTDB_ERR_JVM_INIT,
-                            errInfo.errMsg.c_str());
-      return false;
-    }
-  }
+  return SshTunnelManager::GetInstance().Reacquire(
+      config_, ctx, sshTunnelKey_, localSSHTunnelPort, err);
+}
 
-  return true;
+void Connection::ReleaseSshTunnel() {
+  if (!sshTunnelKey_.empty()) {
+    SshTunnelManager::GetInstance().Release(sshTunnelKey_);
+    sshTunnelKey_.clear();
+  }
 }
 
 SharedPointer< JniContext > Connection::GetJniContext(JniErrorInfo& errInfo) {
@@ -557,62 +797,107 @@ int32_t Connection::RetrieveTimeout(void* value) {
 }
 
 /**
- * Updates the SQL_DBMS_VER information. Updates the info used by SQLGetInfo.
+ * Builds the MongoDB client options from the configuration.
  *
- * @param db the database to get the information from.
+ * @param config the connection configuration.
+ * @param statistics the wire counters to update.
+ * @return the client options.
  */
-void UpdateSqlDbmsVerInfo(mongocxx::database& db, config::ConnectionInfo& info) {
-#ifdef SQL_DBMS_VER
-  bsoncxx::builder::stream::document buildInfo;
-  buildInfo << "buildInfo" << 1;
-  auto result2 = db.run_command(buildInfo.view());
-  if (result2.view()["ok"].get_double() == 1) {
-    auto buildInfoView = result2.view();
-    if (buildInfoView.find("versionArray") != buildInfoView.end()) {
-      auto versionArray = buildInfoView["versionArray"];
-      auto array = versionArray.get_array().value;
-      std::stringstream versionString;
-      int64_t versionElement = 0;
-      int index = 0;
-      for (auto &element : array) {
-        // Handle the possibility that version might come in different data type.
-        switch (element.type()) {
-          case bsoncxx::type::k_int32:
-            versionElement = element.get_int32().value;
-            break;
-          case bsoncxx::type::k_int64:
-            versionElement = element.get_int64().value;
-            break;
-          case bsoncxx::type::k_utf8:
-            versionElement =
-                std::atol(element.get_utf8().value.to_string().c_str());
-          default:
-            versionElement = 0;
+mongocxx::options::client MakeMongoClientOptions(
+    const config::Configuration& config,
+    const std::shared_ptr< WireStatistics >& statistics) {
+  mongocxx::options::client client_options;
+  mongocxx::options::tls tls_options;
+  if (config.IsTls()) {
+    // TODO: Enable use of Amazon RDS CA certificate in driver
+    // [Enable use of Amazon RDS CA certificate in driver](https://github.com/aws/amazon-documentdb-odbc-driver/issues/177)
+    tls_options.allow_invalid_certificates(true);
+    client_options.tls_opts(tls_options);
+  }
+
+  // The callbacks keep the counters alive as long as the clients.
+  mongocxx::options::apm apm_options;
+  apm_options.on_command_started(
+      [statistics](const mongocxx::events::command_started_event& event) {
+        if (QUERY_COMMANDS.count(event.command_name().to_string()) > 0) {
+          statistics->AddNodeQuery(event.host().to_string() + ":"
+                                   + std::to_string(event.port()));
         }
-        // Format the first three version elements in the version string.
-        switch (index) {
-          case 0:
-            versionString << std::setw(2) << std::setfill('0')
-                          << versionElement;
-            break;
-          case 1:
-            versionString << "." << std::setw(2) << std::setfill('0')
-                          << versionElement;
-            break;
-          case 2:
-            versionString << "." << std::setw(4) << std::setfill('0')
-                          << versionElement;
-            break;
+      });
+  apm_options.on_command_succeeded(
+      [statistics](const mongocxx::events::command_succeeded_event& event) {
+        const std::string command = event.command_name().to_string();
+        statistics->replyBytes += event.reply().length();
+        Metrics::Increment(Metrics::Counter::BYTES_FETCHED,
+                           event.reply().length());
+        ++statistics->messagesReceived;
+        DOCUMENTDB_PROBE3(reply_received, command.c_str(),
+                          static_cast< uint64_t >(event.reply().length()),
+                          event.duration());
+        // Commands run by a statement are sent from its thread.
+        StatementTrace* trace = StatementTrace::GetCurrent();
+        if (trace) {
+          trace->AddReply(command, event.duration(), event.reply().length());
         }
-        index++;
-      }
-      info.SetInfo(SQL_DBMS_VER, versionString.str());
+      });
+  client_options.apm_opts(apm_options);
+
+  return client_options;
+}
+
+std::shared_ptr< mongocxx::client > Connection::AcquireMongoClient(
+    int32_t timeout) {
+  std::shared_ptr< mongocxx::pool > pool;
+  {
+    CsLockGuard guard(transportLock_);
+    pool = mongoPool_;
+  }
+  if (!pool) {
+    throw mongocxx::logic_error(mongocxx::error_code::k_invalid_client_object);
+  }
+
+  // mongocxx::pool::acquire waits without a bound, which never ends when the
+  // clients are all held by open cursors of the calling thread.
+  std::chrono::steady_clock::time_point deadline =
+      std::chrono::steady_clock::now()
+      + std::chrono::seconds(timeout > 0 ? timeout : CLIENT_POOL_WAIT_SECONDS);
+  int64_t pauseMs = 1;
+  bsoncxx::stdx::optional< mongocxx::pool::entry > acquired =
+      pool->try_acquire();
+  while (!acquired) {
+    if (std::chrono::steady_clock::now() >= deadline) {
+      throw mongocxx::exception(
+          std::make_error_code(std::errc::timed_out),
+          "All clients of the connection are in use by open cursors, see "
+          "CLIENT_POOL_SIZE");
     }
+    std::this_thread::sleep_for(std::chrono::milliseconds(pauseMs));
+    pauseMs = std::min(pauseMs * 2, CLIENT_POOL_POLL_MAX_MS);
+    acquired = pool->try_acquire();
   }
-#endif  // SQL_DBMS_VER
+
+  mongocxx::pool::entry* entry =
+      new mongocxx::pool::entry(std::move(*acquired));
+
+  // The deleter keeps the pool alive until the client is back in it.
+  return std::shared_ptr< mongocxx::client >(
+      entry->get(), [pool, entry](mongocxx::client*) { delete entry; });
+}
+
+std::shared_ptr< mongocxx::client > Connection::CreateMongoClient() const {
+  return std::make_shared< mongocxx::client >(
+      mongocxx::uri(
+          config_.ToMongoDbConnectionString(GetLocalSSHTunnelPort())),
+      MakeMongoClientOptions(config_, wireStatistics_));
+}
+
+int32_t Connection::GetLocalSSHTunnelPort() const {
+  // The port changes when a reconnect replaces the SSH tunnel.
+  CsLockGuard guard(transportLock_);
+  return localSSHTunnelPort_;
 }
 
-bool Connection::ConnectCPPDocumentDB(int32_t localSSHTunnelPort,
+bool Connection::ConnectCPPDocumentDB(int32_t localSSHTunnelPort, bool ping,
                                       odbc::DocumentDbError& err) {
   using bsoncxx::builder::basic::kvp;
   using bsoncxx::builder::basic::make_document;
@@ -620,24 +905,29 @@ bool Connection::ConnectCPPDocumentDB(int32_t localSSHTunnelPort,
   // Make sure that the DriverInstance is initialize
   DriverInstance::getInstance().initialize();
   try {
-    std::string mongoCPPConnectionString =
-        config_.ToMongoDbConnectionString(localSSHTunnelPort);
-    mongocxx::options::client client_options;
-    mongocxx::options::tls tls_options;
-    if (config_.IsTls()) {
-      // TODO: Enable use of Amazon RDS CA certificate in driver
-      // [Enable use of Amazon RDS CA certificate in driver](https://github.com/aws/amazon-documentdb-odbc-driver/issues/177)
-      tls_options.allow_invalid_certificates(true);
-      client_options.tls_opts(tls_options);
+    std::shared_ptr< mongocxx::pool > pool = std::make_shared< mongocxx::pool >(
+        mongocxx::uri(config_.ToMongoDbConnectionString(localSSHTunnelPort)),
+        mongocxx::options::pool(
+            MakeMongoClientOptions(config_, wireStatistics_)));
+    {
+      // Statements of the connection might be taking clients concurrently
+      // when the pool is replaced on reconnect.
+      CsLockGuard guard(transportLock_);
+      localSSHTunnelPort_ = localSSHTunnelPort;
+      mongoPool_ = pool;
     }
 
-    mongoClient_ = std::make_shared< mongocxx::client >(
-        mongocxx::uri(mongoCPPConnectionString), client_options);
+    if (!ping) {
+      return true;
+    }
+
+    // The client goes back to the pool connected and authenticated.
+    std::shared_ptr< mongocxx::client > client = AcquireMongoClient();
     std::string database = config_.GetDatabase();
-    bsoncxx::builder::stream::document ping;
-    ping << "ping" << 1;
-    auto db = (*mongoClient_.get())[database];
-    auto result = db.run_command(ping.view());
+    bsoncxx::builder::stream::document pingCommand;
+    pingCommand << "ping" << 1;
+    auto db = (*client.get())[database];
+    auto result = db.run_command(pingCommand.view());
 
     if (result.view()["ok"].get_double() != 1) {
       err = odbc::DocumentDbError(odbc::DocumentDbError::DOCUMENTDB_ERR_NETWORK_FAILURE,
@@ -645,8 +935,6 @@ bool Connection::ConnectCPPDocumentDB(int32_t localSSHTunnelPort,
       return false;
     }
 
-    UpdateSqlDbmsVerInfo(db, info_);
-
     return true;
   } catch (const mongocxx::exception& xcp) {
     std::stringstream message;
@@ -660,5 +948,261 @@ bool Connection::ConnectCPPDocumentDB(int32_t localSSHTunnelPort,
     return false;
   }
 }
+
+bool Connection::IsClientPoolTimeout(const mongocxx::exception& xcp) {
+  return xcp.code() == std::errc::timed_out;
+}
+
+bool Connection::IsTransportError(const mongocxx::exception& xcp) {
+  // Errors of the driver itself, such as a misuse of the API, are never
+  // transport errors, and their codes overlap with the codes below.
+  if (xcp.code().category() == mongocxx::error_category()) {
+    return false;
+  }
+
+  const mongocxx::operation_exception* operationXcp =
+      dynamic_cast< const mongocxx::operation_exception* >(&xcp);
+  if (operationXcp && operationXcp->has_error_label("NetworkError")) {
+    return true;
+  }
+
+  // The errors of the C driver and of the server share an error category, so
+  // they are told apart by the server reply.
+  bool serverError = operationXcp && operationXcp->raw_server_error()
+                     && !operationXcp->raw_server_error()->view().empty();
+  if (serverError) {
+    return SERVER_TRANSPORT_ERROR_CODES.count(xcp.code().value()) > 0;
+  }
+
+  return CLIENT_TRANSPORT_ERROR_CODES.count(xcp.code().value()) > 0;
+}
+
+bool Connection::Reconnect(DocumentDbError& err) {
+  int32_t attempts = config_.GetReconnectAttempts();
+  if (attempts <= 0 || !connection_.IsValid()) {
+    err = DocumentDbError(DocumentDbError::DOCUMENTDB_ERR_NETWORK_FAILURE,
+                          "Connection to DocumentDB was lost.");
+    return false;
+  }
+
+  CsLockGuard guard(reconnectLock_);
+
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+
+  // The backoff keeps growing across reconnects that failed in a row, so
+  // that a flapping server is not flooded with reconnects.
+  int64_t backoffMs = config_.GetReconnectBackoffMs();
+  for (int32_t i = 0;
+       i < reconnectFailuresInRow_ && backoffMs < MAX_RECONNECT_BACKOFF_MS;
+       ++i) {
+    backoffMs *= 2;
+  }
+
+  std::minstd_rand random(std::random_device{}());
+  bool reconnected = false;
+  for (int32_t attempt = 0; attempt < attempts && !reconnected; ++attempt) {
+    backoffMs = std::min< int64_t >(backoffMs, MAX_RECONNECT_BACKOFF_MS);
+    std::uniform_int_distribution< int64_t > jitter(backoffMs / 2, backoffMs);
+    std::this_thread::sleep_for(std::chrono::milliseconds(jitter(random)));
+    backoffMs *= 2;
+
+    ++reconnectAttempts_;
+    Metrics::Increment(Metrics::Counter::RECONNECT_ATTEMPTS);
+    reconnected = RestoreTransport(err);
+
+    LOG_INFO_MSG("Reconnect attempt " << (attempt + 1) << " of " << attempts
+                                      << (reconnected ? " succeeded"
+                                                      : " failed"));
+  }
+
+  reconnectTimeMs_ += static_cast< uint32_t >(
+      std::chrono::duration_cast< std::chrono::milliseconds >(
+          std::chrono::steady_clock::now() - start)
+          .count());
+
+  if (reconnected) {
+    reconnectFailuresInRow_ = 0;
+  } else {
+    ++reconnectFailuresInRow_;
+    ++reconnectFailures_;
+    Metrics::Increment(Metrics::Counter::RECONNECT_FAILURES);
+  }
+
+  return reconnected;
+}
+
+bool Connection::RestoreTransport(DocumentDbError& err) {
+  // Another statement might have restored the connection already.
+  bool alive = false;
+  try {
+    std::shared_ptr< mongocxx::client > client = AcquireMongoClient();
+    auto db = (*client.get())[config_.GetDatabase()];
+    bsoncxx::builder::stream::document pingCommand;
+    pingCommand << "ping" << 1;
+    auto result = db.run_command(pingCommand.view());
+    alive = result.view()["ok"].get_double() == 1;
+  } catch (const mongocxx::exception& xcp) {
+    LOG_DEBUG_MSG("Client pool is broken: " << xcp.what());
+  }
+
+  bool tunnelReplaced = false;
+  if (!alive) {
+    int32_t localSSHTunnelPort = GetLocalSSHTunnelPort();
+    if (!ConnectCPPDocumentDB(localSSHTunnelPort, true, err)) {
+      // The shared SSH tunnel itself might be dead, in which case every
+      // attempt through its local port fails the same way.
+      if (sshTunnelKey_.empty()
+          || !ReacquireSshTunnel(localSSHTunnelPort, err)) {
+        return false;
+      }
+      tunnelReplaced = true;
+
+      if (!ConnectCPPDocumentDB(localSSHTunnelPort, true, err)) {
+        return false;
+      }
+    }
+
+    // The server might have changed on failover.
+    ServerCapabilitiesCache::GetInstance().Invalidate(
+        ServerCapabilitiesCache::MakeKey(config_));
+  }
+
+  // The JDBC connection holds the schema and translation state, so it is only
+  // reopened if it was closed or went through the replaced tunnel.
+  if (tunnelReplaced || !connection_.Get()->IsOpen()) {
+    if (connection_.Get()->IsOpen()) {
+      JniErrorInfo errInfo;
+      connection_.Get()->Close(errInfo);
+    }
+
+    config::Configuration jdbcConfig = config_;
+    if (!sshTunnelKey_.empty()) {
+      jdbcConfig = SshTunnelManager::MakeTunneledConfiguration(
+          config_, GetLocalSSHTunnelPort());
+    }
+
+    if (!OpenJdbcConnection(jdbcConfig, err)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool Connection::GetServerCapabilities(ServerCapabilities& caps) {
+  ServerCapabilitiesCache& cache = ServerCapabilitiesCache::GetInstance();
+  std::string key = ServerCapabilitiesCache::MakeKey(config_);
+  if (cache.Get(key, caps)) {
+    return true;
+  }
+
+  if (!mongoPool_) {
+    return false;
+  }
+
+  try {
+    std::shared_ptr< mongocxx::client > client = AcquireMongoClient();
+    auto db = (*client.get())[config_.GetDatabase()];
+    if (!ServerCapabilitiesCache::Fetch(db, caps)) {
+      return false;
+    }
+  } catch (const mongocxx::exception& xcp) {
+    LOG_ERROR_MSG("Unable to get the server capabilities: " << xcp.what());
+    return false;
+  }
+
+  cache.Put(key, caps);
+
+  return true;
+}
+
+bool Connection::TryCheckoutPooledConnection() {
+  if (!env_ || config_.GetConnectionPoolSize() <= 0) {
+    return false;
+  }
+
+  ConnectionPool& pool = env_->GetConnectionPool();
+  std::string key = ConnectionPool::MakeKey(config_);
+  ConnectionPool::Entry entry;
+
+  while (pool.Checkout(key, entry)) {
+    bool alive = false;
+    if (entry.connection.IsValid() && entry.connection.Get()->IsOpen()
+        && entry.mongoPool) {
+      try {
+        mongocxx::pool::entry client = entry.mongoPool->acquire();
+        auto db = (*client)[config_.GetDatabase()];
+        bsoncxx::builder::stream::document pingCommand;
+        pingCommand << "ping" << 1;
+        auto result = db.run_command(pingCommand.view());
+        alive = result.view()["ok"].get_double() == 1;
+      } catch (const mongocxx::exception& xcp) {
+        LOG_INFO_MSG("Discarding dead pooled connection: " << xcp.what());
+      }
+    }
+
+    if (alive) {
+      jniContext_ = entry.jniContext;
+      connection_ = entry.connection;
+      {
+        CsLockGuard guard(transportLock_);
+        mongoPool_ = entry.mongoPool;
+        localSSHTunnelPort_ = entry.localSSHTunnelPort;
+      }
+      sshTunnelKey_ = entry.sshTunnelKey;
+      // The clients of the pool update the counters they were created with.
+      wireStatistics_ = entry.wireStatistics;
+      wireStatistics_->Reset();
+
+      UpdateConnectionRuntimeInfo(config_, info_);
+
+      LOG_DEBUG_MSG("Reusing pooled connection");
+
+      return true;
+    }
+
+    // The server might have changed, so its capabilities are fetched again
+    // by the next connection.
+    ServerCapabilitiesCache::GetInstance().Invalidate(
+        ServerCapabilitiesCache::MakeKey(config_));
+    ConnectionPool::Close(entry);
+  }
+
+  return false;
+}
+
+bool Connection::TryReturnToPool() {
+  if (!env_ || config_.GetConnectionPoolSize() <= 0
+      || !jniContext_.IsValid() || !connection_.IsValid() || !mongoPool_) {
+    return false;
+  }
+
+  ConnectionPool::Entry entry;
+  entry.jniContext = jniContext_;
+  entry.connection = connection_;
+  entry.mongoPool = mongoPool_;
+  entry.localSSHTunnelPort = GetLocalSSHTunnelPort();
+  entry.sshTunnelKey = sshTunnelKey_;
+  entry.wireStatistics = wireStatistics_;
+
+  if (!env_->GetConnectionPool().Return(
+          ConnectionPool::MakeKey(config_), entry,
+          config_.GetConnectionPoolSize(),
+          config_.GetConnectionPoolIdleTimeout())) {
+    return false;
+  }
+
+  connection_ = nullptr;
+  {
+    CsLockGuard guard(transportLock_);
+    mongoPool_.reset();
+    localSSHTunnelPort_ = 0;
+  }
+  sshTunnelKey_.clear();
+  wireStatistics_ = std::make_shared< WireStatistics >();
+
+  return true;
+}
 }  // namespace odbc
 }  // namespace documentdb
@@ -0,0 +1,196 @@
+/*
+ * Copyright <2022> Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ */
+
+
+#include "documentdb/odbc/connection_pool.h"
+
+#include <functional>
+#include <sstream>
+
+#include "documentdb/odbc/config/connection_string_parser.h"
+#include "documentdb/odbc/log.h"
+#include "documentdb/odbc/metrics.h"
+#include "documentdb/odbc/ssh_tunnel_manager.h"
+
+using documentdb::odbc::common::concurrent::CsLockGuard;
+using documentdb::odbc::config::Configuration;
+using documentdb::odbc::config::ConnectionStringParser;
+using documentdb::odbc::jni::java::JniErrorCode;
+using documentdb::odbc::jni::java::JniErrorInfo;
+
+namespace documentdb {
+namespace odbc {
+ConnectionPool::~ConnectionPool() {
+  Clear();
+}
+
+std::string ConnectionPool::MakeKey(const Configuration& config) {
+  Configuration::ArgumentMap arguments;
+  config.ToMap(arguments);
+
+  arguments.erase(ConnectionStringParser::Key::dsn);
+  arguments.erase(ConnectionStringParser::Key::user);
+  arguments.erase(ConnectionStringParser::Key::password);
+  // Only used while opening the connection, see Environment::RunPrewarm.
+  arguments.erase(ConnectionStringParser::Key::loginTimeoutSec);
+
+  std::stringstream key;
+  for (Configuration::ArgumentMap::const_iterator it = arguments.begin();
+       it != arguments.end(); ++it) {
+    key << it->first << '=' << it->second << ';';
+  }
+
+  std::string credentials = config.GetUser();
+  credentials.push_back('\0');
+  credentials.append(config.GetPassword());
+  key << "credentials=" << std::hex << std::hash< std::string >()(credentials);
+
+  return key.str();
+}
+
+bool ConnectionPool::Checkout(const std::string& key, Entry& entry) {
+  std::vector< Entry > expired;
+  bool found = false;
+
+  {
+    CsLockGuard guard(lock);
+
+    TakeExpired(Clock::now(), expired);
+
+    std::map< std::string, IdleList >::iterator it = idle.find(key);
+    if (it != idle.end() && !it->second.empty()) {
+      entry = it->second.back().entry;
+      it->second.pop_back();
+      found = true;
+    }
+  }
+
+  for (Entry& conn : expired) {
+    Close(conn);
+  }
+
+  Metrics::Increment(found ? Metrics::Counter::POOL_HITS
+                           : Metrics::Counter::POOL_MISSES);
+
+  LOG_DEBUG_MSG("Connection pool checkout: " << (found ? "hit" : "miss")
+                                             << ", closed " << expired.size()
+                                             << " expired connections");
+
+  return found;
+}
+
+bool ConnectionPool::Return(const std::string& key, const Entry& entry,
+                            int32_t maxSize, int32_t idleTimeout) {
+  if (maxSize <= 0 || idleTimeout <= 0)
+    return false;
+
+  std::vector< Entry > expired;
+  bool pooled = false;
+
+  {
+    CsLockGuard guard(lock);
+
+    Clock::time_point now = Clock::now();
+    TakeExpired(now, expired);
+
+    IdleList& list = idle[key];
+    if (list.size() < static_cast< size_t >(maxSize)) {
+      IdleEntry idleEntry;
+      idleEntry.entry = entry;
+      idleEntry.expires = now + std::chrono::seconds(idleTimeout);
+      list.push_back(idleEntry);
+      pooled = true;
+    }
+  }
+
+  for (Entry& conn : expired) {
+    Close(conn);
+  }
+
+  LOG_DEBUG_MSG("Connection pool return: "
+                << (pooled ? "pooled" : "pool is full"));
+
+  return pooled;
+}
+
+void ConnectionPool::Close(Entry& entry) {
+  if (entry.jniContext.IsValid() && entry.connection.IsValid()) {
+    JniErrorInfo errInfo;
+    entry.connection.Get()->Close(errInfo);
+    if (errInfo.code != JniErrorCode::DOCUMENTDB_JNI_ERR_SUCCESS) {
+      LOG_ERROR_MSG("Unable to close pooled connection: " << errInfo.errMsg);
+    }
+  }
+
+  entry.connection = nullptr;
+  entry.mongoPool.reset();
+  entry.jniContext = nullptr;
+
+  if (!entry.sshTunnelKey.empty()) {
+    SshTunnelManager::GetInstance().Release(entry.sshTunnelKey);
+    entry.sshTunnelKey.clear();
+  }
+}
+
+size_t ConnectionPool::GetIdleCount(const std::string& key) {
+  CsLockGuard guard(lock);
+
+  std::map< std::string, IdleList >::const_iterator it = idle.find(key);
+
+  return it == idle.end() ? 0 : it->second.size();
+}
+
+void ConnectionPool::Clear() {
+  std::vector< Entry > closed;
+
+  {
+    CsLockGuard guard(lock);
+
+    for (auto& keyList : idle) {
+      for (IdleEntry& idleEntry : keyList.second) {
+        closed.push_back(idleEntry.entry);
+      }
+    }
+    idle.clear();
+  }
+
+  for (Entry& conn : closed) {
+    Close(conn);
+  }
+}
+
+void ConnectionPool::TakeExpired(Clock::time_point now,
+                                 std::vector< Entry >& expired) {
+  std::map< std::string, IdleList >::iterator it = idle.begin();
+  while (it != idle.end()) {
+    IdleList& list = it->second;
+
+    // Entries are returned in order, so the oldest ones expire first.
+    IdleList::iterator end = list.begin();
+    while (end != list.end() && end->expires <= now) {
+      expired.push_back(end->entry);
+      ++end;
+    }
+    list.erase(list.begin(), end);
+
+    if (list.empty())
+      it = idle.erase(it);
+    else
+      ++it;
+  }
+}
+}  // namespace odbc
+}  // namespace documentdb
@@ -17,6 +17,7 @@
 
 #include "documentdb/odbc/diagnostic/diagnosable_adapter.h"
 
+#include "documentdb/odbc/allocation_tracker.h"
 #include "documentdb/odbc/connection.h"
 #include "documentdb/odbc/log.h"
 #include "documentdb/odbc/odbc_error.h"
@@ -27,6 +28,12 @@ namespace diagnostic {
 void DiagnosableAdapter::AddStatusRecord(SqlState::Type sqlState,
                                          const std::string& message,
                                          int32_t rowNum, int32_t columnNum) {
+  // A repeated condition of a column only updates the existing record.
+  if (diagnosticRecords.MergeStatusRecord(sqlState, rowNum, columnNum))
+    return;
+
+  DOCUMENTDB_ALLOCATION_SCOPE(DIAGNOSTICS);
+
   LOG_MSG("Adding new record: " << message << ", rowNum: " << rowNum
                                 << ", columnNum: " << columnNum);
 
@@ -39,6 +46,17 @@ void DiagnosableAdapter::AddStatusRecord(SqlState::Type sqlState,
   }
 }
 
+void DiagnosableAdapter::AddStatusRecord(SqlState::Type sqlState,
+                                         const char* message, int32_t rowNum,
+                                         int32_t columnNum) {
+  // Checked before the message is copied, as the conversion of every
+  // truncated cell of a fetch reports the same condition.
+  if (diagnosticRecords.MergeStatusRecord(sqlState, rowNum, columnNum))
+    return;
+
+  AddStatusRecord(sqlState, std::string(message), rowNum, columnNum);
+}
+
 void DiagnosableAdapter::AddStatusRecord(SqlState::Type sqlState,
                                          const std::string& message) {
   AddStatusRecord(sqlState, message, 0, 0);
@@ -18,6 +18,7 @@
 #include "documentdb/odbc/diagnostic/diagnostic_record.h"
 
 #include <set>
+#include <sstream>
 #include <string>
 
 namespace {
@@ -167,6 +168,9 @@ DiagnosticRecord::DiagnosticRecord()
       serverName(),
       rowNum(0),
       columnNum(0),
+      lastRowNum(0),
+      occurrences(1),
+      formattedMessage(),
       retrieved(false) {
   // No-op.
 }
@@ -182,6 +186,9 @@ DiagnosticRecord::DiagnosticRecord(SqlState::Type sqlState,
       serverName(serverName),
       rowNum(rowNum),
       columnNum(columnNum),
+      lastRowNum(rowNum),
+      occurrences(1),
+      formattedMessage(),
       retrieved(false) {
   // No-op.
 }
@@ -258,7 +265,17 @@ const std::string& DiagnosticRecord::GetSubclassOrigin() const {
 }
 
 const std::string& DiagnosticRecord::GetMessageText() const {
-  return message;
+  if (occurrences == 1)
+    return message;
+
+  if (formattedMessage.empty()) {
+    std::stringstream text;
+    text << message << " (" << occurrences << " occurrences, rows " << rowNum
+         << " to " << lastRowNum << ")";
+    formattedMessage = text.str();
+  }
+
+  return formattedMessage;
 }
 
 const std::string& DiagnosticRecord::GetConnectionName() const {
@@ -401,6 +418,10 @@ const std::string& DiagnosticRecord::GetSqlState() const {
   return STATE_UNKNOWN;
 }
 
+SqlState::Type DiagnosticRecord::GetSqlStateCode() const {
+  return sqlState;
+}
+
 int32_t DiagnosticRecord::GetRowNumber() const {
   return rowNum;
 }
@@ -409,6 +430,20 @@ int32_t DiagnosticRecord::GetColumnNumber() const {
   return columnNum;
 }
 
+int32_t DiagnosticRecord::GetLastRowNumber() const {
+  return lastRowNum;
+}
+
+int64_t DiagnosticRecord::GetOccurrences() const {
+  return occurrences;
+}
+
+void DiagnosticRecord::AddOccurrence(int32_t rowNum) {
+  lastRowNum = rowNum;
+  ++occurrences;
+  formattedMessage.clear();
+}
+
 bool DiagnosticRecord::IsRetrieved() const {
   return retrieved;
 }
@@ -19,17 +19,49 @@
 
 #include <set>
 #include <string>
+#include "documentdb/odbc/allocation_tracker.h"
 #include "documentdb/odbc/log.h"
+#include "documentdb/odbc/metrics.h"
+
+namespace {
+/**
+ * Check if a SQL state is a warning (class 01).
+ *
+ * @param sqlState SQL state.
+ * @return True if the state is a warning.
+ */
+bool IsWarning(documentdb::odbc::SqlState::Type sqlState) {
+  using documentdb::odbc::SqlState;
+
+  switch (sqlState) {
+    case SqlState::S01004_DATA_TRUNCATED:
+    case SqlState::S01S00_INVALID_CONNECTION_STRING_ATTRIBUTE:
+    case SqlState::S01S01_ERROR_IN_ROW:
+    case SqlState::S01S02_OPTION_VALUE_CHANGED:
+    case SqlState::S01S07_FRACTIONAL_TRUNCATION:
+      return true;
+
+    default:
+      return false;
+  }
+}
+}  // namespace
 
 namespace documentdb {
 namespace odbc {
 namespace diagnostic {
+const int32_t DiagnosticRecordStorage::DEFAULT_RECORD_LIMIT = 1000;
+
 DiagnosticRecordStorage::DiagnosticRecordStorage()
     : rowCount(0),
       dynamicFunction(),
       dynamicFunctionCode(0),
       result(SqlResult::AI_SUCCESS),
-      rowsAffected(0) {
+      rowsAffected(0),
+      statusRecords(),
+      columnRecords(),
+      recordLimit(DEFAULT_RECORD_LIMIT),
+      droppedRecords(0) {
   // No-op.
 }
 
@@ -47,17 +79,79 @@ void DiagnosticRecordStorage::SetHeaderRecord(SqlResult::Type result) {
 
 void DiagnosticRecordStorage::AddStatusRecord(SqlState::Type sqlState,
                                               const std::string& message) {
-  statusRecords.push_back(DiagnosticRecord(sqlState, message, "", "", 0, 0));
+  AddStatusRecord(DiagnosticRecord(sqlState, message, "", "", 0, 0));
 }
 
 void DiagnosticRecordStorage::AddStatusRecord(const DiagnosticRecord& record) {
+  if (MergeStatusRecord(record.GetSqlStateCode(), record.GetRowNumber(),
+                        record.GetColumnNumber()))
+    return;
+
+  DOCUMENTDB_ALLOCATION_SCOPE(DIAGNOSTICS);
+
+  CountError(record);
+
+  if (record.GetColumnNumber() > 0)
+    columnRecords[ColumnRecordKey(record.GetSqlStateCode(),
+                                  record.GetColumnNumber())] =
+        statusRecords.size();
+
   statusRecords.push_back(record);
 }
 
+bool DiagnosticRecordStorage::MergeStatusRecord(SqlState::Type sqlState,
+                                                int32_t rowNum,
+                                                int32_t columnNum) {
+  if (columnNum > 0) {
+    std::map< ColumnRecordKey, size_t >::const_iterator it =
+        columnRecords.find(ColumnRecordKey(sqlState, columnNum));
+
+    if (it != columnRecords.end()) {
+      DiagnosticRecord& record = statusRecords[it->second];
+      CountError(record);
+      record.AddOccurrence(rowNum);
+
+      return true;
+    }
+  }
+
+  // Errors are always stored, so that a call that fails reports why.
+  if (statusRecords.size() < static_cast< size_t >(recordLimit)
+      || !IsWarning(sqlState))
+    return false;
+
+  if (droppedRecords++ == 0)
+    LOG_INFO_MSG("Diagnostic record limit " << recordLimit
+                 << " is reached, further warnings are dropped");
+
+  return true;
+}
+
+void DiagnosticRecordStorage::SetRecordLimit(int32_t limit) {
+  recordLimit = limit;
+}
+
+int32_t DiagnosticRecordStorage::GetRecordLimit() const {
+  return recordLimit;
+}
+
+int64_t DiagnosticRecordStorage::GetDroppedRecordsNumber() const {
+  return droppedRecords;
+}
+
+void DiagnosticRecordStorage::CountError(const DiagnosticRecord& record) {
+  // Warnings (class 01) are not counted as errors.
+  const std::string& sqlState = record.GetSqlState();
+  if (sqlState.compare(0, 2, "01") != 0)
+    Metrics::GetInstance().AddError(sqlState);
+}
+
 void DiagnosticRecordStorage::Reset() {
   SetHeaderRecord(SqlResult::AI_ERROR);
 
   statusRecords.clear();
+  columnRecords.clear();
+  droppedRecords = 0;
 }
 
 SqlResult::Type DiagnosticRecordStorage::GetOperaionResult() const {
@@ -16,6 +16,7 @@
  */
 
 #include "documentdb/odbc/documentdb_cursor.h"
+#include "documentdb/odbc/allocation_tracker.h"
 #include "mongocxx/cursor.hpp"
 
 namespace documentdb {
@@ -23,23 +24,73 @@ namespace odbc {
 DocumentDbCursor::DocumentDbCursor(
     mongocxx::cursor& cursor, std::vector< JdbcColumnMetadata >& columnMetadata,
     std::vector< std::string >& paths)
-    : cursor_(std::move(cursor)),
-      iterator_(cursor_.begin()),
-      iteratorEnd_(cursor_.end()),
+    : cursor_(new mongocxx::cursor(std::move(cursor))),
+      iterator_(cursor_->begin()),
+      iteratorEnd_(cursor_->end()),
       columnMetadata_(columnMetadata),
       paths_(paths) {
   // No-op.
 }
 
+DocumentDbCursor::DocumentDbCursor(
+    std::unique_ptr< DocumentDbPartitionedScan > scan,
+    std::vector< JdbcColumnMetadata >& columnMetadata,
+    std::vector< std::string >& paths)
+    : columnMetadata_(columnMetadata),
+      paths_(paths),
+      scan_(std::move(scan)) {
+  // No-op.
+}
+
+DocumentDbCursor::DocumentDbCursor(
+    bsoncxx::document::value document,
+    std::vector< JdbcColumnMetadata >& columnMetadata,
+    std::vector< std::string >& paths)
+    : columnMetadata_(columnMetadata),
+      paths_(paths),
+      currentDocument_(new bsoncxx::document::value(std::move(document))),
+      singleDocument_(true) {
+  // No-op.
+}
+
 DocumentDbCursor::~DocumentDbCursor() {
   currentRow_.release();
 }
 
 bool DocumentDbCursor::Increment() {
+  DOCUMENTDB_ALLOCATION_SCOPE(CURSOR);
+
+  if (singleDocument_) {
+    if (isFirstRow_ && currentDocument_) {
+      isFirstRow_ = false;
+      currentRow_.reset(new DocumentDbRow(currentDocument_->view(),
+                                          columnMetadata_, paths_));
+      return true;
+    }
+    currentRow_.reset();
+    currentDocument_.reset();
+    return false;
+  }
+
+  if (scan_) {
+    scanExhausted_ = scanExhausted_ || !scan_->Next(currentDocument_);
+    if (scanExhausted_) {
+      currentRow_.reset();
+      return false;
+    }
+    if (currentRow_) {
+      (*currentRow_).Update(currentDocument_->view());
+    } else {
+      currentRow_.reset(new DocumentDbRow(currentDocument_->view(),
+                                          columnMetadata_, paths_));
+    }
+    return true;
+  }
+
   bool hasData = HasData();
   if (hasData) {
     if (!isFirstRow_) {
-      iterator_++;
+      (*iterator_)++;
     } else {
       isFirstRow_ = false;
     }
@@ -47,9 +98,10 @@ bool DocumentDbCursor::Increment() {
   hasData = HasData();
   if (hasData) {
     if (currentRow_) {
-      (*currentRow_).Update(*iterator_);
+      (*currentRow_).Update(**iterator_);
     } else {
-      currentRow_.reset(new DocumentDbRow(*iterator_, columnMetadata_, paths_));
+      currentRow_.reset(
+          new DocumentDbRow(**iterator_, columnMetadata_, paths_));
     }
   } else {
     currentRow_.reset();
@@ -58,11 +110,21 @@ bool DocumentDbCursor::Increment() {
 }
 
 bool DocumentDbCursor::HasData() const {
-  return iterator_ != iteratorEnd_;
+  if (singleDocument_) {
+    return currentDocument_ != nullptr;
+  }
+  if (scan_) {
+    return !scanExhausted_;
+  }
+  return *iterator_ != *iteratorEnd_;
 }
 
 DocumentDbRow* DocumentDbCursor::GetRow() {
   return currentRow_.get();
 }
+
+bool DocumentDbCursor::GetError(DocumentDbError& error) const {
+  return scan_ && scan_->GetError(error);
+}
 }  // namespace odbc
 }  // namespace documentdb
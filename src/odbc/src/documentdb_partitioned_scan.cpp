@@ -0,0 +1,300 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "documentdb/odbc/documentdb_partitioned_scan.h"
+
+#include <algorithm>
+#include <bsoncxx/builder/basic/array.hpp>
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
+#include <bsoncxx/exception/exception.hpp>
+#include <bsoncxx/json.hpp>
+#include <bsoncxx/oid.hpp>
+#include <mongocxx/client.hpp>
+#include <mongocxx/exception/exception.hpp>
+#include <mongocxx/pipeline.hpp>
+#include <set>
+#include <sstream>
+
+#include "documentdb/odbc/connection.h"
+#include "documentdb/odbc/log.h"
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_document;
+using documentdb::odbc::common::concurrent::CsLockGuard;
+
+namespace {
+/** Number of _id values sampled per partition to compute the boundaries. */
+const int32_t SAMPLES_PER_PARTITION = 16;
+
+/**
+ * BSON type numbers of the _id values that are not ObjectId: every type but
+ * ObjectId, array, undefined and regex, which are not allowed for _id.
+ */
+const int32_t NON_OID_ID_TYPES[] = {-1, 1,  2,  3,  5,  8,  9,  10, 12,
+                                    13, 14, 15, 16, 17, 18, 19, 127};
+
+/**
+ * Stages whose result depends on the order of the input or on the whole
+ * input, and so cannot be computed per partition.
+ */
+const std::set< std::string > NON_PARTITIONABLE_STAGES = {
+    "$sort",       "$limit",  "$skip",  "$group",       "$count", "$bucket",
+    "$bucketAuto", "$sample", "$facet", "$sortByCount", "$out"};
+}  // namespace
+
+namespace documentdb {
+namespace odbc {
+DocumentDbPartitionedScan::DocumentDbPartitionedScan(
+    const Connection& connection, const std::string& databaseName,
+    const std::string& collectionName, const std::vector< std::string >& stages,
+    const mongocxx::options::aggregate& options, size_t queueCapacity)
+    : connection_(connection),
+      databaseName_(databaseName),
+      collectionName_(collectionName),
+      stages_(stages),
+      options_(options),
+      queueCapacity_(queueCapacity > 0 ? queueCapacity : 1) {
+  // No-op.
+}
+
+DocumentDbPartitionedScan::~DocumentDbPartitionedScan() {
+  Cancel();
+}
+
+bool DocumentDbPartitionedScan::IsPartitionable(
+    const std::vector< std::string >& stages) {
+  try {
+    for (auto const& stage : stages) {
+      bsoncxx::document::value doc = bsoncxx::from_json(stage);
+      for (auto const& element : doc.view()) {
+        if (NON_PARTITIONABLE_STAGES.count(element.key().to_string()) > 0)
+          return false;
+      }
+    }
+  } catch (const bsoncxx::exception& xcp) {
+    LOG_DEBUG_MSG("Unable to parse pipeline stage: " << xcp.what());
+    return false;
+  }
+  return true;
+}
+
+bool DocumentDbPartitionedScan::Start(mongocxx::collection& collection,
+                                      int32_t partitions) {
+  LOG_DEBUG_MSG("Start is called with partitions: " << partitions);
+
+  if (partitions < 2) {
+    return false;
+  }
+
+  std::vector< bsoncxx::oid > ids;
+  try {
+    mongocxx::pipeline sample;
+    sample.sample(partitions * SAMPLES_PER_PARTITION);
+    sample.project(make_document(kvp("_id", 1)));
+    sample.sort(make_document(kvp("_id", 1)));
+
+    mongocxx::cursor cursor = collection.aggregate(sample);
+    for (auto const& doc : cursor) {
+      bsoncxx::document::element id = doc["_id"];
+      // Range boundaries are only meaningful within a single BSON type. The
+      // other types are read by their own partition.
+      if (id.type() != bsoncxx::type::k_oid) {
+        continue;
+      }
+      bsoncxx::oid oid = id.get_oid().value;
+      if (ids.empty() || ids.back() != oid) {
+        ids.push_back(oid);
+      }
+    }
+  } catch (const mongocxx::exception& xcp) {
+    LOG_INFO_MSG("Unable to sample partition boundaries: " << xcp.what());
+    return false;
+  }
+
+  std::vector< bsoncxx::oid > bounds;
+  for (int32_t i = 1; i < partitions && !ids.empty(); ++i) {
+    const bsoncxx::oid& bound = ids[i * ids.size() / partitions];
+    if (bounds.empty() || bounds.back() != bound) {
+      bounds.push_back(bound);
+    }
+  }
+
+  if (bounds.empty()) {
+    LOG_DEBUG_MSG("Start exiting: not enough documents to partition");
+    return false;
+  }
+
+  filters_.push_back(
+      make_document(kvp("_id", make_document(kvp("$lt", bounds.front())))));
+  for (size_t i = 1; i < bounds.size(); ++i) {
+    filters_.push_back(make_document(
+        kvp("_id", make_document(kvp("$gte", bounds[i - 1]),
+                                 kvp("$lt", bounds[i])))));
+  }
+  filters_.push_back(
+      make_document(kvp("_id", make_document(kvp("$gte", bounds.back())))));
+  // The ranges only match ObjectId values, as comparisons are type-bracketed.
+  // The other types are listed rather than negated, so that the predicate
+  // has _id index bounds instead of scanning the whole collection again.
+  bsoncxx::builder::basic::array types;
+  for (int32_t type : NON_OID_ID_TYPES) {
+    types.append(type);
+  }
+  filters_.push_back(make_document(
+      kvp("_id", make_document(kvp("$type", types.extract())))));
+
+  size_t workers = std::min(filters_.size(), static_cast< size_t >(partitions));
+  CsLockGuard guard(lock_);
+  for (size_t i = 0; i < workers; ++i) {
+    workers_.push_back(std::thread(&DocumentDbPartitionedScan::Run, this));
+    ++activeWorkers_;
+  }
+
+  LOG_DEBUG_MSG("Start exiting with " << filters_.size() << " partitions on "
+                                      << workers << " workers");
+
+  return true;
+}
+
+bool DocumentDbPartitionedScan::Next(
+    std::unique_ptr< bsoncxx::document::value >& document) {
+  CsLockGuard guard(lock_);
+
+  while (queue_.empty() && activeWorkers_ > 0 && !cancelled_) {
+    notEmpty_.Wait(lock_);
+  }
+
+  if (cancelled_ || queue_.empty()) {
+    return false;
+  }
+
+  document.reset(new bsoncxx::document::value(std::move(queue_.front())));
+  queue_.pop_front();
+  notFull_.NotifyOne();
+
+  return true;
+}
+
+void DocumentDbPartitionedScan::Cancel() {
+  {
+    CsLockGuard guard(lock_);
+    cancelled_ = true;
+    queue_.clear();
+    notFull_.NotifyAll();
+    notEmpty_.NotifyAll();
+  }
+
+  for (std::thread& worker : workers_) {
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+  workers_.clear();
+}
+
+bool DocumentDbPartitionedScan::GetError(DocumentDbError& error) const {
+  CsLockGuard guard(lock_);
+
+  if (error_.GetCode() == DocumentDbError::DOCUMENTDB_SUCCESS) {
+    return false;
+  }
+
+  error = error_;
+  return true;
+}
+
+void DocumentDbPartitionedScan::Run() {
+  std::string errMessage;
+  try {
+    std::shared_ptr< mongocxx::client > client =
+        connection_.CreateMongoClient();
+    mongocxx::collection collection =
+        (*client)[databaseName_][collectionName_];
+
+    while (true) {
+      size_t partition = 0;
+      {
+        CsLockGuard guard(lock_);
+        if (cancelled_ || nextPartition_ >= filters_.size()) {
+          break;
+        }
+        partition = nextPartition_++;
+      }
+      RunPartition(collection, filters_[partition]);
+    }
+  } catch (const mongocxx::exception& xcp) {
+    std::stringstream message;
+    message << "Partitioned scan failed."
+            << " code: " << xcp.code().value()
+            << " messagge: " << xcp.code().message()
+            << " cause: " << xcp.what();
+    errMessage = message.str();
+  } catch (const bsoncxx::exception& xcp) {
+    errMessage = std::string("Partitioned scan failed. cause: ") + xcp.what();
+  }
+
+  CsLockGuard guard(lock_);
+  if (!errMessage.empty()) {
+    LOG_ERROR_MSG(Logger::MarkSensitive(errMessage));
+    if (error_.GetCode() == DocumentDbError::DOCUMENTDB_SUCCESS) {
+      error_ = DocumentDbError(DocumentDbError::DOCUMENTDB_ERR_GENERIC,
+                               errMessage.c_str());
+    }
+    // The result would be incomplete, so stop the other partitions.
+    cancelled_ = true;
+    queue_.clear();
+  }
+  --activeWorkers_;
+  notEmpty_.NotifyAll();
+  notFull_.NotifyAll();
+}
+
+void DocumentDbPartitionedScan::RunPartition(
+    mongocxx::collection& collection, const bsoncxx::document::value& filter) {
+  mongocxx::pipeline pipeline;
+  pipeline.match(filter.view());
+  for (auto const& stage : stages_) {
+    pipeline.append_stage(bsoncxx::from_json(stage));
+  }
+
+  mongocxx::cursor cursor = collection.aggregate(pipeline, options_);
+  for (auto const& doc : cursor) {
+    if (!Push(doc)) {
+      return;
+    }
+  }
+}
+
+bool DocumentDbPartitionedScan::Push(const bsoncxx::document::view& document) {
+  CsLockGuard guard(lock_);
+
+  while (!cancelled_ && queue_.size() >= queueCapacity_) {
+    notFull_.Wait(lock_);
+  }
+
+  if (cancelled_) {
+    return false;
+  }
+
+  queue_.emplace_back(document);
+  notEmpty_.NotifyOne();
+
+  return true;
+}
+}  // namespace odbc
+}  // namespace documentdb
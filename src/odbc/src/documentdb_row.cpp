@@ -17,6 +17,7 @@
 
 #include "documentdb/odbc/jni/jdbc_column_metadata.h"
 #include "documentdb/odbc/documentdb_row.h"
+#include "documentdb/odbc/allocation_tracker.h"
 #include "documentdb/odbc/utility.h"
 #include "mongocxx/cursor.hpp"
 
@@ -38,6 +39,8 @@ DocumentDbRow::DocumentDbRow(bsoncxx::document::view const& document,
 }
 
 void DocumentDbRow::Update(bsoncxx::document::view const& document) {
+  DOCUMENTDB_ALLOCATION_SCOPE(ROW);
+
   document_ = document;
   for (DocumentDbColumn& column : columns_) {
     column.Update(document);
@@ -61,6 +64,8 @@ bool DocumentDbRow::EnsureColumnDiscovered(uint32_t columnIdx) {
   if (columns_.size() == size)
     return true;
 
+  DOCUMENTDB_ALLOCATION_SCOPE(ROW);
+
   int64_t index = columns_.size();
   while (columns_.size() < columnIdx) {
     DocumentDbColumn newColumn(document_, columnMetadata_[index],
@@ -263,6 +263,24 @@ void ReadDsnConfiguration(const char* dsn, Configuration& config,
   if (logPath.IsSet() && !config.IsLogPathSet())
     config.SetLogPath(logPath.GetValue());
 
+  SettableValue< bool > logAsync =
+      ReadDsnBool(dsn, ConnectionStringParser::Key::logAsync);
+
+  if (logAsync.IsSet() && !config.IsLogAsyncSet())
+    config.SetLogAsync(logAsync.GetValue());
+
+  SettableValue< std::string > logOverflow =
+      ReadDsnString(dsn, ConnectionStringParser::Key::logOverflow);
+
+  if (logOverflow.IsSet() && !config.IsLogOverflowSet())
+    config.SetLogOverflow(common::ToLower(logOverflow.GetValue()));
+
+  SettableValue< std::string > logFormat =
+      ReadDsnString(dsn, ConnectionStringParser::Key::logFormat);
+
+  if (logFormat.IsSet() && !config.IsLogFormatSet())
+    config.SetLogFormat(common::ToLower(logFormat.GetValue()));
+
   SettableValue< std::string > scanMethod =
       ReadDsnString(dsn, ConnectionStringParser::Key::scanMethod);
 
@@ -296,6 +314,165 @@ void ReadDsnConfiguration(const char* dsn, Configuration& config,
   if (defaultFetchSize.IsSet() && !config.IsDefaultFetchSizeSet()
       && defaultFetchSize.GetValue() > 0)
     config.SetDefaultFetchSize(defaultFetchSize.GetValue());
+
+  SettableValue< int32_t > parallelScanPartitions =
+      ReadDsnInt(dsn, ConnectionStringParser::Key::parallelScanPartitions);
+
+  if (parallelScanPartitions.IsSet() && !config.IsParallelScanPartitionsSet()
+      && parallelScanPartitions.GetValue() >= 0
+      && parallelScanPartitions.GetValue() <= MAX_PARALLEL_SCAN_PARTITIONS)
+    config.SetParallelScanPartitions(parallelScanPartitions.GetValue());
+
+  SettableValue< bool > approximateCount =
+      ReadDsnBool(dsn, ConnectionStringParser::Key::approximateCount);
+
+  if (approximateCount.IsSet() && !config.IsApproximateCountSet())
+    config.SetApproximateCount(approximateCount.GetValue());
+
+  SettableValue< bool > allowDiskUse =
+      ReadDsnBool(dsn, ConnectionStringParser::Key::allowDiskUse);
+
+  if (allowDiskUse.IsSet() && !config.IsAllowDiskUseSet())
+    config.SetAllowDiskUse(allowDiskUse.GetValue());
+
+  SettableValue< std::string > readConcern =
+      ReadDsnString(dsn, ConnectionStringParser::Key::readConcern);
+
+  if (readConcern.IsSet() && !config.IsReadConcernSet()) {
+    ReadConcern::Type level = ReadConcern::FromString(readConcern.GetValue());
+    if (level != ReadConcern::Type::UNKNOWN)
+      config.SetReadConcern(level);
+  }
+
+  SettableValue< std::string > comment =
+      ReadDsnString(dsn, ConnectionStringParser::Key::comment);
+
+  if (comment.IsSet() && !config.IsCommentSet())
+    config.SetComment(comment.GetValue());
+
+  SettableValue< int32_t > connectionPoolSize =
+      ReadDsnInt(dsn, ConnectionStringParser::Key::connectionPoolSize);
+
+  if (connectionPoolSize.IsSet() && !config.IsConnectionPoolSizeSet()
+      && connectionPoolSize.GetValue() >= 0
+      && connectionPoolSize.GetValue() <= MAX_CONNECTION_POOL_SIZE)
+    config.SetConnectionPoolSize(connectionPoolSize.GetValue());
+
+  SettableValue< int32_t > connectionPoolIdleTimeout =
+      ReadDsnInt(dsn, ConnectionStringParser::Key::connectionPoolIdleTimeout);
+
+  if (connectionPoolIdleTimeout.IsSet()
+      && !config.IsConnectionPoolIdleTimeoutSet()
+      && connectionPoolIdleTimeout.GetValue() >= 0
+      && connectionPoolIdleTimeout.GetValue()
+             <= MAX_CONNECTION_POOL_IDLE_TIMEOUT)
+    config.SetConnectionPoolIdleTimeout(connectionPoolIdleTimeout.GetValue());
+
+  SettableValue< int32_t > clientPoolSize =
+      ReadDsnInt(dsn, ConnectionStringParser::Key::clientPoolSize);
+
+  if (clientPoolSize.IsSet() && !config.IsClientPoolSizeSet()
+      && clientPoolSize.GetValue() > 0
+      && clientPoolSize.GetValue() <= MAX_CLIENT_POOL_SIZE)
+    config.SetClientPoolSize(clientPoolSize.GetValue());
+
+  SettableValue< int32_t > reconnectAttempts =
+      ReadDsnInt(dsn, ConnectionStringParser::Key::reconnectAttempts);
+
+  if (reconnectAttempts.IsSet() && !config.IsReconnectAttemptsSet()
+      && reconnectAttempts.GetValue() >= 0
+      && reconnectAttempts.GetValue() <= MAX_RECONNECT_ATTEMPTS)
+    config.SetReconnectAttempts(reconnectAttempts.GetValue());
+
+  SettableValue< int32_t > reconnectBackoffMs =
+      ReadDsnInt(dsn, ConnectionStringParser::Key::reconnectBackoffMs);
+
+  if (reconnectBackoffMs.IsSet() && !config.IsReconnectBackoffMsSet()
+      && reconnectBackoffMs.GetValue() > 0
+      && reconnectBackoffMs.GetValue() <= MAX_RECONNECT_BACKOFF_MS)
+    config.SetReconnectBackoffMs(reconnectBackoffMs.GetValue());
+
+  SettableValue< std::string > compressors =
+      ReadDsnString(dsn, ConnectionStringParser::Key::compressors);
+
+  std::string parsedCompressors;
+  if (compressors.IsSet() && !config.IsCompressorsSet()
+      && Configuration::ParseCompressors(compressors.GetValue(),
+                                         parsedCompressors))
+    config.SetCompressors(parsedCompressors);
+
+  SettableValue< int32_t > zlibCompressionLevel =
+      ReadDsnInt(dsn, ConnectionStringParser::Key::zlibCompressionLevel);
+
+  if (zlibCompressionLevel.IsSet() && !config.IsZlibCompressionLevelSet()
+      && zlibCompressionLevel.GetValue() >= 0
+      && zlibCompressionLevel.GetValue() <= MAX_ZLIB_COMPRESSION_LEVEL)
+    config.SetZlibCompressionLevel(zlibCompressionLevel.GetValue());
+
+  SettableValue< bool > analyticsRouting =
+      ReadDsnBool(dsn, ConnectionStringParser::Key::analyticsRouting);
+
+  if (analyticsRouting.IsSet() && !config.IsAnalyticsRoutingSet())
+    config.SetAnalyticsRouting(analyticsRouting.GetValue());
+
+  SettableValue< int32_t > localThresholdMs =
+      ReadDsnInt(dsn, ConnectionStringParser::Key::localThresholdMs);
+
+  if (localThresholdMs.IsSet() && !config.IsLocalThresholdMsSet()
+      && localThresholdMs.GetValue() >= 0
+      && localThresholdMs.GetValue() <= MAX_LOCAL_THRESHOLD_MS)
+    config.SetLocalThresholdMs(localThresholdMs.GetValue());
+
+  SettableValue< int32_t > poolPrewarmSize =
+      ReadDsnInt(dsn, ConnectionStringParser::Key::poolPrewarmSize);
+
+  if (poolPrewarmSize.IsSet() && !config.IsPoolPrewarmSizeSet()
+      && poolPrewarmSize.GetValue() >= 0
+      && poolPrewarmSize.GetValue() <= MAX_CONNECTION_POOL_SIZE)
+    config.SetPoolPrewarmSize(poolPrewarmSize.GetValue());
+
+  SettableValue< std::string > warmUpSqlFile =
+      ReadDsnString(dsn, ConnectionStringParser::Key::warmUpSqlFile);
+
+  if (warmUpSqlFile.IsSet() && !config.IsWarmUpSqlFileSet())
+    config.SetWarmUpSqlFile(warmUpSqlFile.GetValue());
+
+  SettableValue< std::string > metricsPath =
+      ReadDsnString(dsn, ConnectionStringParser::Key::metricsPath);
+
+  if (metricsPath.IsSet() && !config.IsMetricsPathSet())
+    config.SetMetricsPath(metricsPath.GetValue());
+
+  SettableValue< int32_t > metricsPort =
+      ReadDsnInt(dsn, ConnectionStringParser::Key::metricsPort);
+
+  if (metricsPort.IsSet() && !config.IsMetricsPortSet()
+      && metricsPort.GetValue() >= 0 && metricsPort.GetValue() <= UINT16_MAX)
+    config.SetMetricsPort(metricsPort.GetValue());
+
+  SettableValue< int32_t > metricsInterval =
+      ReadDsnInt(dsn, ConnectionStringParser::Key::metricsInterval);
+
+  if (metricsInterval.IsSet() && !config.IsMetricsIntervalSet()
+      && metricsInterval.GetValue() >= 1
+      && metricsInterval.GetValue() <= MAX_METRICS_INTERVAL)
+    config.SetMetricsInterval(metricsInterval.GetValue());
+
+  SettableValue< int32_t > diagRecordLimit =
+      ReadDsnInt(dsn, ConnectionStringParser::Key::diagRecordLimit);
+
+  if (diagRecordLimit.IsSet() && !config.IsDiagRecordLimitSet()
+      && diagRecordLimit.GetValue() >= 1
+      && diagRecordLimit.GetValue() <= MAX_DIAG_RECORD_LIMIT)
+    config.SetDiagRecordLimit(diagRecordLimit.GetValue());
+
+  SettableValue< int32_t > slowQueryThresholdMs =
+      ReadDsnInt(dsn, ConnectionStringParser::Key::slowQueryThresholdMs);
+
+  if (slowQueryThresholdMs.IsSet() && !config.IsSlowQueryThresholdMsSet()
+      && slowQueryThresholdMs.GetValue() >= 0
+      && slowQueryThresholdMs.GetValue() <= MAX_SLOW_QUERY_THRESHOLD_MS)
+    config.SetSlowQueryThresholdMs(slowQueryThresholdMs.GetValue());
 }
 
 bool WriteDsnConfiguration(const config::Configuration& config, DocumentDbError& error) {
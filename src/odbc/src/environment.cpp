@@ -17,20 +17,74 @@
 
 #include "documentdb/odbc/environment.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstdlib>
+#include <fstream>
+#include <future>
 
+#include "documentdb/odbc/common/utils.h"
 #include "documentdb/odbc/connection.h"
+#include "documentdb/odbc/dsn_config.h"
+#include "documentdb/odbc/jni/documentdb_query_mapping_service.h"
+#include "documentdb/odbc/log.h"
+#include "documentdb/odbc/metrics.h"
 #include "documentdb/odbc/system/odbc_constants.h"
 
+using documentdb::odbc::common::concurrent::CsLockGuard;
+using documentdb::odbc::common::concurrent::SharedPointer;
+using documentdb::odbc::jni::DocumentDbConnectionProperties;
+using documentdb::odbc::jni::DocumentDbDatabaseMetadata;
+using documentdb::odbc::jni::DocumentDbQueryMappingService;
+using documentdb::odbc::jni::java::JniErrorCode;
+using documentdb::odbc::jni::java::JniErrorInfo;
+
+namespace {
+/** Environment variable naming a DSN to pre-warm when the driver loads. */
+const char* PREWARM_DSN_VARIABLE = "DOCUMENTDB_ODBC_PREWARM_DSN";
+
+/**
+ * Maximum login timeout of the pre-warmed connections, which bounds the wait
+ * for the pre-warm when the environment is freed.
+ */
+const int32_t PREWARM_LOGIN_TIMEOUT_SECONDS = 10;
+
+/** Number of allocated environments. */
+std::atomic< int32_t > environmentCount(0);
+}  // namespace
+
 namespace documentdb {
 namespace odbc {
 Environment::Environment()
-    : connections(), odbcVersion(SQL_OV_ODBC3), odbcNts(SQL_TRUE) {
+    : connections(),
+      odbcVersion(SQL_OV_ODBC3),
+      odbcNts(SQL_TRUE),
+      prewarmCancelled(false) {
   srand(common::GetRandSeed());
+
+  ++environmentCount;
+
+  // The DSN is read on the pre-warm thread, not while the driver manager
+  // allocates the environment.
+  const char* dsn = std::getenv(PREWARM_DSN_VARIABLE);
+  if (dsn && *dsn) {
+    prewarmThreads.emplace_back(&Environment::RunDsnPrewarm, this,
+                                std::string(dsn));
+  }
 }
 
 Environment::~Environment() {
-  // No-op.
+  // The pre-warmed connections are returned to the pool of the environment,
+  // so the threads are joined before it is destroyed.
+  CancelPrewarm();
+  WaitForPrewarm();
+
+  // The background threads of the driver are stopped with the last
+  // environment, before the driver manager may unload the driver.
+  if (--environmentCount == 0) {
+    Metrics::GetInstance().StopExport();
+    Logger::GetLoggerInstance()->StopAsync();
+  }
 }
 
 Connection* Environment::CreateConnection() {
@@ -42,6 +96,8 @@ Connection* Environment::CreateConnection() {
 }
 
 void Environment::DeregisterConnection(Connection* conn) {
+  CsLockGuard guard(connectionsLock);
+
   connections.erase(conn);
 }
 
@@ -54,6 +110,8 @@ SqlResult::Type Environment::InternalCreateConnection(Connection*& connection) {
     return SqlResult::AI_ERROR;
   }
 
+  CsLockGuard guard(connectionsLock);
+
   connections.insert(connection);
 
   return SqlResult::AI_SUCCESS;
@@ -140,5 +198,174 @@ SqlResult::Type Environment::InternalGetAttribute(
 
   return SqlResult::AI_ERROR;
 }
+
+void Environment::Prewarm(const config::Configuration& config) {
+  if (config.GetPoolPrewarmSize() <= 0 || config.GetConnectionPoolSize() <= 0)
+    return;
+
+  CsLockGuard guard(prewarmLock);
+
+  if (prewarmCancelled
+      || !prewarmedKeys.insert(ConnectionPool::MakeKey(config)).second)
+    return;
+
+  prewarmThreads.emplace_back(&Environment::RunPrewarm, this, config);
+}
+
+void Environment::CancelPrewarm() {
+  CsLockGuard guard(prewarmLock);
+
+  prewarmCancelled = true;
+}
+
+bool Environment::IsPrewarmCancelled() {
+  CsLockGuard guard(prewarmLock);
+
+  return prewarmCancelled;
+}
+
+void Environment::WaitForPrewarm() {
+  std::vector< std::thread > threads;
+  {
+    CsLockGuard guard(prewarmLock);
+
+    threads.swap(prewarmThreads);
+  }
+
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+}
+
+void Environment::RunDsnPrewarm(const std::string dsn) {
+  config::Configuration config;
+  config.SetDsn(dsn);
+  ReadDsnConfiguration(dsn.c_str(), config, nullptr);
+
+  if (config.GetPoolPrewarmSize() <= 0 || config.GetConnectionPoolSize() <= 0)
+    return;
+
+  {
+    CsLockGuard guard(prewarmLock);
+
+    if (prewarmCancelled
+        || !prewarmedKeys.insert(ConnectionPool::MakeKey(config)).second)
+      return;
+  }
+
+  RunPrewarm(config);
+}
+
+void Environment::RunPrewarm(const config::Configuration config) {
+  int32_t size =
+      std::min(config.GetPoolPrewarmSize(), config.GetConnectionPoolSize());
+
+  // The login timeout is not part of the pool key, so the pooled connections
+  // are still checked out by the connections of the configuration.
+  config::Configuration prewarmConfig = config;
+  int32_t loginTimeout = config.GetLoginTimeoutSeconds();
+  if (loginTimeout <= 0 || loginTimeout > PREWARM_LOGIN_TIMEOUT_SECONDS)
+    prewarmConfig.SetLoginTimeoutSeconds(PREWARM_LOGIN_TIMEOUT_SECONDS);
+
+  LOG_INFO_MSG("Pre-warming " << size << " connections");
+
+  // All the connections are open before any is returned to the pool, so that
+  // each one is a new connection.
+  std::vector< std::future< Connection* > > pending;
+  for (int32_t i = 0; i < size; ++i) {
+    pending.push_back(
+        std::async(std::launch::async, [this, &prewarmConfig]() {
+          if (IsPrewarmCancelled())
+            return static_cast< Connection* >(nullptr);
+
+          Connection* connection = CreateConnection();
+          if (!connection)
+            return static_cast< Connection* >(nullptr);
+
+          connection->Establish(prewarmConfig);
+
+          if (connection->GetDiagnosticRecords().GetReturnCode()
+              == SQL_ERROR) {
+            LOG_ERROR_MSG("Unable to pre-warm connection");
+            connection->Deregister();
+            delete connection;
+            return static_cast< Connection* >(nullptr);
+          }
+          return connection;
+        }));
+  }
+
+  std::vector< Connection* > connections;
+  for (auto& future : pending) {
+    Connection* connection = future.get();
+    if (connection)
+      connections.push_back(connection);
+  }
+
+  if (!connections.empty() && !config.GetWarmUpSqlFile().empty()
+      && !IsPrewarmCancelled())
+    RunWarmUpQueries(*connections.front(), config.GetWarmUpSqlFile());
+
+  // When cancelled, the pool closes the connections when it is destroyed.
+  for (Connection* connection : connections) {
+    connection->Release();
+    connection->Deregister();
+    delete connection;
+  }
+
+  LOG_INFO_MSG("Pre-warmed " << connections.size() << " connections");
+}
+
+void Environment::RunWarmUpQueries(Connection& connection,
+                                   const std::string& path) {
+  std::ifstream file(path);
+  if (!file) {
+    LOG_ERROR_MSG("Unable to open warm-up SQL file: " << path);
+    return;
+  }
+
+  DocumentDbError error;
+  SharedPointer< DocumentDbConnectionProperties > connectionProperties =
+      connection.GetConnectionProperties(error);
+  if (error.GetCode() != DocumentDbError::DOCUMENTDB_SUCCESS) {
+    LOG_ERROR_MSG("Unable to warm up: "
+                  << Logger::MarkSensitive(error.GetText()));
+    return;
+  }
+  SharedPointer< DocumentDbDatabaseMetadata > databaseMetadata =
+      connection.GetDatabaseMetadata(error);
+  if (error.GetCode() != DocumentDbError::DOCUMENTDB_SUCCESS) {
+    LOG_ERROR_MSG("Unable to warm up: "
+                  << Logger::MarkSensitive(error.GetText()));
+    return;
+  }
+
+  JniErrorInfo errInfo;
+  SharedPointer< DocumentDbQueryMappingService > queryMappingService =
+      DocumentDbQueryMappingService::Create(connectionProperties,
+                                            databaseMetadata, errInfo);
+  if (errInfo.code != JniErrorCode::DOCUMENTDB_JNI_ERR_SUCCESS) {
+    LOG_ERROR_MSG("Unable to warm up: " << errInfo.errMsg);
+    return;
+  }
+
+  int translated = 0;
+  std::string sql;
+  while (std::getline(file, sql)) {
+    common::StripSurroundingWhitespaces(sql);
+    if (sql.empty() || sql.compare(0, 2, "--") == 0)
+      continue;
+
+    queryMappingService.Get()->GetMqlQueryContext(sql, 0, errInfo);
+    if (errInfo.code != JniErrorCode::DOCUMENTDB_JNI_ERR_SUCCESS) {
+      LOG_INFO_MSG("Unable to translate warm-up query: "
+                   << Logger::MarkSensitive(errInfo.errMsg));
+      continue;
+    }
+    ++translated;
+  }
+
+  LOG_INFO_MSG("Translated " << translated << " warm-up queries");
+}
 }  // namespace odbc
 }  // namespace documentdb
@@ -16,12 +16,15 @@
  */
 
 // ReSharper disable once CppUnusedIncludeDirective
+#include <documentdb/odbc/allocation_tracker.h>
 #include <documentdb/odbc/common/common.h>
 #include <documentdb/odbc/common/utils.h>
 #include <documentdb/odbc/documentdb_error.h>
 #include <documentdb/odbc/jni/java.h>
 #include <documentdb/odbc/jni/utils.h>
 #include <documentdb/odbc/log.h>
+#include <documentdb/odbc/metrics.h>
+#include <documentdb/odbc/probes.h>
 
 #include <algorithm>
 #include <cstring>  // needed only on linux
@@ -450,6 +453,8 @@ char* StringToChars(JNIEnv* env, jstring str, int* len) {
     return nullptr;
   }
 
+  DOCUMENTDB_ALLOCATION_SCOPE(JNI);
+
   const char* strChars = env->GetStringUTFChars(str, nullptr);
   const int strCharsLen = env->GetStringUTFLength(str);
 
@@ -469,6 +474,8 @@ char* StringToChars(JNIEnv* env, jstring str, int* len) {
 std::string JavaStringToCString(JNIEnv* env, jstring str, int& len) {
   LOG_DEBUG_MSG("JavaStringToCString is called");
 
+  DOCUMENTDB_ALLOCATION_SCOPE(JNI);
+
   char* resChars = StringToChars(env, str, &len);
 
   if (resChars) {
@@ -1315,6 +1322,8 @@ JniErrorCode JniContext::DocumentDbDatabaseSchemaMetadataGetSchemaName(
   if (errInfo.code == JniErrorCode::DOCUMENTDB_JNI_ERR_SUCCESS) {
     wasNull = !result;
     if (result != nullptr) {
+      DOCUMENTDB_ALLOCATION_SCOPE(JNI);
+
       jboolean isCopy;
       const char* utfChars = env->GetStringUTFChars((jstring)result, &isCopy);
       value = std::string(utfChars);
@@ -1718,6 +1727,8 @@ JniErrorCode JniContext::ResultSetGetString(
 
   if (errInfo.code == JniErrorCode::DOCUMENTDB_JNI_ERR_SUCCESS) {
     if (result != nullptr) {
+      DOCUMENTDB_ALLOCATION_SCOPE(JNI);
+
       jboolean isCopy;
       const char* utfChars = env->GetStringUTFChars((jstring)result, &isCopy);
       value = std::string(utfChars);
@@ -1761,6 +1772,8 @@ JniErrorCode JniContext::ResultSetGetString(
 
   if (errInfo.code == JniErrorCode::DOCUMENTDB_JNI_ERR_SUCCESS) {
     if (result != nullptr) {
+      DOCUMENTDB_ALLOCATION_SCOPE(JNI);
+
       jboolean isCopy;
       const char* utfChars = env->GetStringUTFChars((jstring)result, &isCopy);
       value = std::string(utfChars);
@@ -2790,6 +2803,9 @@ void JniContext::Release(jobject obj) {
 JNIEnv* JniContext::Attach(JniErrorInfo& errInfo) {
   LOG_DEBUG_MSG("Attach is called");
 
+  // Every call into the JVM starts by attaching the thread.
+  DOCUMENTDB_PROBE(jni_call_start);
+
   JNIEnv* env;
 
   jint attachRes = jvm->GetJvm()->AttachCurrentThread(
@@ -2823,6 +2839,10 @@ void JniContext::ExceptionCheck(JNIEnv* env) {
 void JniContext::ExceptionCheck(JNIEnv* env, JniErrorInfo* errInfo) {
   LOG_DEBUG_MSG("ExceptionCheck(JNIEnv* env, JniErrorInfo* errInfo) is called");
 
+  // Every call into the JVM is followed by an exception check.
+  Metrics::Increment(Metrics::Counter::JNI_CALLS);
+  DOCUMENTDB_PROBE1(jni_call_done, static_cast< int >(env->ExceptionCheck()));
+
   if (env->ExceptionCheck()) {
     jthrowable err = env->ExceptionOccurred();
 
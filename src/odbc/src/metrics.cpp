@@ -0,0 +1,513 @@
+/*
+ * Copyright <2022> Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ */
+
+
+// Asio must be included before any header that pulls in windows.h.
+#include <boost/asio.hpp>
+
+#include "documentdb/odbc/metrics.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <locale>
+#include <sstream>
+#include <thread>
+
+#include "documentdb/odbc/log.h"
+
+using boost::asio::ip::tcp;
+using documentdb::odbc::common::concurrent::CsLockGuard;
+
+namespace {
+/**
+ * Exported name and help text of a metric.
+ */
+struct MetricInfo {
+  const char* name;
+  const char* help;
+};
+
+/** Counters, in the order of Metrics::Counter::Type. */
+const MetricInfo COUNTERS[] = {
+    {"documentdb_odbc_connections_opened_total", "Connections established."},
+    {"documentdb_odbc_pool_hits_total",
+     "Connections taken from the connection pool."},
+    {"documentdb_odbc_pool_misses_total",
+     "Connections not found in the connection pool."},
+    {"documentdb_odbc_statements_executed_total", "SQL statements executed."},
+    {"documentdb_odbc_translations_total",
+     "SQL statements translated to aggregate pipelines."},
+    {"documentdb_odbc_rows_fetched_total", "Rows fetched by applications."},
+    {"documentdb_odbc_bytes_fetched_total",
+     "Size of the replies received from the servers."},
+    {"documentdb_odbc_jni_calls_total", "Calls to the JDBC driver."},
+    {"documentdb_odbc_reconnect_attempts_total",
+     "Attempts to restore a lost connection."},
+    {"documentdb_odbc_reconnect_failures_total",
+     "Lost connections that could not be restored."}};
+
+/** Histograms, in the order of Metrics::Histogram::Type. */
+const MetricInfo HISTOGRAMS[] = {
+    {"documentdb_odbc_translation_seconds",
+     "Time spent translating SQL statements."},
+    {"documentdb_odbc_first_batch_seconds",
+     "Time from sending a query to receiving its first batch."}};
+
+/** Maximum size of an HTTP request to the metrics port. */
+const size_t MAX_REQUEST_SIZE = 8192;
+
+/**
+ * Add to a value only written by the calling thread.
+ *
+ * @param value Value.
+ * @param delta Value to add.
+ */
+void AddRelaxed(std::atomic< uint64_t >& value, uint64_t delta) {
+  value.store(value.load(std::memory_order_relaxed) + delta,
+              std::memory_order_relaxed);
+}
+
+/**
+ * Write the header of a metric.
+ *
+ * @param out Output.
+ * @param info Metric.
+ * @param type Prometheus type.
+ */
+void WriteHeader(std::ostream& out, const MetricInfo& info,
+                 const char* type) {
+  out << "# HELP " << info.name << ' ' << info.help << '\n';
+  out << "# TYPE " << info.name << ' ' << type << '\n';
+}
+}  // namespace
+
+namespace documentdb {
+namespace odbc {
+const int64_t Metrics::BUCKET_BOUNDS[BUCKET_COUNT] = {
+    1000,   2500,    5000,    10000,   25000,   50000,   100000,
+    250000, 500000, 1000000, 2500000, 5000000, 10000000};
+
+/**
+ * Registers the shard of a thread, and folds it into the totals when the
+ * thread exits.
+ */
+class Metrics::ThreadShard {
+ public:
+  ThreadShard() {
+    Metrics& metrics = Metrics::GetInstance();
+    CsLockGuard guard(metrics.lock);
+
+    metrics.shards.push_back(&shard);
+  }
+
+  ~ThreadShard() {
+    Metrics& metrics = Metrics::GetInstance();
+    CsLockGuard guard(metrics.lock);
+
+    metrics.retired.Add(shard);
+    for (size_t i = 0; i < metrics.shards.size(); ++i) {
+      if (metrics.shards[i] == &shard) {
+        metrics.shards[i] = metrics.shards.back();
+        metrics.shards.pop_back();
+        break;
+      }
+    }
+  }
+
+  /** Shard. */
+  Shard shard;
+};
+
+/**
+ * Writes the metrics to a file periodically and serves them on a localhost
+ * port, from one background thread.
+ */
+class Metrics::Exporter {
+ public:
+  Exporter(Metrics& metrics, const std::string& path, int32_t port,
+           int32_t intervalSeconds)
+      : metrics(metrics),
+        path(path),
+        port(port),
+        requestedPort(port),
+        interval(intervalSeconds),
+        timer(io),
+        acceptor(io) {
+    // Empty.
+  }
+
+  ~Exporter() {
+    io.stop();
+    if (thread.joinable())
+      thread.join();
+
+    // Leave the final values behind.
+    if (!path.empty())
+      metrics.WriteFile(path);
+  }
+
+  void Start() {
+    if (port > 0) {
+      try {
+        tcp::endpoint endpoint(boost::asio::ip::address_v4::loopback(),
+                               static_cast< uint16_t >(port));
+        acceptor.open(endpoint.protocol());
+        acceptor.set_option(tcp::acceptor::reuse_address(true));
+        acceptor.bind(endpoint);
+        acceptor.listen();
+        Accept();
+      } catch (const boost::system::system_error& err) {
+        LOG_ERROR_MSG("Cannot serve metrics on port " << port << ": "
+                                                      << err.what());
+        port = 0;
+      }
+    }
+
+    if (!path.empty())
+      WriteFile(boost::system::error_code());
+
+    thread = std::thread([this] { io.run(); });
+  }
+
+  bool Matches(const std::string& path, int32_t port,
+               int32_t intervalSeconds) const {
+    return this->path == path && requestedPort == port
+           && interval == intervalSeconds;
+  }
+
+  int32_t GetPort() const {
+    return port;
+  }
+
+ private:
+  DOCUMENTDB_NO_COPY_ASSIGNMENT(Exporter);
+
+  void WriteFile(const boost::system::error_code& err) {
+    if (err)
+      return;
+
+    metrics.WriteFile(path);
+
+    timer.expires_after(std::chrono::seconds(interval));
+    timer.async_wait(
+        [this](const boost::system::error_code& err) { WriteFile(err); });
+  }
+
+  void Accept() {
+    std::shared_ptr< tcp::socket > socket = std::make_shared< tcp::socket >(io);
+    acceptor.async_accept(
+        *socket, [this, socket](const boost::system::error_code& err) {
+          if (err == boost::asio::error::operation_aborted)
+            return;
+
+          if (!err)
+            Serve(socket);
+
+          Accept();
+        });
+  }
+
+  void Serve(std::shared_ptr< tcp::socket > socket) {
+    std::shared_ptr< boost::asio::streambuf > request =
+        std::make_shared< boost::asio::streambuf >(MAX_REQUEST_SIZE);
+    boost::asio::async_read_until(
+        *socket, *request, "\r\n\r\n",
+        [this, socket, request](const boost::system::error_code& err,
+                                size_t) {
+          if (err)
+            return;
+
+          std::istream in(request.get());
+          std::string method;
+          std::string target;
+          in >> method >> target;
+
+          std::shared_ptr< std::string > response =
+              std::make_shared< std::string >(MakeResponse(method, target));
+          boost::asio::async_write(
+              *socket, boost::asio::buffer(*response),
+              [socket, response](const boost::system::error_code&, size_t) {
+                boost::system::error_code ignored;
+                socket->shutdown(tcp::socket::shutdown_both, ignored);
+              });
+        });
+  }
+
+  std::string MakeResponse(const std::string& method,
+                           const std::string& target) {
+    std::string status = "200 OK";
+    std::string body;
+    if (method != "GET") {
+      status = "405 Method Not Allowed";
+    } else if (target != "/metrics" && target != "/") {
+      status = "404 Not Found";
+    } else {
+      body = metrics.ToPrometheus();
+    }
+
+    std::stringstream response;
+    response << "HTTP/1.0 " << status << "\r\n"
+             << "Content-Type: text/plain; version=0.0.4\r\n"
+             << "Content-Length: " << body.size() << "\r\n"
+             << "Connection: close\r\n\r\n"
+             << body;
+    return response.str();
+  }
+
+  /** Registry. */
+  Metrics& metrics;
+
+  /** File the metrics are written to, or empty. */
+  std::string path;
+
+  /** Port the metrics are served on, or zero. */
+  int32_t port;
+
+  /** Port requested in the configuration. */
+  int32_t requestedPort;
+
+  /** Interval of the file export, in seconds. */
+  int32_t interval;
+
+  /** I/O context run by the export thread. */
+  boost::asio::io_context io;
+
+  /** Timer of the file export. */
+  boost::asio::steady_timer timer;
+
+  /** Acceptor of the metrics port. */
+  tcp::acceptor acceptor;
+
+  /** Export thread. */
+  std::thread thread;
+};
+
+Metrics::Shard::Shard() {
+  for (size_t i = 0; i < Counter::COUNT; ++i)
+    counters[i].store(0, std::memory_order_relaxed);
+
+  for (size_t i = 0; i < Histogram::COUNT; ++i) {
+    for (size_t j = 0; j <= BUCKET_COUNT; ++j)
+      buckets[i][j].store(0, std::memory_order_relaxed);
+
+    sums[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+void Metrics::Shard::Add(const Shard& other) {
+  for (size_t i = 0; i < Counter::COUNT; ++i)
+    AddRelaxed(counters[i], other.counters[i].load(std::memory_order_relaxed));
+
+  for (size_t i = 0; i < Histogram::COUNT; ++i) {
+    for (size_t j = 0; j <= BUCKET_COUNT; ++j) {
+      AddRelaxed(buckets[i][j],
+                 other.buckets[i][j].load(std::memory_order_relaxed));
+    }
+
+    AddRelaxed(sums[i], other.sums[i].load(std::memory_order_relaxed));
+  }
+}
+
+Metrics::Metrics() : openConnections(0) {
+  // No-op.
+}
+
+Metrics::~Metrics() {
+  CsLockGuard guard(exportLock);
+
+  exporter.reset();
+}
+
+Metrics& Metrics::GetInstance() {
+  static Metrics instance;
+  return instance;
+}
+
+Metrics::Shard& Metrics::GetShard() {
+  static thread_local ThreadShard threadShard;
+  return threadShard.shard;
+}
+
+void Metrics::Increment(Counter::Type counter, uint64_t value) {
+  AddRelaxed(GetShard().counters[counter], value);
+}
+
+void Metrics::Observe(Histogram::Type histogram, int64_t micros) {
+  if (micros < 0)
+    micros = 0;
+
+  size_t bucket = 0;
+  while (bucket < BUCKET_COUNT && micros > BUCKET_BOUNDS[bucket])
+    ++bucket;
+
+  Shard& shard = GetShard();
+  AddRelaxed(shard.buckets[histogram][bucket], 1);
+  AddRelaxed(shard.sums[histogram], static_cast< uint64_t >(micros));
+}
+
+void Metrics::AddOpenConnections(int64_t delta) {
+  openConnections.fetch_add(delta, std::memory_order_relaxed);
+}
+
+void Metrics::AddError(const std::string& sqlState) {
+  CsLockGuard guard(lock);
+
+  ++errors[sqlState];
+}
+
+uint64_t Metrics::GetCounter(Counter::Type counter) {
+  Shard total;
+  Collect(total);
+
+  return total.counters[counter].load(std::memory_order_relaxed);
+}
+
+int64_t Metrics::GetOpenConnections() const {
+  return openConnections.load(std::memory_order_relaxed);
+}
+
+uint64_t Metrics::GetErrors(const std::string& sqlState) {
+  CsLockGuard guard(lock);
+
+  std::map< std::string, uint64_t >::const_iterator it = errors.find(sqlState);
+  return it == errors.end() ? 0 : it->second;
+}
+
+void Metrics::Collect(Shard& total) {
+  CsLockGuard guard(lock);
+
+  total.Add(retired);
+  for (Shard* shard : shards)
+    total.Add(*shard);
+}
+
+std::string Metrics::ToPrometheus() {
+  Shard total;
+  Collect(total);
+
+  std::map< std::string, uint64_t > errorsCopy;
+  {
+    CsLockGuard guard(lock);
+    errorsCopy = errors;
+  }
+
+  std::stringstream out;
+  out.imbue(std::locale::classic());
+
+  for (size_t i = 0; i < Counter::COUNT; ++i) {
+    WriteHeader(out, COUNTERS[i], "counter");
+    out << COUNTERS[i].name << ' '
+        << total.counters[i].load(std::memory_order_relaxed) << '\n';
+  }
+
+  MetricInfo openInfo = {"documentdb_odbc_open_connections",
+                         "Connections currently open."};
+  WriteHeader(out, openInfo, "gauge");
+  out << openInfo.name << ' ' << GetOpenConnections() << '\n';
+
+  MetricInfo errorInfo = {"documentdb_odbc_errors_total",
+                          "Errors reported to applications, by SQLSTATE."};
+  WriteHeader(out, errorInfo, "counter");
+  for (auto const& error : errorsCopy) {
+    out << errorInfo.name << "{sqlstate=\"" << error.first << "\"} "
+        << error.second << '\n';
+  }
+
+  for (size_t i = 0; i < Histogram::COUNT; ++i) {
+    const char* name = HISTOGRAMS[i].name;
+    WriteHeader(out, HISTOGRAMS[i], "histogram");
+
+    uint64_t count = 0;
+    for (size_t j = 0; j <= BUCKET_COUNT; ++j) {
+      count += total.buckets[i][j].load(std::memory_order_relaxed);
+      out << name << "_bucket{le=\"";
+      if (j < BUCKET_COUNT)
+        out << BUCKET_BOUNDS[j] / 1e6;
+      else
+        out << "+Inf";
+      out << "\"} " << count << '\n';
+    }
+    out << name << "_sum " << std::fixed << std::setprecision(6)
+        << total.sums[i].load(std::memory_order_relaxed) / 1e6
+        << std::defaultfloat << '\n';
+    out << name << "_count " << count << '\n';
+  }
+
+  return out.str();
+}
+
+bool Metrics::WriteFile(const std::string& path) {
+  std::string text = ToPrometheus();
+
+  // Write a temporary file first, so that readers never see a partial file.
+  std::string tmpPath = path + ".tmp";
+  {
+    std::ofstream file(tmpPath.c_str(), std::ios::out | std::ios::trunc);
+    file << text;
+    file.close();
+    if (file.fail()) {
+      LOG_ERROR_MSG("Cannot write metrics file " << tmpPath);
+      return false;
+    }
+  }
+
+#ifdef _WIN32
+  // rename does not replace existing files on Windows.
+  std::remove(path.c_str());
+#endif  // _WIN32
+  if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+    LOG_ERROR_MSG("Cannot replace metrics file " << path);
+    return false;
+  }
+
+  return true;
+}
+
+void Metrics::ConfigureExport(const std::string& path, int32_t port,
+                              int32_t intervalSeconds) {
+  if (intervalSeconds <= 0)
+    intervalSeconds = DEFAULT_EXPORT_INTERVAL;
+
+  CsLockGuard guard(exportLock);
+
+  if (exporter && exporter->Matches(path, port, intervalSeconds))
+    return;
+
+  exporter.reset();
+  if (path.empty() && port <= 0)
+    return;
+
+  LOG_INFO_MSG("Exporting metrics to '" << path << "', port " << port
+                                        << ", every " << intervalSeconds
+                                        << " s");
+  exporter.reset(new Exporter(*this, path, port, intervalSeconds));
+  exporter->Start();
+}
+
+void Metrics::StopExport() {
+  CsLockGuard guard(exportLock);
+
+  exporter.reset();
+}
+
+int32_t Metrics::GetExportPort() {
+  CsLockGuard guard(exportLock);
+
+  return exporter ? exporter->GetPort() : 0;
+}
+}  // namespace odbc
+}  // namespace documentdb
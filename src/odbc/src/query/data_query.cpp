@@ -17,21 +17,41 @@
 
 #include "documentdb/odbc/query/data_query.h"
 
+#include <algorithm>
+#include <iterator>
+#include <bsoncxx/builder/basic/array.hpp>
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
+#include <bsoncxx/exception/exception.hpp>
 #include <bsoncxx/json.hpp>
+#include <bsoncxx/types/bson_value/value.hpp>
+#include <bsoncxx/types/bson_value/view.hpp>
+#include <chrono>
 #include <mongocxx/collection.hpp>
 #include <mongocxx/database.hpp>
 #include <mongocxx/exception/exception.hpp>
 #include <mongocxx/options/aggregate.hpp>
+#include <mongocxx/options/count.hpp>
+#include <mongocxx/options/estimated_document_count.hpp>
 #include <mongocxx/pipeline.hpp>
+#include <mongocxx/read_concern.hpp>
+#include <mongocxx/read_preference.hpp>
+#include <set>
 
 #include "documentdb/odbc/connection.h"
 #include "documentdb/odbc/documentdb_cursor.h"
+#include "documentdb/odbc/impl/binary/binary_common.h"
 #include "documentdb/odbc/jni/documentdb_mql_query_context.h"
 #include "documentdb/odbc/jni/documentdb_query_mapping_service.h"
 #include "documentdb/odbc/log.h"
 #include "documentdb/odbc/message.h"
+#include "documentdb/odbc/metrics.h"
 #include "documentdb/odbc/odbc_error.h"
+#include "documentdb/odbc/probes.h"
 #include "documentdb/odbc/query/batch_query.h"
+#include "documentdb/odbc/server_capabilities.h"
+#include "documentdb/odbc/slow_query_log.h"
+#include "documentdb/odbc/statement_trace.h"
 
 using documentdb::odbc::jni::DocumentDbConnectionProperties;
 using documentdb::odbc::jni::DocumentDbDatabaseMetadata;
@@ -39,17 +59,271 @@ using documentdb::odbc::jni::DocumentDbMqlQueryContext;
 using documentdb::odbc::jni::DocumentDbQueryMappingService;
 using documentdb::odbc::jni::JdbcColumnMetadata;
 
+namespace {
+/**
+ * Check if the value is the constant one, as in {$sum: 1}.
+ *
+ * @param element Element to check.
+ * @return @c true if the value is one.
+ */
+bool IsOne(const bsoncxx::document::element& element) {
+  switch (element.type()) {
+    case bsoncxx::type::k_int32:
+      return element.get_int32().value == 1;
+    case bsoncxx::type::k_int64:
+      return element.get_int64().value == 1;
+    case bsoncxx::type::k_double:
+      return element.get_double().value == 1.0;
+    default:
+      return false;
+  }
+}
+
+/**
+ * Check if the value is the accumulator {$sum: 1}.
+ *
+ * @param element Element to check.
+ * @return @c true if the value counts the input documents.
+ */
+bool IsCountAccumulator(const bsoncxx::document::element& element) {
+  if (element.type() != bsoncxx::type::k_document) {
+    return false;
+  }
+  bsoncxx::document::view accumulator = element.get_document().value;
+  auto it = accumulator.begin();
+  return it != accumulator.end() && std::next(it) == accumulator.end()
+         && (*it).key().to_string() == "$sum" && IsOne(*it);
+}
+
+/**
+ * Check if the pipeline is analytic, i.e. it groups, joins, or sorts without
+ * a limit. Such pipelines scan many documents and are better served by a
+ * secondary.
+ *
+ * @param stages Aggregate pipeline stages.
+ * @return @c true if the pipeline is analytic.
+ */
+bool IsAnalyticPipeline(const std::vector< std::string >& stages) {
+  bool sorted = false;
+  bool limited = false;
+  for (auto const& stage : stages) {
+    bsoncxx::document::value doc = bsoncxx::from_json(stage);
+    for (auto const& op : doc.view()) {
+      std::string name = op.key().to_string();
+      if (name == "$group" || name == "$lookup") {
+        return true;
+      }
+      sorted = sorted || name == "$sort";
+      limited = limited || name == "$limit";
+    }
+  }
+  return sorted && !limited;
+}
+
+/**
+ * Check if the pipeline only counts the documents matching an optional
+ * filter, i.e. it has the shape [$match], $group {_id: null, n: {$sum: 1}},
+ * [$project]...
+ *
+ * @param stages Aggregate pipeline stages.
+ * @param path Expected path of the count in the result document.
+ * @param filter Resulting filter. Empty if the pipeline has no $match.
+ * @return @c true if the pipeline is a plain count.
+ */
+bool IsCountPipeline(const std::vector< std::string >& stages,
+                     const std::string& path,
+                     bsoncxx::document::value& filter) {
+  std::string countPath;
+  bool grouped = false;
+  for (auto const& stage : stages) {
+    bsoncxx::document::value doc = bsoncxx::from_json(stage);
+    bsoncxx::document::view view = doc.view();
+    auto it = view.begin();
+    if (it == view.end() || std::next(it) != view.end()
+        || (*it).type() != bsoncxx::type::k_document) {
+      return false;
+    }
+
+    bsoncxx::document::element op = *it;
+    std::string name = op.key().to_string();
+    bsoncxx::document::view body = op.get_document().value;
+
+    if (name == "$match" && !grouped && filter.view().empty()) {
+      filter = bsoncxx::document::value(body);
+    } else if (name == "$group" && !grouped) {
+      for (auto const& field : body) {
+        std::string key = field.key().to_string();
+        if (key == "_id") {
+          // Only a single group over the whole input.
+          if (field.type() != bsoncxx::type::k_null
+              && !(field.type() == bsoncxx::type::k_document
+                   && field.get_document().value.empty())) {
+            return false;
+          }
+        } else if (countPath.empty() && IsCountAccumulator(field)) {
+          countPath = key;
+        } else {
+          return false;
+        }
+      }
+      grouped = true;
+    } else if (name == "$project" && grouped && !countPath.empty()) {
+      // Follow the count through projections that only rename it.
+      std::string projected;
+      for (auto const& field : body) {
+        std::string key = field.key().to_string();
+        if (key == "_id") {
+          continue;
+        }
+        if (!projected.empty()) {
+          return false;
+        }
+        if (field.type() == bsoncxx::type::k_utf8
+            && field.get_utf8().value.to_string() == "$" + countPath) {
+          projected = key;
+        } else if (key == countPath && IsOne(field)) {
+          projected = key;
+        } else if (key == countPath && field.type() == bsoncxx::type::k_bool
+                   && field.get_bool().value) {
+          projected = key;
+        } else {
+          return false;
+        }
+      }
+      if (projected.empty()) {
+        return false;
+      }
+      countPath = projected;
+    } else {
+      return false;
+    }
+  }
+
+  return grouped && countPath == path;
+}
+
+/**
+ * Find the first element with the given key, searching sub-documents and
+ * arrays depth-first.
+ *
+ * @param view Document to search.
+ * @param key Key to find.
+ * @param result Resulting element.
+ * @return @c true if found.
+ */
+bool FindElement(const bsoncxx::document::view& view, const std::string& key,
+                 bsoncxx::document::element& result);
+
+/**
+ * Find the first element with the given key in a value.
+ *
+ * @param value Value to search.
+ * @param key Key to find.
+ * @param result Resulting element.
+ * @return @c true if found.
+ */
+bool FindElementInValue(const bsoncxx::types::bson_value::view& value,
+                        const std::string& key,
+                        bsoncxx::document::element& result) {
+  if (value.type() == bsoncxx::type::k_document) {
+    return FindElement(value.get_document().value, key, result);
+  }
+  if (value.type() == bsoncxx::type::k_array) {
+    for (auto const& item : value.get_array().value) {
+      if (FindElementInValue(item.get_value(), key, result)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool FindElement(const bsoncxx::document::view& view, const std::string& key,
+                 bsoncxx::document::element& result) {
+  for (auto const& element : view) {
+    if (element.key().to_string() == key) {
+      result = element;
+      return true;
+    }
+  }
+  for (auto const& element : view) {
+    if (FindElementInValue(element.get_value(), key, result)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Collect the names of the scan stages (COLLSCAN, IXSCAN, ...) of a plan.
+ *
+ * @param value Plan, or part of a plan.
+ * @param scans Resulting stage names.
+ */
+void CollectScanStages(const bsoncxx::types::bson_value::view& value,
+                       std::set< std::string >& scans) {
+  if (value.type() == bsoncxx::type::k_document) {
+    for (auto const& element : value.get_document().value) {
+      if (element.key().to_string() == "stage"
+          && element.type() == bsoncxx::type::k_utf8) {
+        std::string stage = element.get_utf8().value.to_string();
+        if (stage.size() > 4
+            && stage.compare(stage.size() - 4, 4, "SCAN") == 0) {
+          scans.insert(stage);
+        }
+      } else {
+        CollectScanStages(element.get_value(), scans);
+      }
+    }
+  } else if (value.type() == bsoncxx::type::k_array) {
+    for (auto const& item : value.get_array().value) {
+      CollectScanStages(item.get_value(), scans);
+    }
+  }
+}
+
+/**
+ * Convert an element value to a string. Documents and arrays are converted
+ * to JSON.
+ *
+ * @param element Element.
+ * @return String value.
+ */
+std::string ElementToString(const bsoncxx::document::element& element) {
+  switch (element.type()) {
+    case bsoncxx::type::k_int32:
+      return std::to_string(element.get_int32().value);
+    case bsoncxx::type::k_int64:
+      return std::to_string(element.get_int64().value);
+    case bsoncxx::type::k_double:
+      return std::to_string(element.get_double().value);
+    case bsoncxx::type::k_utf8:
+      return element.get_utf8().value.to_string();
+    case bsoncxx::type::k_bool:
+      return element.get_bool().value ? "true" : "false";
+    case bsoncxx::type::k_document:
+      return bsoncxx::to_json(element.get_document().value);
+    case bsoncxx::type::k_array:
+      return bsoncxx::to_json(element.get_array().value);
+    default:
+      return std::string();
+  }
+}
+}  // namespace
+
 namespace documentdb {
 namespace odbc {
 namespace query {
 DataQuery::DataQuery(diagnostic::DiagnosableAdapter& diag,
                      Connection& connection, const std::string& sql,
-                     const app::ParameterSet& params, int32_t& timeout)
+                     const app::ParameterSet& params, int32_t& timeout,
+                     const DataQueryOptions& options)
     : Query(diag, QueryType::DATA),
       connection_(connection),
       sql_(sql),
       params_(params),
-      timeout_(timeout) {
+      timeout_(timeout),
+      options_(options) {
   // No-op.
 
   LOG_DEBUG_MSG("DataQuery constructor is called, and exiting");
@@ -69,9 +343,14 @@ SqlResult::Type DataQuery::Execute() {
   if (cursor_.get())
     InternalClose();
 
+  DOCUMENTDB_PROBE2(execute_start, options_.statementId, sql_.c_str());
+  SqlResult::Type result = MakeRequestExecute();
+  DOCUMENTDB_PROBE2(execute_done, options_.statementId,
+                    static_cast< int >(result));
+
   LOG_DEBUG_MSG("Execute exiting");
 
-  return MakeRequestExecute();
+  return result;
 }
 
 const meta::ColumnMetaVector* DataQuery::GetMeta() {
@@ -96,6 +375,10 @@ const meta::ColumnMetaVector* DataQuery::GetMeta() {
 SqlResult::Type DataQuery::FetchNextRow(app::ColumnBindingMap& columnBindings) {
   LOG_DEBUG_MSG("FetchNextRow is called");
 
+  // Replies to getMore are counted by the command monitoring callbacks, and
+  // allocations by the allocation tracker.
+  StatementTrace::Scope traceScope(trace_);
+
   if (!cursor_.get()) {
     diag.AddStatusRecord(SqlState::SHY010_SEQUENCE_ERROR,
                          "Query was not executed.");
@@ -107,6 +390,8 @@ SqlResult::Type DataQuery::FetchNextRow(app::ColumnBindingMap& columnBindings) {
   }
 
   if (!cursor_->HasData()) {
+    trace_.Finish();
+
     LOG_INFO_MSG("FetchNextRow exiting with AI_NO_DATA");
     LOG_DEBUG_MSG("reason: cursor does not have data");
 
@@ -114,6 +399,18 @@ SqlResult::Type DataQuery::FetchNextRow(app::ColumnBindingMap& columnBindings) {
   }
 
   if (!cursor_->Increment()) {
+    trace_.Finish();
+
+    DocumentDbError error;
+    if (cursor_->GetError(error)) {
+      diag.AddStatusRecord(Logger::RedactMessage(error.GetText()));
+
+      LOG_ERROR_MSG("FetchNextRow exiting with AI_ERROR");
+      LOG_DEBUG_MSG("reason: cursor failed while fetching data");
+
+      return SqlResult::AI_ERROR;
+    }
+
     LOG_INFO_MSG("FetchNextRow exiting with AI_NO_DATA");
     LOG_DEBUG_MSG(
         "reason: cursor cannot be moved to the next row; either data update is "
@@ -133,6 +430,9 @@ SqlResult::Type DataQuery::FetchNextRow(app::ColumnBindingMap& columnBindings) {
     return SqlResult::AI_ERROR;
   }
 
+  DOCUMENTDB_ALLOCATION_SCOPE(CONVERSION);
+  StatementTrace::Clock::time_point convertStart =
+      StatementTrace::Clock::now();
   for (uint32_t i = 1; i < row->GetSize() + 1; ++i) {
     app::ColumnBindingMap::iterator it = columnBindings.find(i);
 
@@ -141,10 +441,13 @@ SqlResult::Type DataQuery::FetchNextRow(app::ColumnBindingMap& columnBindings) {
 
     app::ConversionResult::Type convRes =
         row->ReadColumnToBuffer(i, it->second);
+    ++trace_.conversions;
 
     SqlResult::Type result = ProcessConversionResult(convRes, 0, i);
 
     if (result == SqlResult::AI_ERROR) {
+      trace_.convertMicros += StatementTrace::MicrosSince(convertStart);
+
       LOG_ERROR_MSG("FetchNextRow exiting with AI_ERROR");
       LOG_DEBUG_MSG(
           "error occured during column conversion operation, inside the for "
@@ -154,6 +457,11 @@ SqlResult::Type DataQuery::FetchNextRow(app::ColumnBindingMap& columnBindings) {
     }
   }
 
+  trace_.convertMicros += StatementTrace::MicrosSince(convertStart);
+  ++trace_.rows;
+  Metrics::Increment(Metrics::Counter::ROWS_FETCHED);
+  DOCUMENTDB_PROBE2(row_fetch, options_.statementId, trace_.rows);
+
   LOG_DEBUG_MSG("FetchNextRow exiting with AI_SUCCESS");
 
   return SqlResult::AI_SUCCESS;
@@ -163,6 +471,8 @@ SqlResult::Type DataQuery::GetColumn(uint16_t columnIdx,
                                      app::ApplicationDataBuffer& buffer) {
   LOG_DEBUG_MSG("GetColumn is called");
 
+  StatementTrace::Scope traceScope(trace_);
+
   if (!cursor_.get()) {
     diag.AddStatusRecord(SqlState::SHY010_SEQUENCE_ERROR,
                          "Query was not executed.");
@@ -185,8 +495,13 @@ SqlResult::Type DataQuery::GetColumn(uint16_t columnIdx,
     return SqlResult::AI_ERROR;
   }
 
+  DOCUMENTDB_ALLOCATION_SCOPE(CONVERSION);
+  StatementTrace::Clock::time_point convertStart =
+      StatementTrace::Clock::now();
   app::ConversionResult::Type convRes =
       row->ReadColumnToBuffer(columnIdx, buffer);
+  trace_.convertMicros += StatementTrace::MicrosSince(convertStart);
+  ++trace_.conversions;
 
   SqlResult::Type result = ProcessConversionResult(convRes, 0, columnIdx);
 
@@ -205,6 +520,8 @@ SqlResult::Type DataQuery::InternalClose() {
   LOG_DEBUG_MSG("InternalClose is called");
 
   if (!cursor_.get()) {
+    mongoClient_.reset();
+
     LOG_DEBUG_MSG("InternalClose exiting");
 
     return SqlResult::AI_SUCCESS;
@@ -213,6 +530,11 @@ SqlResult::Type DataQuery::InternalClose() {
   SqlResult::Type result = MakeRequestClose();
   if (result == SqlResult::AI_SUCCESS) {
     cursor_.reset();
+    mongoClient_.reset();
+
+    trace_.Finish();
+    LOG_INFO_MSG("Statement trace: " << trace_.ToJson());
+    WriteSlowQuery();
   }
 
   LOG_DEBUG_MSG("InternalClose exiting");
@@ -220,6 +542,30 @@ SqlResult::Type DataQuery::InternalClose() {
   return result;
 }
 
+void DataQuery::WriteSlowQuery() {
+  // The elapsed time includes the time the application spends between
+  // fetches, or with the cursor left open, so it is not compared.
+  int32_t thresholdMs =
+      connection_.GetConfiguration().GetSlowQueryThresholdMs();
+  int64_t driverMicros = trace_.GetDriverMicros();
+  if (thresholdMs <= 0
+      || driverMicros <= static_cast< int64_t >(thresholdMs) * 1000) {
+    stages_.clear();
+    return;
+  }
+
+  SlowQueryLog::Entry entry;
+  entry.sql = sql_;
+  entry.collection = collectionName_;
+  entry.stages.swap(stages_);
+  entry.comment = MakeComment();
+  entry.thresholdMs = thresholdMs;
+  entry.elapsedMicros = trace_.GetElapsedMicros();
+  entry.driverMicros = driverMicros;
+  entry.trace = trace_.ToJson();
+  SlowQueryLog::GetInstance().Write(entry);
+}
+
 bool DataQuery::DataAvailable() const {
   LOG_DEBUG_MSG("DataAvailable is called, and exiting");
 
@@ -246,10 +592,11 @@ SqlResult::Type DataQuery::MakeRequestExecute() {
   LOG_DEBUG_MSG("MakeRequestExecute is called");
 
   cursor_.reset();
+  trace_.Start();
 
   LOG_DEBUG_MSG("MakeRequestExecute exiting");
 
-  return MakeRequestFetch();
+  return MakeRequestFetch(true);
 }
 
 SqlResult::Type DataQuery::MakeRequestClose() {
@@ -258,14 +605,27 @@ SqlResult::Type DataQuery::MakeRequestClose() {
   return SqlResult::AI_SUCCESS;
 }
 
-SqlResult::Type DataQuery::MakeRequestFetch() {
+SqlResult::Type DataQuery::MakeRequestFetch(bool reconnect) {
   LOG_DEBUG_MSG("MakeRequestFetch is called");
 
+  // Replies to the commands below are counted by the command monitoring
+  // callbacks.
+  StatementTrace::Scope traceScope(trace_);
+
   try {
     SharedPointer< DocumentDbMqlQueryContext > mqlQueryContext;
     DocumentDbError error;
 
+    StatementTrace::Clock::time_point phaseStart =
+        StatementTrace::Clock::now();
+    DOCUMENTDB_PROBE1(translate_start, options_.statementId);
     SqlResult::Type result = GetMqlQueryContext(mqlQueryContext, error);
+    DOCUMENTDB_PROBE2(translate_done, options_.statementId,
+                      static_cast< int >(result == SqlResult::AI_SUCCESS));
+    int64_t translateMicros = StatementTrace::MicrosSince(phaseStart);
+    trace_.translateMicros += translateMicros;
+    Metrics::Increment(Metrics::Counter::TRANSLATIONS);
+    Metrics::Observe(Metrics::Histogram::TRANSLATION, translateMicros);
     if (result != SqlResult::AI_SUCCESS) {
       switch (error.GetCode()) {
         case DocumentDbError::DOCUMENTDB_ERR_SQL_EXCEPTION:
@@ -281,12 +641,12 @@ SqlResult::Type DataQuery::MakeRequestFetch() {
       diag.AddStatusRecord(Logger::RedactMessage(error.GetText()));
 
       LOG_ERROR_MSG("MakeRequestFetch exiting with error msg: "
-                            << Logger::RedactMessage(error.GetText()));
+                            << Logger::MarkSensitive(error.GetText()));
 
       return result;
     }
 
-    std::vector< std::string > const& aggregateOperations =
+    std::vector< std::string > aggregateOperations =
         mqlQueryContext.Get()->GetAggregateOperations();
     std::vector< JdbcColumnMetadata >& columnMetadata =
         mqlQueryContext.Get()->GetColumnMetadata();
@@ -300,27 +660,104 @@ SqlResult::Type DataQuery::MakeRequestFetch() {
     std::string databaseName = config.GetDatabase();
     std::string collectionName = mqlQueryContext.Get()->GetCollectionName();
 
-    std::shared_ptr< mongocxx::client > const& mongoClient =
-        connection_.GetMongoClient();
-    mongocxx::database database = mongoClient.get()->database(databaseName);
+    if (!mongoClient_) {
+      mongoClient_ = connection_.AcquireMongoClient(timeout_);
+    }
+    mongocxx::database database = mongoClient_->database(databaseName);
     mongocxx::collection collection = database[collectionName];
+
+    UpdateRouting(aggregateOperations);
+    collectionName_ = collectionName;
+    // The stages are only kept for the slow query log.
+    bool keepStages = config.GetSlowQueryThresholdMs() > 0;
+    phaseStart = StatementTrace::Clock::now();
+    if (MakeRequestCount(collection, aggregateOperations, columnMetadata,
+                         paths)) {
+      RecordFirstBatch(phaseStart);
+      if (keepStages) {
+        stages_ = aggregateOperations;
+      }
+
+      LOG_DEBUG_MSG("MakeRequestFetch exiting with count result");
+
+      return SqlResult::AI_SUCCESS;
+    }
+
+    AppendResultLimits(aggregateOperations, columnMetadata, paths);
+    UpdateRouting(aggregateOperations);
+    if (keepStages) {
+      stages_ = aggregateOperations;
+    }
+
+    phaseStart = StatementTrace::Clock::now();
     auto pipeline = mongocxx::pipeline{};
     for (auto const& stage : aggregateOperations) {
       pipeline.append_stage(bsoncxx::from_json(stage));
     }
+    trace_.parseMicros += StatementTrace::MicrosSince(phaseStart);
     auto options = mongocxx::options::aggregate{};
-    options.batch_size(config.GetDefaultFetchSize());
-    if (timeout_) {
-      options.max_time(std::chrono::milliseconds(std::chrono::seconds(timeout_)));
+    MakeAggregateOptions(options);
+
+    int32_t partitions = options_.parallelScanPartitions
+                             ? *options_.parallelScanPartitions
+                             : config.GetParallelScanPartitions();
+    phaseStart = StatementTrace::Clock::now();
+    ServerCapabilities caps;
+    if (partitions > 1
+        && DocumentDbPartitionedScan::IsPartitionable(aggregateOperations)
+        && connection_.GetServerCapabilities(caps)
+        && caps.IsSampleSupported()) {
+      std::unique_ptr< DocumentDbPartitionedScan > scan(
+          new DocumentDbPartitionedScan(connection_, databaseName,
+                                        collectionName, aggregateOperations,
+                                        options, *options.batch_size()));
+      if (scan->Start(collection, partitions)) {
+        this->cursor_.reset(
+            new DocumentDbCursor(std::move(scan), columnMetadata, paths));
+        RecordFirstBatch(phaseStart);
+
+        LOG_DEBUG_MSG("MakeRequestFetch exiting with partitioned scan");
+
+        return SqlResult::AI_SUCCESS;
+      }
     }
+
+    DOCUMENTDB_PROBE2(aggregate, options_.statementId,
+                      static_cast< int >(aggregateOperations.size()));
     mongocxx::cursor cursor = collection.aggregate(pipeline, options);
 
+    // The first batch is requested when the cursor is constructed.
     this->cursor_.reset(new DocumentDbCursor(cursor, columnMetadata, paths));
+    RecordFirstBatch(phaseStart);
 
     LOG_DEBUG_MSG("MakeRequestFetch exiting");
 
     return SqlResult::AI_SUCCESS;
   } catch (mongocxx::exception const& xcp) {
+    if (Connection::IsClientPoolTimeout(xcp)) {
+      diag.AddStatusRecord(SqlState::SHYT00_TIMEOUT_EXPIRED, xcp.what());
+
+      LOG_ERROR_MSG("MakeRequestFetch exiting with error msg: " << xcp.what());
+
+      return SqlResult::AI_ERROR;
+    }
+
+    if (reconnect && Connection::IsTransportError(xcp)) {
+      LOG_INFO_MSG("Connection lost, reconnecting: " << xcp.what());
+
+      // The client belongs to the broken client pool.
+      cursor_.reset();
+      mongoClient_.reset();
+
+      DocumentDbError reconnectError;
+      if (connection_.Reconnect(reconnectError)) {
+        return MakeRequestFetch(false);
+      }
+
+      LOG_ERROR_MSG("Unable to reconnect: "
+                    << Logger::MarkSensitive(reconnectError.GetText()));
+    }
+
     std::stringstream message;
     message << "Unable to establish connection with DocumentDB."
             << " code: " << xcp.code().value()
@@ -332,7 +769,7 @@ SqlResult::Type DataQuery::MakeRequestFetch() {
     diag.AddStatusRecord(Logger::RedactMessage(error.GetText()));
 
     LOG_ERROR_MSG(
-        "MakeRequestFetch exiting with error msg: " << Logger::RedactMessage(error.GetText()));
+        "MakeRequestFetch exiting with error msg: " << Logger::MarkSensitive(error.GetText()));
 
     return SqlResult::AI_ERROR;
   }
@@ -340,6 +777,12 @@ SqlResult::Type DataQuery::MakeRequestFetch() {
   LOG_DEBUG_MSG("MakeRequestFetch exiting");
 }
 
+void DataQuery::RecordFirstBatch(StatementTrace::Clock::time_point start) {
+  int64_t micros = StatementTrace::MicrosSince(start);
+  trace_.firstBatchMicros += micros;
+  Metrics::Observe(Metrics::Histogram::FIRST_BATCH, micros);
+}
+
 SqlResult::Type DataQuery::GetMqlQueryContext(
     SharedPointer< DocumentDbMqlQueryContext >& mqlQueryContext,
     DocumentDbError& error) {
@@ -349,7 +792,7 @@ SqlResult::Type DataQuery::GetMqlQueryContext(
       connection_.GetConnectionProperties(error);
   if (error.GetCode() != DocumentDbError::DOCUMENTDB_SUCCESS) {
     LOG_ERROR_MSG("GetMqlQueryContext exiting with error msg: "
-                          << Logger::RedactMessage(error.GetText()));
+                          << Logger::MarkSensitive(error.GetText()));
 
     return SqlResult::AI_ERROR;
   }
@@ -357,7 +800,7 @@ SqlResult::Type DataQuery::GetMqlQueryContext(
       connection_.GetDatabaseMetadata(error);
   if (error.GetCode() != DocumentDbError::DOCUMENTDB_SUCCESS) {
     LOG_ERROR_MSG("GetMqlQueryContext exiting with error msg: "
-                          << Logger::RedactMessage(error.GetText()));
+                          << Logger::MarkSensitive(error.GetText()));
 
     return SqlResult::AI_ERROR;
   }
@@ -369,10 +812,12 @@ SqlResult::Type DataQuery::GetMqlQueryContext(
     DocumentDbError::SetError(errInfo.code, errInfo.errCls.c_str(),
                           errInfo.errMsg.c_str(), error);
     LOG_ERROR_MSG("GetMqlQueryContext exiting with error msg: "
-                          << Logger::RedactMessage(error.GetText()));
+                          << Logger::MarkSensitive(error.GetText()));
 
     return SqlResult::AI_ERROR;
   }
+  // MAX_ROWS is applied by AppendResultLimits, a $limit from the translator
+  // would be a second one and hide plain COUNT(*) pipelines.
   mqlQueryContext =
       queryMappingService.Get()->GetMqlQueryContext(sql_, 0, errInfo);
   if (errInfo.code != JniErrorCode::DOCUMENTDB_JNI_ERR_SUCCESS) {
@@ -380,7 +825,7 @@ SqlResult::Type DataQuery::GetMqlQueryContext(
                           errInfo.errMsg.c_str(), error);
 
     LOG_ERROR_MSG("GetMqlQueryContext exiting with error msg: "
-                          << Logger::RedactMessage(error.GetText()));
+                          << Logger::MarkSensitive(error.GetText()));
 
     return SqlResult::AI_ERROR;
   }
@@ -389,6 +834,403 @@ SqlResult::Type DataQuery::GetMqlQueryContext(
   return SqlResult::AI_SUCCESS;
 }
 
+void DataQuery::MakeAggregateOptions(
+    mongocxx::options::aggregate& options) const {
+  const config::Configuration& config = connection_.GetConfiguration();
+
+  options.batch_size(options_.batchSize > 0
+                         ? static_cast< int32_t >(options_.batchSize)
+                         : config.GetDefaultFetchSize());
+  if (timeout_) {
+    options.max_time(std::chrono::milliseconds(std::chrono::seconds(timeout_)));
+  }
+
+  bool allowDiskUse = options_.allowDiskUse ? *options_.allowDiskUse
+                                            : config.IsAllowDiskUse();
+  if (allowDiskUse) {
+    options.allow_disk_use(true);
+  }
+
+  if (!options_.hint.empty()) {
+    options.hint(MakeHint());
+  }
+
+  if (!options_.collation.empty()) {
+    options.collation(bsoncxx::from_json(options_.collation));
+  }
+
+  if (options_.readConcern || config.IsReadConcernSet()) {
+    mongocxx::read_concern readConcern;
+    readConcern.acknowledge_string(ReadConcern::ToString(
+        options_.readConcern ? *options_.readConcern
+                             : config.GetReadConcern()));
+    options.read_concern(readConcern);
+  }
+
+  if (options_.readPreference || options_.maxStalenessSeconds || analytic_) {
+    options.read_preference(MakeReadPreference());
+  }
+
+  options.comment(bsoncxx::types::bson_value::value(MakeComment()));
+}
+
+mongocxx::hint DataQuery::MakeHint() const {
+  // A hint starting with a brace is a key pattern, otherwise an index name.
+  if (options_.hint[0] == '{') {
+    return mongocxx::hint(bsoncxx::from_json(options_.hint));
+  }
+  return mongocxx::hint(options_.hint);
+}
+
+ReadPreference::Type DataQuery::GetReadPreference() const {
+  if (options_.readPreference) {
+    return *options_.readPreference;
+  }
+  if (analytic_) {
+    return ReadPreference::Type::SECONDARY_PREFERRED;
+  }
+  return connection_.GetConfiguration().GetReadPreference();
+}
+
+mongocxx::read_preference DataQuery::MakeReadPreference() const {
+  typedef mongocxx::read_preference::read_mode ReadMode;
+  mongocxx::read_preference readPreference;
+  switch (GetReadPreference()) {
+    case ReadPreference::Type::PRIMARY_PREFERRED:
+      readPreference.mode(ReadMode::k_primary_preferred);
+      break;
+    case ReadPreference::Type::SECONDARY:
+      readPreference.mode(ReadMode::k_secondary);
+      break;
+    case ReadPreference::Type::SECONDARY_PREFERRED:
+      readPreference.mode(ReadMode::k_secondary_preferred);
+      break;
+    case ReadPreference::Type::NEAREST:
+      readPreference.mode(ReadMode::k_nearest);
+      break;
+    default:
+      readPreference.mode(ReadMode::k_primary);
+      break;
+  }
+
+  // Staleness only applies to reads from secondaries.
+  if (options_.maxStalenessSeconds
+      && readPreference.mode() != ReadMode::k_primary) {
+    readPreference.max_staleness(
+        std::chrono::seconds(*options_.maxStalenessSeconds));
+  }
+  return readPreference;
+}
+
+void DataQuery::UpdateRouting(const std::vector< std::string >& stages) {
+  analytic_ = false;
+  if (!connection_.GetConfiguration().IsAnalyticsRouting()) {
+    return;
+  }
+
+  try {
+    analytic_ = IsAnalyticPipeline(stages);
+  } catch (const bsoncxx::exception& xcp) {
+    LOG_DEBUG_MSG("Unable to parse pipeline stage: " << xcp.what());
+  }
+
+  if (analytic_) {
+    LOG_DEBUG_MSG("Routing analytic query to secondaries");
+  }
+}
+
+std::string DataQuery::MakeComment() const {
+  const config::Configuration& config = connection_.GetConfiguration();
+
+  std::stringstream comment;
+  comment << "app=" << config.GetApplicationName()
+          << ";stmt=" << options_.statementId;
+
+  const std::string& userComment =
+      options_.comment ? *options_.comment : config.GetComment();
+  if (!userComment.empty()) {
+    comment << ";" << userComment;
+  }
+
+  return comment.str();
+}
+
+bool DataQuery::MakeRequestCount(
+    mongocxx::collection& collection, const std::vector< std::string >& stages,
+    std::vector< JdbcColumnMetadata >& columnMetadata,
+    std::vector< std::string >& paths) {
+  using bsoncxx::builder::basic::kvp;
+  using bsoncxx::builder::basic::make_document;
+
+  if (paths.size() != 1 || columnMetadata.size() != 1) {
+    return false;
+  }
+
+  bsoncxx::document::value filter = make_document();
+  try {
+    if (!IsCountPipeline(stages, paths[0], filter)) {
+      return false;
+    }
+  } catch (const bsoncxx::exception& xcp) {
+    LOG_DEBUG_MSG("Unable to parse pipeline stage: " << xcp.what());
+    return false;
+  }
+
+  const config::Configuration& config = connection_.GetConfiguration();
+  int64_t count = 0;
+  if (filter.view().empty() && config.IsApproximateCount()) {
+    LOG_DEBUG_MSG("Using estimated document count");
+
+    mongocxx::options::estimated_document_count options;
+    if (timeout_) {
+      options.max_time(std::chrono::milliseconds(std::chrono::seconds(timeout_)));
+    }
+    options.read_preference(MakeReadPreference());
+    count = collection.estimated_document_count(options);
+  } else {
+    LOG_DEBUG_MSG("Using count documents");
+
+    mongocxx::options::count options;
+    if (timeout_) {
+      options.max_time(std::chrono::milliseconds(std::chrono::seconds(timeout_)));
+    }
+    options.read_preference(MakeReadPreference());
+    if (!options_.hint.empty()) {
+      options.hint(MakeHint());
+    }
+    if (!options_.collation.empty()) {
+      options.collation(bsoncxx::from_json(options_.collation));
+    }
+    count = collection.count_documents(filter.view(), options);
+  }
+
+  this->cursor_.reset(new DocumentDbCursor(
+      make_document(kvp(paths[0], count)), columnMetadata, paths));
+
+  return true;
+}
+
+void DataQuery::AppendResultLimits(
+    std::vector< std::string >& stages,
+    const std::vector< JdbcColumnMetadata >& columnMetadata,
+    const std::vector< std::string >& paths) const {
+  using bsoncxx::builder::basic::kvp;
+  using bsoncxx::builder::basic::make_array;
+  using bsoncxx::builder::basic::make_document;
+  using namespace documentdb::odbc::impl::binary;
+
+  // A trailing $limit is always safe, even if the query has its own limit.
+  if (options_.maxRows > 0) {
+    stages.push_back(bsoncxx::to_json(make_document(
+        kvp("$limit", static_cast< int64_t >(options_.maxRows)))));
+  }
+
+  if (options_.maxLength == 0) {
+    return;
+  }
+
+  // Nested or repeated paths cannot be re-projected without conflicts.
+  std::set< std::string > uniquePaths(paths.begin(), paths.end());
+  if (uniquePaths.size() != paths.size()
+      || std::any_of(paths.begin(), paths.end(), [](const std::string& path) {
+           return path.empty() || path.find('.') != std::string::npos;
+         })) {
+    LOG_DEBUG_MSG("Column paths cannot be projected, ignoring max length");
+    return;
+  }
+
+  int64_t maxLength =
+      static_cast< int64_t >(std::min< SqlUlen >(options_.maxLength, INT32_MAX));
+  bsoncxx::builder::basic::document project;
+  for (size_t i = 0; i < paths.size() && i < columnMetadata.size(); ++i) {
+    int32_t type = columnMetadata[i].GetColumnType();
+    if (type != JDBC_TYPE_CHAR && type != JDBC_TYPE_VARCHAR
+        && type != JDBC_TYPE_LONGVARCHAR) {
+      project.append(kvp(paths[i], 1));
+      continue;
+    }
+
+    // Only truncate strings so that missing and null values stay null.
+    std::string field = "$" + paths[i];
+    project.append(kvp(
+        paths[i],
+        make_document(kvp(
+            "$cond",
+            make_array(
+                make_document(kvp(
+                    "$eq", make_array(make_document(kvp("$type", field)),
+                                      "string"))),
+                make_document(
+                    kvp("$substrCP", make_array(field, 0, maxLength))),
+                field)))));
+  }
+  stages.push_back(
+      bsoncxx::to_json(make_document(kvp("$project", project.extract()))));
+}
+
+SqlResult::Type DataQuery::Explain(
+    std::vector< std::pair< std::string, std::string > >& rows) {
+  LOG_DEBUG_MSG("Explain is called");
+
+  using bsoncxx::builder::basic::kvp;
+  using bsoncxx::builder::basic::make_document;
+
+  rows.clear();
+
+  try {
+    SharedPointer< DocumentDbMqlQueryContext > mqlQueryContext;
+    DocumentDbError error;
+
+    auto translationStart = std::chrono::steady_clock::now();
+    SqlResult::Type result = GetMqlQueryContext(mqlQueryContext, error);
+    auto translationTime =
+        std::chrono::duration_cast< std::chrono::milliseconds >(
+            std::chrono::steady_clock::now() - translationStart);
+    if (result != SqlResult::AI_SUCCESS) {
+      diag.AddStatusRecord(Logger::RedactMessage(error.GetText()));
+
+      LOG_ERROR_MSG("Explain exiting with error msg: "
+                    << Logger::MarkSensitive(error.GetText()));
+
+      return result;
+    }
+
+    std::vector< std::string > stages =
+        mqlQueryContext.Get()->GetAggregateOperations();
+    AppendResultLimits(stages, mqlQueryContext.Get()->GetColumnMetadata(),
+                       mqlQueryContext.Get()->GetPaths());
+    UpdateRouting(stages);
+
+    std::string collectionName = mqlQueryContext.Get()->GetCollectionName();
+    rows.emplace_back("collection", collectionName);
+    bsoncxx::builder::basic::array pipeline;
+    for (size_t i = 0; i < stages.size(); ++i) {
+      rows.emplace_back("stage " + std::to_string(i + 1), stages[i]);
+      pipeline.append(bsoncxx::from_json(stages[i]));
+    }
+    rows.emplace_back("translation_time_ms",
+                      std::to_string(translationTime.count()));
+    rows.emplace_back("read_preference",
+                      ReadPreference::ToString(GetReadPreference()));
+
+    bsoncxx::builder::basic::document aggregate;
+    aggregate.append(kvp("aggregate", collectionName),
+                     kvp("pipeline", pipeline.extract()),
+                     kvp("cursor", make_document()));
+    if (!options_.hint.empty()) {
+      if (options_.hint[0] == '{') {
+        aggregate.append(kvp("hint", bsoncxx::from_json(options_.hint)));
+      } else {
+        aggregate.append(kvp("hint", options_.hint));
+      }
+    }
+
+    // Explain with the options of MakeAggregateOptions that can change the
+    // plan or the node it runs on.
+    const config::Configuration& config = connection_.GetConfiguration();
+    if (!options_.collation.empty()) {
+      aggregate.append(
+          kvp("collation", bsoncxx::from_json(options_.collation)));
+    }
+    if (options_.readConcern || config.IsReadConcernSet()) {
+      aggregate.append(kvp(
+          "readConcern",
+          make_document(kvp("level", ReadConcern::ToString(
+                                         options_.readConcern
+                                             ? *options_.readConcern
+                                             : config.GetReadConcern())))));
+    }
+
+    bsoncxx::builder::basic::document command;
+    command.append(kvp("explain", aggregate.extract()),
+                   kvp("verbosity", "executionStats"));
+    // run_command ignores the read preference of the database, so it is
+    // passed in the command for the server to route the explain.
+    ReadPreference::Type readPreference = GetReadPreference();
+    if (readPreference != ReadPreference::Type::PRIMARY) {
+      bsoncxx::builder::basic::document readPreferenceDoc;
+      readPreferenceDoc.append(
+          kvp("mode", ReadPreference::ToJdbcString(readPreference)));
+      if (options_.maxStalenessSeconds) {
+        readPreferenceDoc.append(
+            kvp("maxStalenessSeconds", *options_.maxStalenessSeconds));
+      }
+      command.append(kvp("$readPreference", readPreferenceDoc.extract()));
+    }
+
+    std::shared_ptr< mongocxx::client > client =
+        connection_.AcquireMongoClient(timeout_);
+    mongocxx::database database = client->database(config.GetDatabase());
+    bsoncxx::document::value reply = database.run_command(command.extract());
+    bsoncxx::document::view view = reply.view();
+
+    bsoncxx::document::element element;
+    if (FindElement(view, "winningPlan", element)) {
+      rows.emplace_back("winning_plan", ElementToString(element));
+
+      std::set< std::string > scans;
+      CollectScanStages(element.get_value(), scans);
+      std::string scan;
+      for (auto const& stage : scans) {
+        scan += (scan.empty() ? "" : ",") + stage;
+      }
+      rows.emplace_back("scan", scan);
+    }
+    if (FindElement(view, "nReturned", element)) {
+      rows.emplace_back("docs_returned", ElementToString(element));
+    }
+    if (FindElement(view, "totalDocsExamined", element)) {
+      rows.emplace_back("docs_examined", ElementToString(element));
+    }
+    if (FindElement(view, "totalKeysExamined", element)) {
+      rows.emplace_back("keys_examined", ElementToString(element));
+    }
+    if (FindElement(view, "executionTimeMillis", element)) {
+      rows.emplace_back("execution_time_ms", ElementToString(element));
+    }
+    // The node that explained the query, to check the read preference.
+    if (FindElement(view, "serverInfo", element)
+        && element.type() == bsoncxx::type::k_document) {
+      bsoncxx::document::element host;
+      if (FindElement(element.get_document().value, "host", host)) {
+        rows.emplace_back("server", ElementToString(host));
+      }
+    }
+    rows.emplace_back("explain", bsoncxx::to_json(view));
+  } catch (const mongocxx::exception& xcp) {
+    if (Connection::IsClientPoolTimeout(xcp)) {
+      diag.AddStatusRecord(SqlState::SHYT00_TIMEOUT_EXPIRED, xcp.what());
+
+      LOG_ERROR_MSG("Explain exiting with error msg: " << xcp.what());
+
+      return SqlResult::AI_ERROR;
+    }
+
+    std::stringstream message;
+    message << "Unable to explain the query."
+            << " code: " << xcp.code().value()
+            << " messagge: " << xcp.code().message()
+            << " cause: " << xcp.what();
+    diag.AddStatusRecord(Logger::RedactMessage(message.str()));
+
+    LOG_ERROR_MSG("Explain exiting with error msg: "
+                  << Logger::MarkSensitive(message.str()));
+
+    return SqlResult::AI_ERROR;
+  } catch (const bsoncxx::exception& xcp) {
+    diag.AddStatusRecord(std::string("Unable to explain the query. cause: ")
+                         + xcp.what());
+
+    LOG_ERROR_MSG("Explain exiting with error msg: " << xcp.what());
+
+    return SqlResult::AI_ERROR;
+  }
+
+  LOG_DEBUG_MSG("Explain exiting");
+
+  return SqlResult::AI_SUCCESS;
+}
+
 SqlResult::Type DataQuery::MakeRequestMoreResults() {
   LOG_DEBUG_MSG("MakeRequestMoreResults is called, and exiting");
 
@@ -404,7 +1246,7 @@ SqlResult::Type DataQuery::MakeRequestResultsetMeta() {
   if (!mqlQueryContext.IsValid() || sqlRes != SqlResult::AI_SUCCESS) {
     diag.AddStatusRecord(Logger::RedactMessage(error.GetText()));
     LOG_ERROR_MSG(
-        "MakeRequestResultsetMeta exiting with error msg: " << Logger::RedactMessage(error.GetText()));
+        "MakeRequestResultsetMeta exiting with error msg: " << Logger::MarkSensitive(error.GetText()));
 
     return SqlResult::AI_ERROR;
   }
@@ -461,6 +1303,7 @@ SqlResult::Type DataQuery::ProcessConversionResult(
     }
 
     case app::ConversionResult::Type::AI_VARLEN_DATA_TRUNCATED: {
+      ++trace_.truncations;
       diag.AddStatusRecord(
           SqlState::S01004_DATA_TRUNCATED,
           "Buffer is too small for the column data. Truncated from the right.",
@@ -474,6 +1317,7 @@ SqlResult::Type DataQuery::ProcessConversionResult(
     }
 
     case app::ConversionResult::Type::AI_FRACTIONAL_TRUNCATED: {
+      ++trace_.truncations;
       diag.AddStatusRecord(
           SqlState::S01S07_FRACTIONAL_TRUNCATION,
           "Buffer is too small for the column data. Fraction truncated.",
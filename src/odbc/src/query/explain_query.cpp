@@ -0,0 +1,164 @@
+/*
+ * Copyright <2022> Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ */
+
+
+#include "documentdb/odbc/query/explain_query.h"
+
+#include "documentdb/odbc/impl/binary/binary_common.h"
+#include "documentdb/odbc/log.h"
+
+namespace {
+struct ResultColumn {
+  enum Type {
+    /** Explain item name. */
+    ITEM = 1,
+
+    /** Explain item value. */
+    VALUE
+  };
+};
+}  // namespace
+
+namespace documentdb {
+namespace odbc {
+namespace query {
+ExplainQuery::ExplainQuery(diagnostic::DiagnosableAdapter& diag,
+                           Connection& connection, const std::string& sql,
+                           const app::ParameterSet& params, int32_t& timeout,
+                           const DataQueryOptions& options)
+    : Query(diag, QueryType::EXPLAIN),
+      query(diag, connection, sql, params, timeout, options),
+      executed(false),
+      fetched(false),
+      columnsMeta() {
+  using namespace documentdb::odbc::impl::binary;
+
+  using meta::ColumnMeta;
+  using meta::Nullability;
+
+  columnsMeta.reserve(2);
+
+  const std::string sch("");
+  const std::string tbl("");
+
+  columnsMeta.push_back(
+      ColumnMeta(sch, tbl, "ITEM", JDBC_TYPE_VARCHAR, Nullability::NO_NULL));
+  columnsMeta.push_back(
+      ColumnMeta(sch, tbl, "VALUE", JDBC_TYPE_VARCHAR, Nullability::NULLABLE));
+}
+
+ExplainQuery::~ExplainQuery() {
+  // No-op.
+}
+
+SqlResult::Type ExplainQuery::Execute() {
+  if (executed)
+    Close();
+
+  SqlResult::Type result = query.Explain(rows);
+
+  if (result == SqlResult::AI_SUCCESS) {
+    executed = true;
+    fetched = false;
+
+    cursor = rows.begin();
+  }
+
+  return result;
+}
+
+const meta::ColumnMetaVector* ExplainQuery::GetMeta() {
+  return &columnsMeta;
+}
+
+SqlResult::Type ExplainQuery::FetchNextRow(
+    app::ColumnBindingMap& columnBindings) {
+  if (!executed) {
+    diag.AddStatusRecord(SqlState::SHY010_SEQUENCE_ERROR,
+                         "Query was not executed.");
+
+    return SqlResult::AI_ERROR;
+  }
+
+  if (!fetched)
+    fetched = true;
+  else if (cursor != rows.end())
+    ++cursor;
+  if (cursor == rows.end())
+    return SqlResult::AI_NO_DATA;
+
+  app::ColumnBindingMap::iterator it;
+
+  for (it = columnBindings.begin(); it != columnBindings.end(); ++it)
+    GetColumn(it->first, it->second);
+
+  return SqlResult::AI_SUCCESS;
+}
+
+SqlResult::Type ExplainQuery::GetColumn(uint16_t columnIdx,
+                                        app::ApplicationDataBuffer& buffer) {
+  if (!executed) {
+    diag.AddStatusRecord(SqlState::SHY010_SEQUENCE_ERROR,
+                         "Query was not executed.");
+
+    return SqlResult::AI_ERROR;
+  }
+
+  if (cursor == rows.end())
+    return SqlResult::AI_NO_DATA;
+
+  switch (columnIdx) {
+    case ResultColumn::ITEM: {
+      buffer.PutString(cursor->first);
+      break;
+    }
+
+    case ResultColumn::VALUE: {
+      buffer.PutString(cursor->second);
+      break;
+    }
+
+    default:
+      break;
+  }
+
+  return SqlResult::AI_SUCCESS;
+}
+
+SqlResult::Type ExplainQuery::Close() {
+  rows.clear();
+  cursor = rows.end();
+
+  executed = false;
+  fetched = false;
+
+  return SqlResult::AI_SUCCESS;
+}
+
+bool ExplainQuery::DataAvailable() const {
+  return executed && cursor != rows.end();
+}
+
+int64_t ExplainQuery::AffectedRows() const {
+  return 0;
+}
+
+SqlResult::Type ExplainQuery::NextResultSet() {
+  return SqlResult::AI_NO_DATA;
+}
+}  // namespace query
+}  // namespace odbc
+}  // namespace documentdb
@@ -0,0 +1,70 @@
+/*
+ * Copyright <2022> Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ */
+
+
+#include "documentdb/odbc/read_concern.h"
+
+#include <documentdb/odbc/common/utils.h>
+
+namespace documentdb {
+namespace odbc {
+ReadConcern::Type ReadConcern::FromString(const std::string& val,
+                                          Type dflt) {
+  std::string lowerVal = common::ToLower(val);
+
+  common::StripSurroundingWhitespaces(lowerVal);
+
+  if (lowerVal == "local")
+    return ReadConcern::Type::LOCAL;
+
+  if (lowerVal == "available")
+    return ReadConcern::Type::AVAILABLE;
+
+  if (lowerVal == "majority")
+    return ReadConcern::Type::MAJORITY;
+
+  if (lowerVal == "linearizable")
+    return ReadConcern::Type::LINEARIZABLE;
+
+  if (lowerVal == "snapshot")
+    return ReadConcern::Type::SNAPSHOT;
+
+  return dflt;
+}
+
+std::string ReadConcern::ToString(Type val) {
+  switch (val) {
+    case ReadConcern::Type::LOCAL:
+      return "local";
+
+    case ReadConcern::Type::AVAILABLE:
+      return "available";
+
+    case ReadConcern::Type::MAJORITY:
+      return "majority";
+
+    case ReadConcern::Type::LINEARIZABLE:
+      return "linearizable";
+
+    case ReadConcern::Type::SNAPSHOT:
+      return "snapshot";
+
+    default:
+      return "unknown";
+  }
+}
+}  // namespace odbc
+}  // namespace documentdb
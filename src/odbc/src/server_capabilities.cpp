@@ -0,0 +1,190 @@
+/*
+ * Copyright <2022> Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ */
+
+
+#include "documentdb/odbc/server_capabilities.h"
+
+#include <bsoncxx/builder/stream/document.hpp>
+#include <bsoncxx/builder/stream/helpers.hpp>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+
+#include "documentdb/odbc/common/utils.h"
+
+using documentdb::odbc::common::concurrent::CsLockGuard;
+
+namespace {
+/** Wire version of the first server release with the $sample stage. */
+const int32_t SAMPLE_MIN_WIRE_VERSION = 4;
+
+/**
+ * Read an integer document or array element, which might come in different
+ * data types.
+ *
+ * @param element Element.
+ * @return Value, or zero if not a number.
+ */
+template < typename Element >
+int64_t ElementToInt(const Element& element) {
+  switch (element.type()) {
+    case bsoncxx::type::k_int32:
+      return element.get_int32().value;
+    case bsoncxx::type::k_int64:
+      return element.get_int64().value;
+    case bsoncxx::type::k_double:
+      return static_cast< int64_t >(element.get_double().value);
+    case bsoncxx::type::k_utf8:
+      return std::atol(element.get_utf8().value.to_string().c_str());
+    default:
+      return 0;
+  }
+}
+}  // namespace
+
+namespace documentdb {
+namespace odbc {
+std::string ServerCapabilities::GetDbmsVer() const {
+  if (versionArray.empty()) {
+    return std::string();
+  }
+
+  // Format the first three version elements in the version string.
+  std::stringstream versionString;
+  for (size_t index = 0; index < versionArray.size() && index < 3; index++) {
+    switch (index) {
+      case 0:
+        versionString << std::setw(2) << std::setfill('0')
+                      << versionArray[index];
+        break;
+      case 1:
+        versionString << "." << std::setw(2) << std::setfill('0')
+                      << versionArray[index];
+        break;
+      case 2:
+        versionString << "." << std::setw(4) << std::setfill('0')
+                      << versionArray[index];
+        break;
+    }
+  }
+  return versionString.str();
+}
+
+bool ServerCapabilities::IsSampleSupported() const {
+  return maxWireVersion >= SAMPLE_MIN_WIRE_VERSION;
+}
+
+ServerCapabilitiesCache& ServerCapabilitiesCache::GetInstance() {
+  static ServerCapabilitiesCache instance;
+  return instance;
+}
+
+std::string ServerCapabilitiesCache::MakeKey(
+    const config::Configuration& config) {
+  std::stringstream key;
+  key << common::ToLower(config.GetHostname()) << ':' << config.GetPort()
+      << '/' << config.GetReplicaSet();
+  return key.str();
+}
+
+bool ServerCapabilitiesCache::Fetch(mongocxx::database& db,
+                                    ServerCapabilities& caps) {
+  bsoncxx::builder::stream::document buildInfo;
+  buildInfo << "buildInfo" << 1;
+  auto buildInfoResult = db.run_command(buildInfo.view());
+  auto buildInfoView = buildInfoResult.view();
+  if (buildInfoView["ok"].get_double() != 1) {
+    return false;
+  }
+
+  bsoncxx::builder::stream::document isMaster;
+  isMaster << "isMaster" << 1;
+  auto isMasterResult = db.run_command(isMaster.view());
+  auto isMasterView = isMasterResult.view();
+  if (isMasterView["ok"].get_double() != 1) {
+    return false;
+  }
+
+  ServerCapabilities result;
+  auto version = buildInfoView.find("version");
+  if (version != buildInfoView.end()
+      && version->type() == bsoncxx::type::k_utf8) {
+    result.version = version->get_utf8().value.to_string();
+  }
+  auto versionArray = buildInfoView.find("versionArray");
+  if (versionArray != buildInfoView.end()
+      && versionArray->type() == bsoncxx::type::k_array) {
+    for (auto const& element : versionArray->get_array().value) {
+      result.versionArray.push_back(ElementToInt(element));
+    }
+  }
+  auto maxWireVersion = isMasterView.find("maxWireVersion");
+  if (maxWireVersion != isMasterView.end()) {
+    result.maxWireVersion =
+        static_cast< int32_t >(ElementToInt(*maxWireVersion));
+  }
+  auto setName = isMasterView.find("setName");
+  if (setName != isMasterView.end()
+      && setName->type() == bsoncxx::type::k_utf8) {
+    result.setName = setName->get_utf8().value.to_string();
+  }
+
+  caps = result;
+  return true;
+}
+
+bool ServerCapabilitiesCache::Get(const std::string& key,
+                                  ServerCapabilities& caps) {
+  CsLockGuard guard(lock);
+
+  std::map< std::string, ServerCapabilities >::const_iterator it =
+      entries.find(key);
+  if (it == entries.end()) {
+    return false;
+  }
+
+  ++hits;
+  caps = it->second;
+  return true;
+}
+
+void ServerCapabilitiesCache::Put(const std::string& key,
+                                  const ServerCapabilities& caps) {
+  CsLockGuard guard(lock);
+
+  entries[key] = caps;
+  ++fetches;
+}
+
+void ServerCapabilitiesCache::Invalidate(const std::string& key) {
+  CsLockGuard guard(lock);
+
+  entries.erase(key);
+}
+
+size_t ServerCapabilitiesCache::GetHitCount() {
+  CsLockGuard guard(lock);
+
+  return hits;
+}
+
+size_t ServerCapabilitiesCache::GetFetchCount() {
+  CsLockGuard guard(lock);
+
+  return fetches;
+}
+}  // namespace odbc
+}  // namespace documentdb
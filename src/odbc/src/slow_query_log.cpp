@@ -0,0 +1,106 @@
+/*
+ * Copyright <2022> Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ */
+
+
+#include "documentdb/odbc/slow_query_log.h"
+
+#include <time.h>
+
+#include <sstream>
+
+#include "documentdb/odbc/common/platform_utils.h"
+#include "documentdb/odbc/log.h"
+#include "documentdb/odbc/utility.h"
+
+using documentdb::odbc::common::concurrent::CsLockGuard;
+
+namespace documentdb {
+namespace odbc {
+SlowQueryLog& SlowQueryLog::GetInstance() {
+  static SlowQueryLog instance;
+  return instance;
+}
+
+std::string SlowQueryLog::Format(const Entry& entry) {
+  // Statements of different threads close concurrently, and localtime
+  // shares its result between threads.
+  char time[32];
+  time_t curTime = ::time(nullptr);
+  tm locTime;
+  common::ToLocalTime(curTime, locTime);
+  strftime(time, sizeof(time), "%Y-%m-%dT%H:%M:%S", &locTime);
+
+  std::stringstream stages;
+  stages << "[";
+  for (size_t i = 0; i < entry.stages.size(); ++i)
+    stages << (i ? "," : "") << entry.stages[i];
+  stages << "]";
+
+  // The pipeline holds the literals of the query, like the SQL, but is
+  // redacted as a whole whatever the log format.
+  bool debug =
+      Logger::GetLoggerInstance()->GetLogLevel() == LogLevel::Type::DEBUG_LEVEL;
+  std::string pipeline = debug ? stages.str() : "\"" REDACTED_STRING "\"";
+  std::string sql = debug                     ? entry.sql
+                    : Logger::IsJsonFormat() ? Logger::RedactLiterals(entry.sql)
+                                             : REDACTED_STRING;
+
+  std::stringstream json;
+  json << "{\"time\":\"" << time
+       << "\",\"elapsed_ms\":" << entry.elapsedMicros / 1000
+       << ",\"driver_ms\":" << entry.driverMicros / 1000
+       << ",\"threshold_ms\":" << entry.thresholdMs << ",\"collection\":\""
+       << utility::EscapeJson(entry.collection) << "\",\"comment\":\""
+       << utility::EscapeJson(entry.comment) << "\",\"sql\":\""
+       << utility::EscapeJson(sql)
+       << "\",\"pipeline\":" << pipeline << ",\"trace\":"
+       << (entry.trace.empty() ? "{}" : entry.trace) << "}";
+
+  return json.str();
+}
+
+void SlowQueryLog::Write(const Entry& entry) {
+  std::string record = Format(entry);
+
+  char date[16];
+  time_t curTime = time(nullptr);
+  tm locTime;
+  common::ToLocalTime(curTime, locTime);
+  strftime(date, sizeof(date), "%Y%m%d", &locTime);
+  std::stringstream path;
+  path << Logger::GetLoggerInstance()->GetLogPath() << common::Fs
+       << "docdb_odbc_slow_" << date << ".log";
+
+  CsLockGuard guard(mutex);
+  // A new file is started every day, or when the log path changes.
+  if (path.str() != filePath || !fileStream.is_open()) {
+    fileStream.close();
+    filePath = path.str();
+    fileStream.open(filePath, std::ios_base::app);
+  }
+  if (!fileStream.is_open()) {
+    LOG_ERROR_MSG("Unable to open the slow query log " << filePath);
+    return;
+  }
+  fileStream << record << std::endl;
+}
+
+std::string SlowQueryLog::GetFilePath() {
+  CsLockGuard guard(mutex);
+  return filePath;
+}
+}  // namespace odbc
+}  // namespace documentdb
@@ -15,6 +15,7 @@
  * limitations under the License.
  */
 
+#include <documentdb/odbc/common/utils.h>
 #include <documentdb/odbc/odbc_error.h>
 #include <documentdb/odbc/sql/sql_lexer.h>
 #include <documentdb/odbc/sql/sql_utils.h>
@@ -43,6 +44,33 @@ bool IsInternalCommand(const std::string& sql) {
 
   return lexer.ExpectNextToken(TokenType::WORD, "streaming");
 }
+
+bool ParseExplainCommand(const std::string& sql, std::string& explainedSql) {
+  SqlLexer lexer(sql);
+
+  OdbcExpected< bool > hasNext = lexer.Shift();
+
+  if (!hasNext.IsOk() || !*hasNext)
+    return false;
+
+  const SqlToken& token = lexer.GetCurrentToken();
+
+  if (token.GetType() != TokenType::WORD || token.ToLower() != "explain")
+    return false;
+
+  size_t end = static_cast< size_t >(token.GetValue() - sql.data())
+               + static_cast< size_t >(token.GetSize());
+  std::string rest = sql.substr(end);
+
+  common::StripSurroundingWhitespaces(rest);
+
+  if (rest.empty())
+    return false;
+
+  explainedSql = rest;
+
+  return true;
+}
 }  // namespace sql_utils
 }  // namespace odbc
 }  // namespace documentdb
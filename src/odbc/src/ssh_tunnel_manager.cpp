@@ -0,0 +1,239 @@
+/*
+ * Copyright <2022> Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ */
+
+
+#include "documentdb/odbc/ssh_tunnel_manager.h"
+
+#include <functional>
+#include <sstream>
+
+#include "documentdb/odbc/log.h"
+
+using documentdb::odbc::common::concurrent::CsLockGuard;
+using documentdb::odbc::common::concurrent::SharedPointer;
+using documentdb::odbc::config::Configuration;
+using documentdb::odbc::jni::DocumentDbConnection;
+using documentdb::odbc::jni::java::JniContext;
+using documentdb::odbc::jni::java::JniErrorCode;
+using documentdb::odbc::jni::java::JniErrorInfo;
+
+namespace documentdb {
+namespace odbc {
+SshTunnelManager& SshTunnelManager::GetInstance() {
+  static SshTunnelManager instance;
+  return instance;
+}
+
+bool SshTunnelManager::IsTunnelConfigured(const Configuration& config) {
+  // Same condition as the JDBC driver uses to open its tunnel.
+  return !config.GetSshUser().empty() && !config.GetSshHost().empty()
+         && !config.GetSshPrivateKeyFile().empty();
+}
+
+std::string SshTunnelManager::MakeKey(const Configuration& config) {
+  std::stringstream key;
+  key << config.GetSshUser() << '@' << config.GetSshHost() << ';'
+      << config.GetSshPrivateKeyFile() << ';' << std::hex
+      << std::hash< std::string >()(config.GetSshPrivateKeyPassphrase())
+      << std::dec << ';' << config.IsSshStrictHostKeyChecking() << ';'
+      << config.GetSshKnownHostsFile() << ';' << config.GetHostname() << ':'
+      << config.GetPort();
+  return key.str();
+}
+
+Configuration SshTunnelManager::MakeTunneledConfiguration(
+    const Configuration& config, int32_t localPort) {
+  Configuration tunneled = config;
+  tunneled.SetHostname("localhost");
+  tunneled.SetPort(static_cast< uint16_t >(localPort));
+  tunneled.SetSshUser("");
+  tunneled.SetSshHost("");
+  tunneled.SetSshPrivateKeyFile("");
+  tunneled.SetSshPrivateKeyPassphrase("");
+  // The server certificate is not issued for localhost, unless the user
+  // decided otherwise.
+  if (!config.IsTlsAllowInvalidHostnamesSet()) {
+    tunneled.SetTlsAllowInvalidHostnames(true);
+  }
+  return tunneled;
+}
+
+bool SshTunnelManager::Acquire(const Configuration& config,
+                               SharedPointer< JniContext > ctx,
+                               std::string& key, int32_t& localPort,
+                               DocumentDbError& err) {
+  std::string tunnelKey = MakeKey(config);
+
+  {
+    CsLockGuard guard(lock);
+
+    // Another connection might be opening the same tunnel.
+    std::map< std::string, std::string >::iterator current;
+    while ((current = currentTunnels.find(tunnelKey)) != currentTunnels.end()
+           && tunnels[current->second].opening) {
+      opened.Wait(lock);
+    }
+
+    if (current != currentTunnels.end()) {
+      Tunnel& tunnel = tunnels[current->second];
+      ++tunnel.refCount;
+      key = current->second;
+      localPort = tunnel.localPort;
+
+      LOG_DEBUG_MSG("Sharing SSH tunnel on local port "
+                    << localPort << ", references: " << tunnel.refCount);
+
+      return true;
+    }
+
+    key = tunnelKey + '#' + std::to_string(nextTunnelId++);
+    currentTunnels[tunnelKey] = key;
+    Tunnel& tunnel = tunnels[key];
+    tunnel.tunnelKey = tunnelKey;
+    tunnel.opening = true;
+  }
+
+  // The tunnel is opened without the lock, so that connections using other
+  // tunnels do not wait for the SSH handshake and the login.
+  JniErrorInfo errInfo;
+  SharedPointer< DocumentDbConnection > owner = new DocumentDbConnection(ctx);
+  int32_t port = 0;
+  if (!owner.IsValid()
+      || owner.Get()->Open(config, errInfo)
+             != JniErrorCode::DOCUMENTDB_JNI_ERR_SUCCESS
+      || !owner.Get()->IsOpen()) {
+    err = DocumentDbError(
+        DocumentDbError::DOCUMENTDB_ERR_SECURE_CONNECTION_FAILURE,
+        errInfo.errMsg.c_str());
+  } else if (owner.Get()->GetSshLocalPort(port, errInfo)
+                 != JniErrorCode::DOCUMENTDB_JNI_ERR_SUCCESS
+             || port <= 0) {
+    err = DocumentDbError(DocumentDbError::DOCUMENTDB_ERR_JVM_INIT,
+                          errInfo.errMsg.c_str());
+    owner.Get()->Close(errInfo);
+    port = 0;
+  }
+
+  CsLockGuard guard(lock);
+
+  if (port <= 0) {
+    // The waiting connections try to open the tunnel themselves.
+    Forget(key);
+    key.clear();
+    opened.NotifyAll();
+    return false;
+  }
+
+  Tunnel& tunnel = tunnels[key];
+  tunnel.owner = owner;
+  tunnel.localPort = port;
+  tunnel.refCount = 1;
+  tunnel.opening = false;
+  localPort = port;
+  opened.NotifyAll();
+
+  LOG_INFO_MSG("Opened SSH tunnel on local port " << localPort);
+
+  return true;
+}
+
+bool SshTunnelManager::Reacquire(const Configuration& config,
+                                 SharedPointer< JniContext > ctx,
+                                 std::string& key, int32_t& localPort,
+                                 DocumentDbError& err) {
+  {
+    CsLockGuard guard(lock);
+
+    // New connections no longer share the broken tunnel. It is closed with
+    // its last reference.
+    std::map< std::string, Tunnel >::const_iterator it = tunnels.find(key);
+    if (it != tunnels.end()) {
+      std::map< std::string, std::string >::iterator current =
+          currentTunnels.find(it->second.tunnelKey);
+      if (current != currentTunnels.end() && current->second == key) {
+        currentTunnels.erase(current);
+      }
+    }
+  }
+
+  // Another connection might have replaced the tunnel already.
+  std::string newKey;
+  int32_t newLocalPort = 0;
+  if (!Acquire(config, ctx, newKey, newLocalPort, err)) {
+    return false;
+  }
+
+  Release(key);
+  key = newKey;
+  localPort = newLocalPort;
+
+  LOG_INFO_MSG("Replaced SSH tunnel, now on local port " << localPort);
+
+  return true;
+}
+
+void SshTunnelManager::Release(const std::string& key) {
+  SharedPointer< DocumentDbConnection > owner;
+
+  {
+    CsLockGuard guard(lock);
+
+    std::map< std::string, Tunnel >::iterator it = tunnels.find(key);
+    if (it == tunnels.end()) {
+      return;
+    }
+
+    if (--it->second.refCount > 0) {
+      return;
+    }
+
+    owner = it->second.owner;
+    Forget(key);
+  }
+
+  JniErrorInfo errInfo;
+  if (owner.IsValid()
+      && owner.Get()->Close(errInfo)
+             != JniErrorCode::DOCUMENTDB_JNI_ERR_SUCCESS) {
+    LOG_ERROR_MSG("Unable to close SSH tunnel: " << errInfo.errMsg);
+  }
+
+  LOG_INFO_MSG("Closed SSH tunnel");
+}
+
+size_t SshTunnelManager::GetRefCount(const std::string& key) {
+  CsLockGuard guard(lock);
+
+  std::map< std::string, Tunnel >::const_iterator it = tunnels.find(key);
+
+  return it == tunnels.end() ? 0 : it->second.refCount;
+}
+
+void SshTunnelManager::Forget(const std::string& key) {
+  std::map< std::string, Tunnel >::iterator it = tunnels.find(key);
+  if (it == tunnels.end()) {
+    return;
+  }
+
+  std::map< std::string, std::string >::iterator current =
+      currentTunnels.find(it->second.tunnelKey);
+  if (current != currentTunnels.end() && current->second == key) {
+    currentTunnels.erase(current);
+  }
+  tunnels.erase(it);
+}
+}  // namespace odbc
+}  // namespace documentdb
@@ -17,16 +17,21 @@
 
 #include "documentdb/odbc/statement.h"
 
+#include <atomic>
 #include <boost/optional.hpp>
+#include <bsoncxx/exception/exception.hpp>
+#include <bsoncxx/json.hpp>
 #include <limits>
 
 #include "documentdb/odbc/connection.h"
 #include "documentdb/odbc/log.h"
 #include "documentdb/odbc/message.h"
+#include "documentdb/odbc/metrics.h"
 #include "documentdb/odbc/odbc_error.h"
 #include "documentdb/odbc/query/batch_query.h"
 #include "documentdb/odbc/query/column_metadata_query.h"
 #include "documentdb/odbc/query/data_query.h"
+#include "documentdb/odbc/query/explain_query.h"
 #include "documentdb/odbc/query/foreign_keys_query.h"
 #include "documentdb/odbc/query/internal_query.h"
 #include "documentdb/odbc/query/primary_keys_query.h"
@@ -39,6 +44,26 @@
 #include "documentdb/odbc/system/odbc_constants.h"
 #include "documentdb/odbc/utility.h"
 
+namespace {
+/** Source of the statement identifiers used to tag the queries. */
+std::atomic< uint64_t > nextStatementId(1);
+
+/**
+ * Check if the value is a valid JSON document.
+ *
+ * @param json Value to check.
+ * @return @c true if the value can be parsed.
+ */
+bool IsJsonDocument(const std::string& json) {
+  try {
+    bsoncxx::from_json(json);
+  } catch (const bsoncxx::exception&) {
+    return false;
+  }
+  return true;
+}
+}  // namespace
+
 namespace documentdb {
 namespace odbc {
 Statement::Statement(Connection& parent)
@@ -50,14 +75,23 @@ Statement::Statement(Connection& parent)
       columnBindOffset(0),
       rowArraySize(1),
       parameters(),
-      timeout(0) {
-  // No-op.
+      timeout(0),
+      dataQueryOptions() {
+  dataQueryOptions.statementId = nextStatementId++;
 }
 
 Statement::~Statement() {
   // No-op.
 }
 
+uint64_t Statement::GetLogConnectionId() const {
+  return connection.GetLogConnectionId();
+}
+
+uint64_t Statement::GetLogStatementId() const {
+  return dataQueryOptions.statementId;
+}
+
 void Statement::BindColumn(uint16_t columnIdx, int16_t targetType,
                            void* targetValue, SqlLen bufferLength,
                            SqlLen* strLengthOrIndicator) {
@@ -223,7 +257,7 @@ void Statement::SetAttribute(int attr, void* value, SQLINTEGER valueLen) {
 }
 
 SqlResult::Type Statement::InternalSetAttribute(int attr, void* value,
-                                                SQLINTEGER) {
+                                                SQLINTEGER valueLen) {
   switch (attr) {
     case SQL_ATTR_ROW_ARRAY_SIZE: {
       SqlUlen val = reinterpret_cast< SqlUlen >(value);
@@ -332,6 +366,169 @@ SqlResult::Type Statement::InternalSetAttribute(int attr, void* value,
       break;
     }
 
+    case SQL_ATTR_DOCUMENTDB_PARALLEL_SCAN_PARTITIONS: {
+      SqlUlen partitions = reinterpret_cast< SqlUlen >(value);
+
+      if (partitions > MAX_PARALLEL_SCAN_PARTITIONS) {
+        AddStatusRecord(SqlState::SHY024_INVALID_ATTRIBUTE_VALUE,
+                        "Number of parallel scan partitions is out of range.");
+
+        return SqlResult::AI_ERROR;
+      }
+
+      dataQueryOptions.parallelScanPartitions =
+          static_cast< int32_t >(partitions);
+
+      break;
+    }
+
+    case SQL_ATTR_MAX_ROWS: {
+      dataQueryOptions.maxRows = reinterpret_cast< SqlUlen >(value);
+
+      break;
+    }
+
+    case SQL_ATTR_MAX_LENGTH: {
+      dataQueryOptions.maxLength = reinterpret_cast< SqlUlen >(value);
+
+      break;
+    }
+
+    case SQL_ATTR_DOCUMENTDB_ALLOW_DISK_USE: {
+      dataQueryOptions.allowDiskUse =
+          reinterpret_cast< SqlUlen >(value) != SQL_FALSE;
+
+      break;
+    }
+
+    case SQL_ATTR_DOCUMENTDB_HINT: {
+      std::string hint = utility::SqlWcharToString(
+          reinterpret_cast< SQLWCHAR* >(value), valueLen, true);
+
+      if (!hint.empty() && hint[0] == '{' && !IsJsonDocument(hint)) {
+        AddStatusRecord(SqlState::SHY024_INVALID_ATTRIBUTE_VALUE,
+                        "Index hint is not a valid JSON document.");
+
+        return SqlResult::AI_ERROR;
+      }
+
+      dataQueryOptions.hint = hint;
+
+      break;
+    }
+
+    case SQL_ATTR_DOCUMENTDB_COMMENT: {
+      dataQueryOptions.comment = utility::SqlWcharToOptString(
+          reinterpret_cast< SQLWCHAR* >(value), valueLen, true);
+
+      break;
+    }
+
+    case SQL_ATTR_DOCUMENTDB_READ_CONCERN: {
+      if (!value) {
+        dataQueryOptions.readConcern = boost::none;
+
+        break;
+      }
+
+      ReadConcern::Type level = ReadConcern::FromString(
+          utility::SqlWcharToString(reinterpret_cast< SQLWCHAR* >(value),
+                                    valueLen, true));
+
+      if (level == ReadConcern::Type::UNKNOWN) {
+        AddStatusRecord(SqlState::SHY024_INVALID_ATTRIBUTE_VALUE,
+                        "Specified read concern is not supported.");
+
+        return SqlResult::AI_ERROR;
+      }
+
+      dataQueryOptions.readConcern = level;
+
+      break;
+    }
+
+    case SQL_ATTR_DOCUMENTDB_READ_PREFERENCE: {
+      if (!value) {
+        dataQueryOptions.readPreference = boost::none;
+
+        break;
+      }
+
+      ReadPreference::Type preference = ReadPreference::FromString(
+          utility::SqlWcharToString(reinterpret_cast< SQLWCHAR* >(value),
+                                    valueLen, true));
+
+      if (preference == ReadPreference::Type::UNKNOWN) {
+        AddStatusRecord(SqlState::SHY024_INVALID_ATTRIBUTE_VALUE,
+                        "Specified read preference is not supported.");
+
+        return SqlResult::AI_ERROR;
+      }
+
+      dataQueryOptions.readPreference = preference;
+
+      break;
+    }
+
+    case SQL_ATTR_DOCUMENTDB_COLLATION: {
+      std::string collation = utility::SqlWcharToString(
+          reinterpret_cast< SQLWCHAR* >(value), valueLen, true);
+
+      if (!collation.empty() && !IsJsonDocument(collation)) {
+        AddStatusRecord(SqlState::SHY024_INVALID_ATTRIBUTE_VALUE,
+                        "Collation is not a valid JSON document.");
+
+        return SqlResult::AI_ERROR;
+      }
+
+      dataQueryOptions.collation = collation;
+
+      break;
+    }
+
+    case SQL_ATTR_DOCUMENTDB_BATCH_SIZE: {
+      SqlUlen batchSize = reinterpret_cast< SqlUlen >(value);
+
+      if (batchSize > INT32_MAX) {
+        AddStatusRecord(SqlState::SHY024_INVALID_ATTRIBUTE_VALUE,
+                        "Batch size is out of range.");
+
+        return SqlResult::AI_ERROR;
+      }
+
+      dataQueryOptions.batchSize = batchSize;
+
+      break;
+    }
+
+    case SQL_ATTR_DOCUMENTDB_MAX_STALENESS_SECONDS: {
+      SqlUlen seconds = reinterpret_cast< SqlUlen >(value);
+
+      if (seconds == 0) {
+        dataQueryOptions.maxStalenessSeconds = boost::none;
+
+        break;
+      }
+
+      if (seconds < MIN_MAX_STALENESS_SECONDS || seconds > INT32_MAX) {
+        AddStatusRecord(SqlState::SHY024_INVALID_ATTRIBUTE_VALUE,
+                        "Maximum staleness is out of range.");
+
+        return SqlResult::AI_ERROR;
+      }
+
+      dataQueryOptions.maxStalenessSeconds = static_cast< int32_t >(seconds);
+
+      break;
+    }
+
+    case SQL_ATTR_DOCUMENTDB_STATEMENT_TRACE: {
+      AddStatusRecord(SqlState::SHY092_OPTION_TYPE_OUT_OF_RANGE,
+                      "Attribute is read only.");
+
+      return SqlResult::AI_ERROR;
+    }
+
     default: {
       AddStatusRecord(SqlState::SHYC00_OPTIONAL_FEATURE_NOT_IMPLEMENTED,
                       "Specified attribute is not supported.");
@@ -348,7 +545,8 @@ void Statement::GetAttribute(int attr, void* buf, SQLINTEGER bufLen,
   DOCUMENTDB_ODBC_API_CALL(InternalGetAttribute(attr, buf, bufLen, valueLen));
 }
 
-SqlResult::Type Statement::InternalGetAttribute(int attr, void* buf, SQLINTEGER,
+SqlResult::Type Statement::InternalGetAttribute(int attr, void* buf,
+                                                SQLINTEGER bufLen,
                                                 SQLINTEGER* valueLen) {
   if (!buf) {
     AddStatusRecord("Data buffer is NULL.");
@@ -483,6 +681,112 @@ SqlResult::Type Statement::InternalGetAttribute(int attr, void* buf, SQLINTEGER,
       break;
     }
 
+    case SQL_ATTR_DOCUMENTDB_PARALLEL_SCAN_PARTITIONS: {
+      SqlUlen* partitions = reinterpret_cast< SqlUlen* >(buf);
+
+      *partitions = static_cast< SqlUlen >(
+          dataQueryOptions.parallelScanPartitions
+              ? *dataQueryOptions.parallelScanPartitions
+              : connection.GetConfiguration().GetParallelScanPartitions());
+
+      break;
+    }
+
+    case SQL_ATTR_MAX_ROWS: {
+      SqlUlen* maxRows = reinterpret_cast< SqlUlen* >(buf);
+
+      *maxRows = dataQueryOptions.maxRows;
+
+      break;
+    }
+
+    case SQL_ATTR_MAX_LENGTH: {
+      SqlUlen* maxLength = reinterpret_cast< SqlUlen* >(buf);
+
+      *maxLength = dataQueryOptions.maxLength;
+
+      break;
+    }
+
+    case SQL_ATTR_DOCUMENTDB_ALLOW_DISK_USE: {
+      SqlUlen* allowDiskUse = reinterpret_cast< SqlUlen* >(buf);
+
+      bool val = dataQueryOptions.allowDiskUse
+                     ? *dataQueryOptions.allowDiskUse
+                     : connection.GetConfiguration().IsAllowDiskUse();
+      *allowDiskUse = val ? SQL_TRUE : SQL_FALSE;
+
+      break;
+    }
+
+    case SQL_ATTR_DOCUMENTDB_HINT:
+      return GetStringAttribute(dataQueryOptions.hint, buf, bufLen, valueLen);
+
+    case SQL_ATTR_DOCUMENTDB_COMMENT:
+      return GetStringAttribute(
+          dataQueryOptions.comment
+              ? *dataQueryOptions.comment
+              : connection.GetConfiguration().GetComment(),
+          buf, bufLen, valueLen);
+
+    case SQL_ATTR_DOCUMENTDB_READ_CONCERN: {
+      const config::Configuration& config = connection.GetConfiguration();
+      std::string level;
+      if (dataQueryOptions.readConcern) {
+        level = ReadConcern::ToString(*dataQueryOptions.readConcern);
+      } else if (config.IsReadConcernSet()) {
+        level = ReadConcern::ToString(config.GetReadConcern());
+      }
+
+      return GetStringAttribute(level, buf, bufLen, valueLen);
+    }
+
+    case SQL_ATTR_DOCUMENTDB_READ_PREFERENCE:
+      return GetStringAttribute(
+          ReadPreference::ToString(
+              dataQueryOptions.readPreference
+                  ? *dataQueryOptions.readPreference
+                  : connection.GetConfiguration().GetReadPreference()),
+          buf, bufLen, valueLen);
+
+    case SQL_ATTR_DOCUMENTDB_COLLATION:
+      return GetStringAttribute(dataQueryOptions.collation, buf, bufLen,
+                                valueLen);
+
+    case SQL_ATTR_DOCUMENTDB_BATCH_SIZE: {
+      SqlUlen* batchSize = reinterpret_cast< SqlUlen* >(buf);
+
+      *batchSize = dataQueryOptions.batchSize > 0
+                       ? dataQueryOptions.batchSize
+                       : static_cast< SqlUlen >(
+                           connection.GetConfiguration().GetDefaultFetchSize());
+
+      break;
+    }
+
+    case SQL_ATTR_DOCUMENTDB_MAX_STALENESS_SECONDS: {
+      SqlUlen* seconds = reinterpret_cast< SqlUlen* >(buf);
+
+      *seconds = dataQueryOptions.maxStalenessSeconds
+                     ? static_cast< SqlUlen >(
+                         *dataQueryOptions.maxStalenessSeconds)
+                     : 0;
+
+      break;
+    }
+
+    case SQL_ATTR_DOCUMENTDB_STATEMENT_TRACE: {
+      std::string trace = "{}";
+      if (currentQuery.get()
+          && currentQuery->GetType() == query::QueryType::DATA) {
+        trace = static_cast< query::DataQuery& >(*currentQuery)
+                    .GetTrace()
+                    .ToJson();
+      }
+
+      return GetStringAttribute(trace, buf, bufLen, valueLen);
+    }
+
     default: {
       AddStatusRecord(SqlState::SHYC00_OPTIONAL_FEATURE_NOT_IMPLEMENTED,
                       "Specified attribute is not supported.");
@@ -494,6 +798,33 @@ SqlResult::Type Statement::InternalGetAttribute(int attr, void* buf, SQLINTEGER,
   return SqlResult::AI_SUCCESS;
 }
 
+SqlResult::Type Statement::GetStringAttribute(const std::string& value,
+                                              void* buf, SQLINTEGER bufLen,
+                                              SQLINTEGER* valueLen) {
+  if (bufLen < 0) {
+    AddStatusRecord(SqlState::SHY090_INVALID_STRING_OR_BUFFER_LENGTH,
+                    "Buffer length is negative.");
+
+    return SqlResult::AI_ERROR;
+  }
+
+  bool isTruncated = false;
+  size_t outSize = utility::CopyStringToBuffer(
+      value, reinterpret_cast< SQLWCHAR* >(buf), bufLen, isTruncated, true);
+
+  if (valueLen)
+    *valueLen = static_cast< SQLINTEGER >(outSize);
+
+  if (isTruncated) {
+    AddStatusRecord(SqlState::S01004_DATA_TRUNCATED,
+                    "Attribute value was truncated.");
+
+    return SqlResult::AI_SUCCESS_WITH_INFO;
+  }
+
+  return SqlResult::AI_SUCCESS;
+}
+
 void Statement::GetParametersNumber(uint16_t& paramNum) {
   DOCUMENTDB_ODBC_API_CALL(InternalGetParametersNumber(paramNum));
 }
@@ -582,8 +913,17 @@ SqlResult::Type Statement::InternalPrepareSqlQuery(const std::string& query) {
   if (currentQuery.get())
     currentQuery->Close();
 
-  currentQuery.reset(
-      new query::DataQuery(*this, connection, query, parameters, timeout));
+  std::string explainedSql;
+  if (sql_utils::ParseExplainCommand(query, explainedSql)) {
+    currentQuery.reset(new query::ExplainQuery(*this, connection, explainedSql,
+                                               parameters, timeout,
+                                               dataQueryOptions));
+
+    return SqlResult::AI_SUCCESS;
+  }
+
+  currentQuery.reset(new query::DataQuery(*this, connection, query, parameters,
+                                          timeout, dataQueryOptions));
 
   return SqlResult::AI_SUCCESS;
 }
@@ -623,7 +963,8 @@ SqlResult::Type Statement::InternalExecuteSqlQuery() {
     query::BatchQuery& qry = static_cast< query::BatchQuery& >(*currentQuery);
 
     currentQuery.reset(new query::DataQuery(*this, connection, qry.GetSql(),
-                                            parameters, timeout));
+                                            parameters, timeout,
+                                            dataQueryOptions));
   }
 
   if (parameters.GetParamSetSize() > 1
@@ -655,6 +996,8 @@ SqlResult::Type Statement::InternalExecuteSqlQuery() {
     return SqlResult::AI_ERROR;
   }
 
+  Metrics::Increment(Metrics::Counter::STATEMENTS_EXECUTED);
+
   return currentQuery->Execute();
 }
 
@@ -0,0 +1,100 @@
+/*
+ * Copyright <2022> Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ */
+
+#include "documentdb/odbc/statement_trace.h"
+
+#include <sstream>
+
+namespace {
+/** Current trace of the thread. */
+thread_local documentdb::odbc::StatementTrace* currentTrace = nullptr;
+}  // namespace
+
+namespace documentdb {
+namespace odbc {
+StatementTrace::Scope::Scope(StatementTrace& trace) : previous(currentTrace) {
+  currentTrace = &trace;
+}
+
+StatementTrace::Scope::~Scope() {
+  currentTrace = previous;
+}
+
+void StatementTrace::Start() {
+  *this = StatementTrace();
+  started = Clock::now();
+}
+
+void StatementTrace::Finish() {
+  if (started != Clock::time_point() && finished == Clock::time_point())
+    finished = Clock::now();
+}
+
+void StatementTrace::AddReply(const std::string& command,
+                              int64_t durationMicros, uint64_t length) {
+  if (command == "getMore") {
+    ++batches;
+    getMoreMicros += durationMicros;
+  } else if (command == "aggregate" || command == "find") {
+    // The first batch comes with the reply of the command.
+    ++batches;
+  } else {
+    return;
+  }
+  bytes += length;
+}
+
+int64_t StatementTrace::GetElapsedMicros() const {
+  if (started == Clock::time_point())
+    return 0;
+
+  Clock::time_point end =
+      finished == Clock::time_point() ? Clock::now() : finished;
+  return std::chrono::duration_cast< std::chrono::microseconds >(end - started)
+      .count();
+}
+
+int64_t StatementTrace::GetDriverMicros() const {
+  return translateMicros + parseMicros + firstBatchMicros + getMoreMicros
+         + convertMicros;
+}
+
+std::string StatementTrace::ToJson() const {
+  if (started == Clock::time_point())
+    return "{}";
+
+  std::stringstream json;
+  json << "{\"elapsed_us\":" << GetElapsedMicros()
+       << ",\"translate_us\":" << translateMicros
+       << ",\"parse_us\":" << parseMicros
+       << ",\"first_batch_us\":" << firstBatchMicros
+       << ",\"get_more_us\":" << getMoreMicros
+       << ",\"convert_us\":" << convertMicros << ",\"rows\":" << rows
+       << ",\"bytes\":" << bytes << ",\"batches\":" << batches
+       << ",\"conversions\":" << conversions
+       << ",\"truncations\":" << truncations;
+  if (AllocationTracker::IsEnabled())
+    json << ",\"allocations\":" << allocations.ToJson();
+  json << "}";
+
+  return json.str();
+}
+
+StatementTrace* StatementTrace::GetCurrent() {
+  return currentTrace;
+}
+}  // namespace odbc
+}  // namespace documentdb
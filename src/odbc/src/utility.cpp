@@ -375,6 +375,12 @@ std::string HexDump(const void* data, size_t count) {
   }
   return dump.str();
 }
+
+std::string EscapeJson(const std::string& value) {
+  std::string escaped;
+  common::AppendEscapedJson(escaped, value);
+  return escaped;
+}
 }  // namespace utility
 }  // namespace odbc
 }  // namespace documentdb
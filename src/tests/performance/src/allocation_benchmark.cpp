@@ -0,0 +1,237 @@
+/*
+ * Copyright <2021> Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "performance_odbc_helper.h"
+
+// Driver-specific statement attributes, see odbc_constants.h in the driver.
+#ifndef SQL_DRIVER_STMT_ATTR_BASE
+#define SQL_DRIVER_STMT_ATTR_BASE 0x00004000
+#endif
+#define SQL_ATTR_DOCUMENTDB_STATEMENT_TRACE (SQL_DRIVER_STMT_ATTR_BASE + 10)
+
+namespace {
+const std::string kDefaultConnectionString =
+    "DRIVER={Amazon DocumentDB};HOSTNAME=localhost:27017;DATABASE=odbc-test;"
+    "TLS=false;";
+const std::string kDefaultQuery = "SELECT * FROM performance.employer";
+const double kDefaultMaxAllocationsPerRow = 32.0;
+const int kDefaultLoopCount = 3;
+const SQLLEN kColumnBufferLength = 256;
+const char* kComponents[] = {"other",      "cursor",      "row",
+                             "conversion", "diagnostics", "jni"};
+
+/**
+ * Get a number of the statement trace JSON.
+ *
+ * @param json Statement trace.
+ * @param key Key of the number, searched from position.
+ * @param position Position to start the search from.
+ * @return Number, or -1 if the key is not found.
+ */
+long long GetJsonNumber(const std::string& json, const std::string& key,
+                        size_t position = 0) {
+  std::string pattern = "\"" + key + "\":";
+  size_t found = json.find(pattern, position);
+  if (found == std::string::npos) {
+    return -1;
+  }
+  return std::atoll(json.c_str() + found + pattern.size());
+}
+
+struct FetchResult {
+  bool success = false;
+  long long rows = 0;
+  std::string trace;
+};
+
+/**
+ * Execute the query, fetch all rows into bound character buffers and get the
+ * statement trace before closing the cursor.
+ */
+FetchResult RunFetch(SQLHSTMT hstmt, const test_string& query) {
+  FetchResult result;
+
+  SQLRETURN ret = SQLExecDirect(hstmt, AS_SQLTCHAR(query.c_str()), SQL_NTS);
+  if (!SQL_SUCCEEDED(ret)) {
+    LogAnyDiagnostics(SQL_HANDLE_STMT, hstmt, ret);
+    return result;
+  }
+
+  SQLSMALLINT columnCount = 0;
+  SQLNumResultCols(hstmt, &columnCount);
+  std::vector< std::vector< SQLWCHAR > > buffers(
+      columnCount, std::vector< SQLWCHAR >(kColumnBufferLength));
+  std::vector< SQLLEN > lengths(columnCount);
+  for (SQLSMALLINT i = 0; i < columnCount; i++) {
+    SQLBindCol(hstmt, i + 1, SQL_C_WCHAR, buffers[i].data(),
+               kColumnBufferLength * sizeof(SQLWCHAR), &lengths[i]);
+  }
+
+  while (SQL_SUCCEEDED(ret = SQLFetch(hstmt))) {
+    result.rows++;
+  }
+  result.success = ret == SQL_NO_DATA;
+  if (!result.success) {
+    LogAnyDiagnostics(SQL_HANDLE_STMT, hstmt, ret);
+  }
+
+  SQLWCHAR trace[4096] = {};
+  SQLINTEGER traceLength = 0;
+  ret = SQLGetStmtAttr(hstmt, SQL_ATTR_DOCUMENTDB_STATEMENT_TRACE, trace,
+                       sizeof(trace), &traceLength);
+  if (SQL_SUCCEEDED(ret)) {
+    result.trace = wchar_to_string(trace);
+  } else {
+    LogAnyDiagnostics(SQL_HANDLE_STMT, hstmt, ret);
+    result.success = false;
+  }
+
+  SQLFreeStmt(hstmt, SQL_UNBIND);
+  SQLCloseCursor(hstmt);
+
+  return result;
+}
+}  // namespace
+
+/******************************************
+ * Main
+ *
+ * Counts the memory allocations of the driver per fetched row and fails when
+ * they exceed a budget. Needs a driver built with
+ * -DWITH_ALLOCATION_TRACKING=ON, which reports the allocations of each
+ * statement in the SQL_ATTR_DOCUMENTDB_STATEMENT_TRACE attribute.
+ *
+ * - argv[1] string = connection string
+ * - argv[2] string = query
+ * - argv[3] number = maximum allocations per fetched row
+ * - argv[4] integer = number of times the query is fetched
+ *****************************************/
+
+int main(int argc, char* argv[]) {
+  std::string connectionString =
+      argc > 1 ? argv[1] : kDefaultConnectionString;
+  std::string query = argc > 2 ? argv[2] : kDefaultQuery;
+  double maxAllocationsPerRow =
+      argc > 3 ? std::atof(argv[3]) : kDefaultMaxAllocationsPerRow;
+  int loopCount = argc > 4 ? std::atoi(argv[4]) : kDefaultLoopCount;
+  if (maxAllocationsPerRow <= 0 || loopCount <= 0) {
+    std::cerr << "ERROR: invalid allocation budget or number of iterations\n";
+    return EXIT_FAILURE;
+  }
+
+  SQLHENV env = SQL_NULL_HENV;
+  SQLHDBC conn = SQL_NULL_HDBC;
+  SQLHSTMT hstmt = SQL_NULL_HSTMT;
+  if (!SQL_SUCCEEDED(SQLAllocHandle(SQL_HANDLE_ENV, SQL_NULL_HANDLE, &env))) {
+    std::cerr << "ERROR: unable to allocate the environment\n";
+    return EXIT_FAILURE;
+  }
+  SQLSetEnvAttr(env, SQL_ATTR_ODBC_VERSION, (void*)SQL_OV_ODBC3, 0);
+  SQLAllocHandle(SQL_HANDLE_DBC, env, &conn);
+
+  test_string connStr = to_test_string(connectionString);
+  SQLTCHAR outConnString[1024];
+  SQLSMALLINT outConnStringLength;
+  SQLRETURN ret = SQLDriverConnect(
+      conn, nullptr, AS_SQLTCHAR(connStr.c_str()), SQL_NTS, outConnString,
+      IT_SIZEOF(outConnString), &outConnStringLength, SQL_DRIVER_NOPROMPT);
+  if (!SQL_SUCCEEDED(ret)) {
+    LogAnyDiagnostics(SQL_HANDLE_DBC, conn, ret);
+    SQLFreeHandle(SQL_HANDLE_DBC, conn);
+    SQLFreeHandle(SQL_HANDLE_ENV, env);
+    return EXIT_FAILURE;
+  }
+  SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+
+  // The first run warms up the driver (JVM, schema discovery); the budget
+  // applies to the lowest allocations per row of the runs that follow.
+  test_string queryStr = to_test_string(query);
+  int status = EXIT_SUCCESS;
+  double bestAllocationsPerRow = -1;
+  printf("%-6s %10s %12s %12s %12s %10s\n", "run", "rows", "allocations",
+         "bytes", "peak bytes", "alloc/row");
+  for (int i = 0; i <= loopCount; i++) {
+    FetchResult result = RunFetch(hstmt, queryStr);
+    if (!result.success) {
+      printf("%-6d FAILED\n", i);
+      status = EXIT_FAILURE;
+      break;
+    }
+
+    size_t allocations = result.trace.find("\"allocations\":");
+    if (allocations == std::string::npos) {
+      std::cerr << "ERROR: the driver was not built with "
+                   "-DWITH_ALLOCATION_TRACKING=ON\n";
+      status = EXIT_FAILURE;
+      break;
+    }
+    long long count = GetJsonNumber(result.trace, "count", allocations);
+    double allocationsPerRow =
+        result.rows > 0 ? static_cast< double >(count) / result.rows : 0.0;
+    printf("%-6d %10lld %12lld %12lld %12lld %10.2f\n", i, result.rows, count,
+           GetJsonNumber(result.trace, "bytes", allocations),
+           GetJsonNumber(result.trace, "peak_bytes", allocations),
+           allocationsPerRow);
+    // Fetching rows always allocates, so no allocations means that the
+    // driver's operator new is not the one being called.
+    if (count <= 0 && result.rows > 0) {
+      std::cerr << "ERROR: no allocations were counted, the replaced "
+                   "operator new of the driver is not called\n";
+      status = EXIT_FAILURE;
+      break;
+    }
+    if (i == 0) {
+      continue;
+    }
+
+    if (bestAllocationsPerRow < 0
+        || allocationsPerRow < bestAllocationsPerRow) {
+      bestAllocationsPerRow = allocationsPerRow;
+    }
+    if (i == loopCount) {
+      printf("\n%-12s %12s %12s\n", "component", "allocations", "bytes");
+      for (const char* component : kComponents) {
+        size_t position = result.trace.find(
+            "\"" + std::string(component) + "\":", allocations);
+        printf("%-12s %12lld %12lld\n", component,
+               GetJsonNumber(result.trace, "count", position),
+               GetJsonNumber(result.trace, "bytes", position));
+      }
+    }
+  }
+
+  if (status == EXIT_SUCCESS) {
+    printf("\nallocations per row: %.2f, budget: %.2f\n", bestAllocationsPerRow,
+           maxAllocationsPerRow);
+    if (bestAllocationsPerRow > maxAllocationsPerRow) {
+      std::cerr << "ERROR: allocations per fetched row exceed the budget\n";
+      status = EXIT_FAILURE;
+    }
+  }
+
+  SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+  SQLDisconnect(conn);
+  SQLFreeHandle(SQL_HANDLE_DBC, conn);
+  SQLFreeHandle(SQL_HANDLE_ENV, env);
+
+  return status;
+}
@@ -0,0 +1,184 @@
+/*
+ * Copyright <2021> Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#include "performance_odbc_helper.h"
+
+// Driver-specific connection attributes, see odbc_constants.h in the driver.
+#ifndef SQL_DRIVER_CONN_ATTR_BASE
+#define SQL_DRIVER_CONN_ATTR_BASE 0x00004000
+#endif
+#define SQL_ATTR_DOCUMENTDB_REPLY_BYTES (SQL_DRIVER_CONN_ATTR_BASE + 4)
+#define SQL_ATTR_DOCUMENTDB_MESSAGES_RECEIVED (SQL_DRIVER_CONN_ATTR_BASE + 5)
+
+namespace {
+const std::string kDefaultConnectionString =
+    "DRIVER={Amazon DocumentDB};HOSTNAME=localhost:27017;DATABASE=odbc-test;"
+    "TLS=false;";
+const std::string kDefaultQuery = "SELECT * FROM performance.employer";
+const int kDefaultLoopCount = 10;
+const char* kCompressors[] = {"", "snappy", "zlib", "zstd"};
+
+struct BenchmarkResult {
+  bool success = false;
+  long long rows = 0;
+  long long milliseconds = 0;
+  SQLULEN replyBytes = 0;
+  SQLULEN messagesReceived = 0;
+};
+
+SQLULEN GetCounter(SQLHDBC conn, SQLINTEGER attribute) {
+  SQLULEN value = 0;
+  SQLRETURN ret = SQLGetConnectAttr(conn, attribute, &value, sizeof(value),
+                                    nullptr);
+  if (!SQL_SUCCEEDED(ret)) {
+    LogAnyDiagnostics(SQL_HANDLE_DBC, conn, ret);
+  }
+  return value;
+}
+
+/**
+ * Connect with the given compressor and fetch all rows of the query the given
+ * number of times.
+ */
+BenchmarkResult RunBenchmark(SQLHENV env, const std::string& connectionString,
+                             const std::string& compressor,
+                             const std::string& query, int loopCount) {
+  BenchmarkResult result;
+  SQLHDBC conn = SQL_NULL_HDBC;
+  SQLHSTMT hstmt = SQL_NULL_HSTMT;
+
+  test_string connStr = to_test_string(connectionString + ";COMPRESSORS="
+                                       + compressor + ";");
+  test_string queryStr = to_test_string(query);
+
+  SQLRETURN ret = SQLAllocHandle(SQL_HANDLE_DBC, env, &conn);
+  if (!SQL_SUCCEEDED(ret)) {
+    return result;
+  }
+
+  SQLTCHAR outConnString[1024];
+  SQLSMALLINT outConnStringLength;
+  ret = SQLDriverConnect(conn, nullptr, AS_SQLTCHAR(connStr.c_str()), SQL_NTS,
+                         outConnString, IT_SIZEOF(outConnString),
+                         &outConnStringLength, SQL_DRIVER_NOPROMPT);
+  if (!SQL_SUCCEEDED(ret)) {
+    LogAnyDiagnostics(SQL_HANDLE_DBC, conn, ret);
+    SQLFreeHandle(SQL_HANDLE_DBC, conn);
+    return result;
+  }
+
+  SQLULEN bytesBefore = GetCounter(conn, SQL_ATTR_DOCUMENTDB_REPLY_BYTES);
+  SQLULEN messagesBefore =
+      GetCounter(conn, SQL_ATTR_DOCUMENTDB_MESSAGES_RECEIVED);
+
+  ret = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+  result.success = SQL_SUCCEEDED(ret);
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; result.success && i < loopCount; i++) {
+    ret = SQLExecDirect(hstmt, AS_SQLTCHAR(queryStr.c_str()), SQL_NTS);
+    if (!SQL_SUCCEEDED(ret)) {
+      LogAnyDiagnostics(SQL_HANDLE_STMT, hstmt, ret);
+      result.success = false;
+      break;
+    }
+    while (SQL_SUCCEEDED(ret = SQLFetch(hstmt))) {
+      result.rows++;
+    }
+    if (ret != SQL_NO_DATA) {
+      LogAnyDiagnostics(SQL_HANDLE_STMT, hstmt, ret);
+      result.success = false;
+    }
+    SQLCloseCursor(hstmt);
+  }
+  auto end = std::chrono::steady_clock::now();
+  result.milliseconds =
+      std::chrono::duration_cast< std::chrono::milliseconds >(end - start)
+          .count();
+
+  result.replyBytes =
+      GetCounter(conn, SQL_ATTR_DOCUMENTDB_REPLY_BYTES) - bytesBefore;
+  result.messagesReceived =
+      GetCounter(conn, SQL_ATTR_DOCUMENTDB_MESSAGES_RECEIVED) - messagesBefore;
+
+  if (SQL_NULL_HSTMT != hstmt) {
+    SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+  }
+  SQLDisconnect(conn);
+  SQLFreeHandle(SQL_HANDLE_DBC, conn);
+
+  return result;
+}
+}  // namespace
+
+/******************************************
+ * Main
+ *
+ * Fetches the result of a query with each COMPRESSORS setting, and reports
+ * the fetch throughput. The reply bytes are counted after decompression, so
+ * they are the same for every setting and do not show the wire savings.
+ *
+ * - argv[1] string = connection string, without COMPRESSORS
+ * - argv[2] string = query
+ * - argv[3] integer = number of times the query is run per compressor
+ *****************************************/
+
+int main(int argc, char* argv[]) {
+  std::string connectionString =
+      argc > 1 ? argv[1] : kDefaultConnectionString;
+  std::string query = argc > 2 ? argv[2] : kDefaultQuery;
+  int loopCount = argc > 3 ? std::atoi(argv[3]) : kDefaultLoopCount;
+  if (loopCount <= 0) {
+    std::cerr << "ERROR: invalid number of iterations\n";
+    return EXIT_FAILURE;
+  }
+
+  SQLHENV env = SQL_NULL_HENV;
+  if (!SQL_SUCCEEDED(SQLAllocHandle(SQL_HANDLE_ENV, SQL_NULL_HANDLE, &env))) {
+    std::cerr << "ERROR: unable to allocate the environment\n";
+    return EXIT_FAILURE;
+  }
+  SQLSetEnvAttr(env, SQL_ATTR_ODBC_VERSION, (void*)SQL_OV_ODBC3, 0);
+
+  int status = EXIT_SUCCESS;
+  printf("%-10s %10s %10s %12s %14s %10s\n", "compressor", "rows", "ms",
+         "rows/s", "reply-bytes", "replies");
+  for (const char* compressor : kCompressors) {
+    BenchmarkResult result =
+        RunBenchmark(env, connectionString, compressor, query, loopCount);
+    const char* name = *compressor ? compressor : "none";
+    if (!result.success) {
+      printf("%-10s FAILED\n", name);
+      status = EXIT_FAILURE;
+      continue;
+    }
+    double rowsPerSecond =
+        result.milliseconds > 0 ? result.rows * 1000.0 / result.milliseconds
+                                : 0.0;
+    printf("%-10s %10lld %10lld %12.0f %14llu %10llu\n", name, result.rows,
+           result.milliseconds, rowsPerSecond,
+           static_cast< unsigned long long >(result.replyBytes),
+           static_cast< unsigned long long >(result.messagesReceived));
+  }
+
+  SQLFreeHandle(SQL_HANDLE_ENV, env);
+
+  return status;
+}
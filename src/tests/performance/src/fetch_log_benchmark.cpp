@@ -0,0 +1,208 @@
+/*
+ * Copyright <2021> Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+#include "performance_odbc_helper.h"
+
+namespace {
+const std::string kDefaultConnectionString =
+    "DRIVER={Amazon DocumentDB};HOSTNAME=localhost:27017;DATABASE=odbc-test;"
+    "TLS=false;";
+const std::string kDefaultQuery = "SELECT * FROM performance.employer";
+const int kDefaultLoopCount = 10;
+const char* kLogLevels[] = {"off", "error", "info", "debug"};
+const long long kCheckIterations = 100000000;
+
+/**
+ * Model of the logger as seen by the log macros. The disabled-level check is
+ * measured both the way the macros used to do it (copy the shared singleton
+ * and read the level through it) and the way they do it now (a relaxed load
+ * of an atomic level).
+ */
+struct ModelLogger {
+  int level = 2;
+  std::ostream* stream = nullptr;
+};
+
+std::shared_ptr< ModelLogger > modelInstance =
+    std::make_shared< ModelLogger >();
+std::atomic< int > modelLevel(2);
+
+// Prevents the compiler from removing the measured loops.
+volatile long long sink = 0;
+
+double MeasureSharedPointerCheck() {
+  long long enabled = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (long long i = 0; i < kCheckIterations; i++) {
+    std::shared_ptr< ModelLogger > p = modelInstance;
+    if (p->level <= 0 && p->stream != nullptr) {
+      enabled++;
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+  sink = enabled;
+  return std::chrono::duration< double, std::nano >(end - start).count()
+         / kCheckIterations;
+}
+
+double MeasureAtomicCheck() {
+  long long enabled = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (long long i = 0; i < kCheckIterations; i++) {
+    if (0 >= modelLevel.load(std::memory_order_relaxed)) {
+      enabled++;
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+  sink = enabled;
+  return std::chrono::duration< double, std::nano >(end - start).count()
+         / kCheckIterations;
+}
+
+struct FetchResult {
+  bool success = false;
+  long long rows = 0;
+  long long nanoseconds = 0;
+};
+
+/**
+ * Connect with the given log level and time fetching all rows of the query
+ * the given number of times. Only SQLFetch calls are timed.
+ */
+FetchResult RunFetch(SQLHENV env, const std::string& connectionString,
+                     const std::string& logLevel, const std::string& query,
+                     int loopCount) {
+  FetchResult result;
+  SQLHDBC conn = SQL_NULL_HDBC;
+  SQLHSTMT hstmt = SQL_NULL_HSTMT;
+
+  test_string connStr =
+      to_test_string(connectionString + ";LOG_LEVEL=" + logLevel + ";");
+  test_string queryStr = to_test_string(query);
+
+  SQLRETURN ret = SQLAllocHandle(SQL_HANDLE_DBC, env, &conn);
+  if (!SQL_SUCCEEDED(ret)) {
+    return result;
+  }
+
+  SQLTCHAR outConnString[1024];
+  SQLSMALLINT outConnStringLength;
+  ret = SQLDriverConnect(conn, nullptr, AS_SQLTCHAR(connStr.c_str()), SQL_NTS,
+                         outConnString, IT_SIZEOF(outConnString),
+                         &outConnStringLength, SQL_DRIVER_NOPROMPT);
+  if (!SQL_SUCCEEDED(ret)) {
+    LogAnyDiagnostics(SQL_HANDLE_DBC, conn, ret);
+    SQLFreeHandle(SQL_HANDLE_DBC, conn);
+    return result;
+  }
+
+  ret = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+  result.success = SQL_SUCCEEDED(ret);
+
+  for (int i = 0; result.success && i < loopCount; i++) {
+    ret = SQLExecDirect(hstmt, AS_SQLTCHAR(queryStr.c_str()), SQL_NTS);
+    if (!SQL_SUCCEEDED(ret)) {
+      LogAnyDiagnostics(SQL_HANDLE_STMT, hstmt, ret);
+      result.success = false;
+      break;
+    }
+    auto start = std::chrono::steady_clock::now();
+    while (SQL_SUCCEEDED(ret = SQLFetch(hstmt))) {
+      result.rows++;
+    }
+    auto end = std::chrono::steady_clock::now();
+    result.nanoseconds +=
+        std::chrono::duration_cast< std::chrono::nanoseconds >(end - start)
+            .count();
+    if (ret != SQL_NO_DATA) {
+      LogAnyDiagnostics(SQL_HANDLE_STMT, hstmt, ret);
+      result.success = false;
+    }
+    SQLCloseCursor(hstmt);
+  }
+
+  if (SQL_NULL_HSTMT != hstmt) {
+    SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+  }
+  SQLDisconnect(conn);
+  SQLFreeHandle(SQL_HANDLE_DBC, conn);
+
+  return result;
+}
+}  // namespace
+
+/******************************************
+ * Main
+ *
+ * Measures the cost of disabled log messages in the fetch path. First the
+ * disabled-level check itself is timed with the old and the new check,
+ * then all rows of a query are fetched at each driver log level.
+ *
+ * - argv[1] string = connection string, without LOG_LEVEL
+ * - argv[2] string = query
+ * - argv[3] integer = number of times the query is fetched per log level
+ *****************************************/
+
+int main(int argc, char* argv[]) {
+  std::string connectionString =
+      argc > 1 ? argv[1] : kDefaultConnectionString;
+  std::string query = argc > 2 ? argv[2] : kDefaultQuery;
+  int loopCount = argc > 3 ? std::atoi(argv[3]) : kDefaultLoopCount;
+  if (loopCount <= 0) {
+    std::cerr << "ERROR: invalid number of iterations\n";
+    return EXIT_FAILURE;
+  }
+
+  printf("%-24s %10s\n", "disabled check", "ns/check");
+  printf("%-24s %10.2f\n", "shared_ptr (before)", MeasureSharedPointerCheck());
+  printf("%-24s %10.2f\n", "relaxed atomic (after)", MeasureAtomicCheck());
+  printf("\n");
+
+  SQLHENV env = SQL_NULL_HENV;
+  if (!SQL_SUCCEEDED(SQLAllocHandle(SQL_HANDLE_ENV, SQL_NULL_HANDLE, &env))) {
+    std::cerr << "ERROR: unable to allocate the environment\n";
+    return EXIT_FAILURE;
+  }
+  SQLSetEnvAttr(env, SQL_ATTR_ODBC_VERSION, (void*)SQL_OV_ODBC3, 0);
+
+  int status = EXIT_SUCCESS;
+  printf("%-10s %10s %12s %10s\n", "log level", "rows", "fetch ms", "ns/row");
+  for (const char* logLevel : kLogLevels) {
+    FetchResult result =
+        RunFetch(env, connectionString, logLevel, query, loopCount);
+    if (!result.success) {
+      printf("%-10s FAILED\n", logLevel);
+      status = EXIT_FAILURE;
+      continue;
+    }
+    double nanosecondsPerRow =
+        result.rows > 0
+            ? static_cast< double >(result.nanoseconds) / result.rows
+            : 0.0;
+    printf("%-10s %10lld %12.1f %10.0f\n", logLevel, result.rows,
+           result.nanoseconds / 1000000.0, nanosecondsPerRow);
+  }
+
+  SQLFreeHandle(SQL_HANDLE_ENV, env);
+
+  return status;
+}
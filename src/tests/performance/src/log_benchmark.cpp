@@ -0,0 +1,299 @@
+/*
+ * Copyright <2021> Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ */
+
+#include <documentdb/odbc/common/platform_utils.h>
+#include <documentdb/odbc/log.h>
+#include <documentdb/odbc/log_level.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using documentdb::odbc::Logger;
+using documentdb::odbc::LogLevel;
+
+namespace {
+const std::string kDefaultLogDirectory = ".";
+const int kDefaultMessagesPerThread = 2000;
+const int kDefaultMaxThreads = 64;
+const LogLevel::Type kMessageLevels[] = {LogLevel::Type::DEBUG_LEVEL,
+                                         LogLevel::Type::INFO_LEVEL,
+                                         LogLevel::Type::ERROR_LEVEL};
+
+// Makes the records about as long as the driver's own messages.
+const std::string kPayload(64, 'x');
+
+// Ends every message, so that a truncated or interleaved line is detected.
+const char kEndMarker = '|';
+
+struct RunResult {
+  long long calls = 0;
+  long long nanoseconds = 0;
+  long long p50 = 0;
+  long long p99 = 0;
+  long long p999 = 0;
+  long long lines = 0;
+  long long malformed = 0;
+  long long missing = 0;
+};
+
+/**
+ * Write messages with the log macro of the given level, timing each call.
+ */
+void WriteMessages(LogLevel::Type level, int run, int thread, int count,
+                   std::vector< long long >& latencies) {
+  for (int i = 0; i < count; i++) {
+    auto start = std::chrono::steady_clock::now();
+    switch (level) {
+      case LogLevel::Type::DEBUG_LEVEL:
+        LOG_DEBUG_MSG("bench r=" << run << " t=" << thread << " i=" << i
+                                 << " " << kPayload << kEndMarker);
+        break;
+      case LogLevel::Type::INFO_LEVEL:
+        LOG_INFO_MSG("bench r=" << run << " t=" << thread << " i=" << i
+                                << " " << kPayload << kEndMarker);
+        break;
+      default:
+        LOG_ERROR_MSG("bench r=" << run << " t=" << thread << " i=" << i
+                                 << " " << kPayload << kEndMarker);
+        break;
+    }
+    auto end = std::chrono::steady_clock::now();
+    latencies.push_back(
+        std::chrono::duration_cast< std::chrono::nanoseconds >(end - start)
+            .count());
+  }
+}
+
+long long Percentile(const std::vector< long long >& sorted, double p) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  size_t index = static_cast< size_t >(p * sorted.size());
+  return sorted[std::min(index, sorted.size() - 1)];
+}
+
+/**
+ * Get the path of the driver log file, see Logger::CreateFileName.
+ */
+std::string GetLogFilePath(const std::string& logDirectory) {
+  char date[16];
+  time_t curTime = time(nullptr);
+  strftime(date, sizeof(date), "%Y%m%d", localtime(&curTime));
+  std::stringstream path;
+  path << logDirectory << documentdb::odbc::common::Fs << "docdb_odbc_"
+       << date << ".log";
+  return path.str();
+}
+
+std::streamoff GetFileSize(const std::string& path) {
+  std::ifstream file(path.c_str(), std::ios_base::binary | std::ios_base::ate);
+  return file ? static_cast< std::streamoff >(file.tellg()) : 0;
+}
+
+/**
+ * Check the lines written to the log file from the given offset: every
+ * message of the run must be on its own line, exactly once, and end with
+ * the end marker.
+ */
+void CheckLogFile(const std::string& path, std::streamoff offset, int run,
+                  int threads, int messagesPerThread, bool json,
+                  RunResult& result) {
+  std::ifstream file(path.c_str(), std::ios_base::binary);
+  file.seekg(offset);
+
+  std::string suffix = kPayload + kEndMarker + (json ? "\"}" : "");
+  std::string marker = "bench r=" + std::to_string(run) + " ";
+  std::set< std::pair< int, int > > seen;
+  std::string line;
+  while (std::getline(file, line)) {
+    result.lines++;
+    size_t pos = line.find(marker);
+    int thread = -1;
+    int index = -1;
+    char space = 0;
+    if (pos == std::string::npos
+        || sscanf(line.c_str() + pos + marker.size(), "t=%d i=%d%c", &thread,
+                  &index, &space)
+               != 3
+        || space != ' ' || line.size() < suffix.size()
+        || line.compare(line.size() - suffix.size(), suffix.size(), suffix)
+               != 0
+        || thread < 0 || thread >= threads || index < 0
+        || index >= messagesPerThread
+        || !seen.insert(std::make_pair(thread, index)).second) {
+      result.malformed++;
+    }
+  }
+  result.missing = static_cast< long long >(threads) * messagesPerThread
+                   - static_cast< long long >(seen.size());
+}
+
+/**
+ * Write messages of the given level from the given number of threads, and
+ * check the log file when logging is enabled.
+ */
+RunResult Run(Logger* logger, const std::string& logFilePath,
+              LogLevel::Type level, bool enabled, int run, int threads,
+              int messagesPerThread, bool json) {
+  logger->SetLogLevel(enabled ? level : LogLevel::Type::OFF);
+  std::streamoff offset = GetFileSize(logFilePath);
+
+  std::vector< std::vector< long long > > latencies(threads);
+  std::vector< std::thread > workers;
+  std::atomic< int > ready(0);
+  std::atomic< bool > go(false);
+  for (int t = 0; t < threads; t++) {
+    latencies[t].reserve(messagesPerThread);
+    workers.emplace_back([&, t]() {
+      ready++;
+      while (!go) {
+        std::this_thread::yield();
+      }
+      WriteMessages(level, run, t, messagesPerThread, latencies[t]);
+    });
+  }
+  while (ready < threads) {
+    std::this_thread::yield();
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  go = true;
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  logger->Flush();
+  auto end = std::chrono::steady_clock::now();
+
+  RunResult result;
+  std::vector< long long > all;
+  all.reserve(static_cast< size_t >(threads) * messagesPerThread);
+  for (const std::vector< long long >& threadLatencies : latencies) {
+    all.insert(all.end(), threadLatencies.begin(), threadLatencies.end());
+  }
+  std::sort(all.begin(), all.end());
+  result.calls = static_cast< long long >(all.size());
+  result.nanoseconds =
+      std::chrono::duration_cast< std::chrono::nanoseconds >(end - start)
+          .count();
+  result.p50 = Percentile(all, 0.5);
+  result.p99 = Percentile(all, 0.99);
+  result.p999 = Percentile(all, 0.999);
+
+  if (enabled) {
+    CheckLogFile(logFilePath, offset, run, threads, messagesPerThread, json,
+                 result);
+  } else {
+    // Nothing may be written below the log level.
+    result.malformed = GetFileSize(logFilePath) != offset ? 1 : 0;
+  }
+
+  return result;
+}
+}  // namespace
+
+/******************************************
+ * Main
+ *
+ * Measures the driver log macros under multi-threaded load. For each message
+ * level (debug, info and error), messages are written from 1 to max-threads
+ * threads, doubling the count, with the logger at that level (enabled) and
+ * off (disabled). The throughput and the latency percentiles of the calls
+ * are reported, and the log file is checked to hold every message exactly
+ * once, each on its own complete line.
+ *
+ * - argv[1] string = log directory, must exist
+ * - argv[2] integer = number of messages per thread
+ * - argv[3] integer = maximum number of threads
+ * - argv[4] string = LOG_ASYNC, true or false
+ * - argv[5] string = LOG_FORMAT, text or json
+ *****************************************/
+
+int main(int argc, char* argv[]) {
+  std::string logDirectory = argc > 1 ? argv[1] : kDefaultLogDirectory;
+  int messagesPerThread =
+      argc > 2 ? std::atoi(argv[2]) : kDefaultMessagesPerThread;
+  int maxThreads = argc > 3 ? std::atoi(argv[3]) : kDefaultMaxThreads;
+  bool async = argc > 4 && std::string(argv[4]) == "true";
+  bool json = argc > 5 && std::string(argv[5]) == "json";
+  if (messagesPerThread <= 0 || maxThreads <= 0) {
+    std::cerr << "ERROR: invalid number of messages or threads\n";
+    return EXIT_FAILURE;
+  }
+  if (!documentdb::odbc::common::IsValidDirectory(logDirectory)) {
+    std::cerr << "ERROR: invalid log directory\n";
+    return EXIT_FAILURE;
+  }
+
+  Logger* logger = Logger::GetRawLoggerInstance();
+  logger->SetLogPath(logDirectory);
+  logger->SetAsync(async);
+  logger->SetJsonFormat(json);
+  std::string logFilePath = GetLogFilePath(logDirectory);
+
+  printf("log file %s, async %s, format %s\n", logFilePath.c_str(),
+         async ? "true" : "false", json ? "json" : "text");
+  printf("%-6s %-9s %7s %9s %10s %12s %8s %8s %8s %9s %s\n", "level",
+         "logging", "threads", "calls", "ms", "calls/s", "p50 ns", "p99 ns",
+         "p999 ns", "lines", "check");
+
+  int status = EXIT_SUCCESS;
+  int run = 0;
+  for (LogLevel::Type level : kMessageLevels) {
+    for (bool enabled : {false, true}) {
+      for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        RunResult result = Run(logger, logFilePath, level, enabled, ++run,
+                               threads, messagesPerThread, json);
+        bool passed =
+            result.malformed == 0 && (!enabled || result.missing == 0);
+        if (!passed) {
+          status = EXIT_FAILURE;
+        }
+        double callsPerSecond =
+            result.nanoseconds > 0
+                ? result.calls * 1e9 / result.nanoseconds
+                : 0.0;
+        printf("%-6s %-9s %7d %9lld %10.1f %12.0f %8lld %8lld %8lld %9lld %s",
+               LogLevel::ToString(level).c_str(),
+               enabled ? "enabled" : "disabled", threads, result.calls,
+               result.nanoseconds / 1000000.0, callsPerSecond, result.p50,
+               result.p99, result.p999, result.lines, passed ? "ok" : "FAILED");
+        if (!passed) {
+          printf(" (%lld malformed, %lld missing)", result.malformed,
+                 enabled ? result.missing : 0);
+        }
+        printf("\n");
+      }
+    }
+  }
+
+  logger->SetAsync(false);
+  logger->SetLogLevel(LogLevel::Type::OFF);
+
+  return status;
+}
@@ -0,0 +1,19 @@
+#!/bin/bash
+# Run a bpftrace script of this directory against the driver library.
+#
+# Usage: trace.sh <script.bt> <path to libdocumentdb-odbc.so> [bpftrace args]
+# e.g.   sudo ./trace.sh lifecycle.bt ../../../build/odbc/lib/libdocumentdb-odbc.so
+#
+# The driver must be built with -DWITH_USDT=ON. Stop with Ctrl-C to print the
+# histograms.
+
+if [ $# -lt 2 ]; then
+    echo "Usage: $0 <script.bt> <path to libdocumentdb-odbc.so> [bpftrace args]"
+    exit 1
+fi
+
+SCRIPT="$1"
+DRIVER="$(realpath "$2")"
+shift 2
+
+exec bpftrace "$@" -e "$(sed "s|@DRIVER@|$DRIVER|g" "$SCRIPT")"